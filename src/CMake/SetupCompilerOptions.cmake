@@ -57,3 +57,8 @@ include(CMake/SetupCuda.cmake)
 # OpenMP Support
 ################################
 include(CMake/SetupOpenMP.cmake)
+
+################################
+# C++11 and Thread Support
+################################
+include(CMake/SetupThreads.cmake)
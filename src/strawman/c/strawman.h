@@ -88,6 +88,8 @@ void strawman_publish(Strawman *sman, conduit_node *data);
 
 void strawman_execute(Strawman *sman, conduit_node *actions);
 
+void strawman_info(Strawman *sman, conduit_node *out);
+
 void strawman_close(Strawman *sman);
 
 
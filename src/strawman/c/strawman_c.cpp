@@ -124,6 +124,16 @@ strawman_execute(Strawman *c_sman,
     v->Execute(*n);
 }
 
+//---------------------------------------------------------------------------//
+void
+strawman_info(Strawman *c_sman,
+              conduit_node *c_out)
+{
+    strawman::Strawman *v = cpp_strawman(c_sman);
+    Node  *n = static_cast<Node*>(c_out);
+    v->Info(*n);
+}
+
 //---------------------------------------------------------------------------//
 void
 strawman_close(Strawman *c_sman)
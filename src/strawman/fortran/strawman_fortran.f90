@@ -108,6 +108,15 @@ module strawman
         type(C_PTR), value, intent(IN) ::csman
         type(C_PTR), value, intent(IN) ::cnode
     end subroutine strawman_execute
+
+    !--------------------------------------------------------------------------
+    subroutine strawman_info(csman, cnode) &
+            bind(C, name="strawman_info")
+        use iso_c_binding
+        implicit none
+        type(C_PTR), value, intent(IN) ::csman
+        type(C_PTR), value, intent(IN) ::cnode
+    end subroutine strawman_info
  
     !--------------------------------------------------------------------------
     subroutine strawman_close(csman) &
@@ -51,12 +51,24 @@
 
 #include "strawman_blueprint_hdf5_pipeline.hpp"
 #include <strawman_file_system.hpp>
+#include <strawman_fingerprint.hpp>
+#include <strawman_compression.hpp>
+#include <strawman_file_stager.hpp>
+#include <strawman_blueprint_extract.hpp>
+#include <strawman_block_timer.hpp>
 
 // standard lib includes
 #include <iostream>
 #include <string.h>
 #include <limits.h>
 #include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
 
 //-----------------------------------------------------------------------------
 // thirdparty includes
@@ -66,6 +78,9 @@
 #include <conduit_relay.hpp>
 #include <conduit_blueprint.hpp>
 
+// hdf5 includes
+#include <hdf5.h>
+
 // mpi related includes
 #ifdef PARALLEL
 #include <mpi.h>
@@ -78,75 +93,1406 @@
 using namespace conduit;
 using namespace conduit::relay;
 
-using namespace std;
+using namespace std;
+
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+// Internal Class that coordinates writing.
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+class BlueprintHDF5Pipeline::IOManager
+{
+public:
+
+    // construction and destruction 
+#ifdef PARALLEL
+     IOManager(MPI_Comm mpi_comm);
+#else
+     IOManager();
+#endif
+    ~IOManager();
+
+    // configures async writes from the Strawman::Open options
+    void SetOptions(const Node &options);
+
+    // main call to create hdf5 file set
+    void SaveToHDF5FileSet(const Node &data, const Node &options);
+
+    // waits for outstanding async writes and staged files, returns the
+    // error of a failed write that was not reported yet (if any)
+    std::string Finish();
+
+//-----------------------------------------------------------------------------
+// private methods
+//-----------------------------------------------------------------------------
+private:
+    // number of consecutive ranks whose domains share one file
+    int  RanksPerFile(const Node &options);
+
+    // rank 0 creates the directory, all ranks check the result
+    void CreateOutputDirectory(const std::string &output_dir);
+
+    // name of the file that holds this rank's domain
+    std::string DomainFileName(uint64 domain, int ranks_per_file);
+
+    // writes the domain trees and their extras (see write_extras) to
+    // files in output_dir. if link_dir is not empty, coordsets and
+    // topologies are links into the file set in link_dir instead of data.
+    void WriteFileSet(const Node &data,
+                      const Node &extras,
+                      const std::string &output_dir,
+                      int ranks_per_file,
+                      const std::string &link_dir);
+
+#ifdef PARALLEL
+    // sends domains to the first rank of each block, which writes them
+    // as groups of a single file
+    void SaveAggregated(const Node &data,
+                        const Node &extras,
+                        const std::string &output_file,
+                        int ranks_per_file,
+                        const std::string &link_file);
+#endif
+
+    // writes a tree and its extras to disk, or stages them for the writer
+    // thread when async saves are enabled
+    void WriteFile(const Node &data,
+                   const std::string &output_file,
+                   const Node &extras);
+
+    // writer thread main loop
+    void WriteLoop();
+
+    // a staged tree waiting for the writer thread
+    struct WriteRequest
+    {
+        int         m_slot;
+        std::string m_output_file;
+    };
+
+//-----------------------------------------------------------------------------
+// private vars
+//-----------------------------------------------------------------------------
+    int m_rank;
+
+//-----------------------------------------------------------------------------
+// private vars for MPI case
+//-----------------------------------------------------------------------------
+#ifdef PARALLEL
+    MPI_Comm            m_mpi_comm;
+    int                 m_mpi_size;
+#endif 
+
+//-----------------------------------------------------------------------------
+// private vars for async writes
+//-----------------------------------------------------------------------------
+    bool                     m_async;
+    // staging buffers, reused across cycles, one per outstanding dump
+    std::vector<Node>        m_slots;
+    std::vector<int>         m_free_slots;
+    std::deque<WriteRequest> m_queue;
+    std::string              m_write_error;
+
+    std::thread              m_writer;
+    std::mutex               m_mutex;
+    std::condition_variable  m_cond;
+    bool                     m_shutdown;
+    // hdf5 is not guaranteed to be thread safe, serializes all file access
+    std::mutex               m_hdf5_mutex;
+
+    // optional staging tier for domain files
+    FileStager               m_stager;
+
+//-----------------------------------------------------------------------------
+// private vars for static mesh output
+//-----------------------------------------------------------------------------
+    std::string              m_mesh_dir;
+    std::string              m_mesh_output_path;
+    int                      m_mesh_ranks_per_file;
+    uint64                   m_mesh_fingerprint;
+
+//-----------------------------------------------------------------------------
+// private vars for the cached root file (rank 0 only)
+//-----------------------------------------------------------------------------
+    Node                     m_root;
+    uint64                   m_root_key;
+    int                      m_root_num_domains;
+    int                      m_root_ranks_per_file;
+};
+
+//-----------------------------------------------------------------------------
+static void
+hash_string_leaves(const Node &node, uint64 &key)
+{
+    if(node.dtype().is_object() || node.dtype().is_list())
+    {
+        for(index_t i = 0; i < node.number_of_children(); i++)
+        {
+            hash_string_leaves(node.child(i), key);
+        }
+    }
+    else if(node.dtype().is_char8_str())
+    {
+        key = (key * 1099511628211ULL) ^ data_fingerprint(node);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Key for the cached blueprint index. The index only depends on the tree
+// structure and on string values such as coordset and topology types, so
+// numeric arrays are not hashed.
+//-----------------------------------------------------------------------------
+static uint64
+index_fingerprint(const Node &data)
+{
+    uint64 key = schema_fingerprint(data);
+    hash_string_leaves(data, key);
+    return key;
+}
+
+//-----------------------------------------------------------------------------
+// Parts of a file that conduit relay can not write are passed around as an
+// "extras" node, which write_extras adds after relay has written the tree:
+//
+//   links    : list of hdf5 external links
+//              (name, file, path)
+//   datasets : list of chunked and/or compressed datasets
+//              (path, values, shuffle, level, optional dims and
+//               chunk_dims, optional raw_bytes, extra_bytes and
+//               ratio_path for compressed data)
+//
+// Paths are relative to a domain tree until the file is assembled.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+static std::string
+join_tree_path(const std::string &tree_path,
+               const std::string &path)
+{
+    if(tree_path.empty())
+    {
+        return path;
+    }
+    // an empty path (e.g. the component name of a scalar field) refers
+    // to tree_path itself
+    if(path.empty())
+    {
+        return tree_path;
+    }
+    return tree_path + "/" + path;
+}
+
+//-----------------------------------------------------------------------------
+// Adds links to the coordsets and topologies of the tree at tree_path in the
+// mesh file link_file.
+//-----------------------------------------------------------------------------
+static void
+add_mesh_links(const std::string &link_file,
+               const std::string &tree_path,
+               Node &extras)
+{
+    const char *mesh_paths[] = {"coordsets", "topologies"};
+
+    for(int i = 0; i < 2; i++)
+    {
+        std::string path = join_tree_path(tree_path,mesh_paths[i]);
+
+        Node &link = extras["links"].append();
+        link["name"] = path;
+        link["file"] = link_file;
+        link["path"] = "/" + path;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Adds the extras of a domain tree to the extras of the file that holds the
+// tree at tree_path.
+//-----------------------------------------------------------------------------
+static void
+append_extras(const Node &domain_extras,
+              const std::string &tree_path,
+              Node &file_extras)
+{
+    if(!domain_extras.has_child("datasets"))
+    {
+        return;
+    }
+
+    NodeConstIterator itr = domain_extras["datasets"].children();
+    while(itr.has_next())
+    {
+        const Node &src = itr.next();
+        Node &dest = file_extras["datasets"].append();
+
+        NodeConstIterator ds_itr = src.children();
+        while(ds_itr.has_next())
+        {
+            const Node &child = ds_itr.next();
+            std::string name = ds_itr.name();
+            if(name == "path" || name == "ratio_path")
+            {
+                dest[name] = join_tree_path(tree_path,child.as_string());
+            }
+            else
+            {
+                dest[name].set_external(child);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Returns the logical dims (i fastest) of a field on a uniform, rectilinear
+// or structured topology, or no dims for other topologies.
+//-----------------------------------------------------------------------------
+static std::vector<index_t>
+logical_field_dims(const Node &data, const Node &field)
+{
+    std::vector<index_t> dims;
+
+    if(!field.has_child("topology") ||
+       !data.has_child("topologies") ||
+       !data["topologies"].has_child(field["topology"].as_string()))
+    {
+        return dims;
+    }
+
+    const Node &topo   = data["topologies"][field["topology"].as_string()];
+    const Node &coords = data["coordsets"][topo["coordset"].as_string()];
+    std::string topo_type = topo["type"].as_string();
+
+    const char *ijk_axes[] = {"i", "j", "k"};
+    const char *xyz_axes[] = {"x", "y", "z"};
+
+    for(int a = 0; a < 3; a++)
+    {
+        if(topo_type == "uniform" && 
+           coords.has_path(std::string("dims/") + ijk_axes[a]))
+        {
+            dims.push_back(coords["dims"][ijk_axes[a]].to_int64());
+        }
+        else if(topo_type == "rectilinear" &&
+                coords.has_path(std::string("values/") + xyz_axes[a]))
+        {
+            dims.push_back(coords["values"][xyz_axes[a]].dtype().number_of_elements());
+        }
+        else if(topo_type == "structured" &&
+                topo.has_path(std::string("elements/dims/") + ijk_axes[a]))
+        {
+            dims.push_back(topo["elements/dims"][ijk_axes[a]].to_int64() + 1);
+        }
+    }
+
+    if(field.has_child("association") &&
+       field["association"].as_string() == "element")
+    {
+        for(size_t a = 0; a < dims.size(); a++)
+        {
+            dims[a] = std::max(dims[a] - 1, (index_t) 1);
+        }
+    }
+
+    return dims;
+}
+
+//-----------------------------------------------------------------------------
+// Computes the min and max of each chunk of a field component. dims and
+// chunk_dims are i fastest, and chunks are numbered i fastest.
+//-----------------------------------------------------------------------------
+static void
+chunk_min_max(const Node &values,
+              const std::vector<index_t> &dims,
+              const std::vector<index_t> &chunk_dims,
+              Node &res)
+{
+    Node n_f64;
+    values.to_float64_array(n_f64);
+    const float64 *vals = n_f64.as_float64_ptr();
+
+    index_t d[3]  = {1, 1, 1};
+    index_t c[3]  = {1, 1, 1};
+    index_t nc[3] = {1, 1, 1};
+
+    for(size_t a = 0; a < dims.size(); a++)
+    {
+        d[a]  = dims[a];
+        c[a]  = chunk_dims[a];
+        nc[a] = (d[a] + c[a] - 1) / c[a];
+    }
+
+    index_t num_chunks = nc[0] * nc[1] * nc[2];
+
+    res["chunk_dims"].set(DataType::int64(dims.size()));
+    res["num_chunks"].set(DataType::int64(dims.size()));
+    int64 *res_chunk_dims = res["chunk_dims"].value();
+    int64 *res_num_chunks = res["num_chunks"].value();
+    for(size_t a = 0; a < dims.size(); a++)
+    {
+        res_chunk_dims[a] = c[a];
+        res_num_chunks[a] = nc[a];
+    }
+
+    res["min"].set(DataType::float64(num_chunks));
+    res["max"].set(DataType::float64(num_chunks));
+    float64 *cmin = res["min"].value();
+    float64 *cmax = res["max"].value();
+
+    for(index_t i = 0; i < num_chunks; i++)
+    {
+        cmin[i] =  std::numeric_limits<float64>::max();
+        cmax[i] = -std::numeric_limits<float64>::max();
+    }
+
+    index_t idx = 0;
+    for(index_t k = 0; k < d[2]; k++)
+    {
+        for(index_t j = 0; j < d[1]; j++)
+        {
+            index_t row_chunk = ((k / c[2]) * nc[1] + j / c[1]) * nc[0];
+            for(index_t i = 0; i < d[0]; i++, idx++)
+            {
+                index_t chunk = row_chunk + i / c[0];
+                // NaNs fail both tests and are ignored
+                if(vals[idx] < cmin[chunk])
+                {
+                    cmin[chunk] = vals[idx];
+                }
+                if(vals[idx] > cmax[chunk])
+                {
+                    cmax[chunk] = vals[idx];
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Moves the values of fields that are compressed (see the compression
+// option) or chunked (see the chunking option) to datasets in the extras.
+// out references data, storage holds the encoded arrays, and chunk_index
+// receives the per chunk min and max of each chunked field.
+//-----------------------------------------------------------------------------
+static void
+prepare_fields(const Node &data,
+               const Node &options,
+               Node &out,
+               Node &extras,
+               Node &storage,
+               Node &chunk_index)
+{
+    NodeConstIterator itr = data.children();
+    while(itr.has_next())
+    {
+        const Node &child = itr.next();
+        if(itr.name() != "fields")
+        {
+            out[itr.name()].set_external(child);
+        }
+    }
+
+    // chunk edge lengths in i, j, k
+    std::vector<index_t> chunk_size;
+    if(options.has_path("chunking/size"))
+    {
+        Node n_size;
+        options["chunking/size"].to_int64_array(n_size);
+        int64 *size_vals = n_size.value();
+        index_t num_size = n_size.dtype().number_of_elements();
+        for(index_t a = 0; a < 3; a++)
+        {
+            int64 size = size_vals[std::min(a, num_size - 1)];
+            if(size < 1)
+            {
+                STRAWMAN_ERROR("chunking/size must be at least 1");
+            }
+            chunk_size.push_back(size);
+        }
+    }
+
+    itr = data["fields"].children();
+    while(itr.has_next())
+    {
+        const Node &field = itr.next();
+        std::string field_name = itr.name();
+        Node &out_field = out["fields"][field_name];
+
+        bool compress = options.has_child("compression") &&
+                        options["compression"].has_child(field_name);
+
+        std::vector<index_t> dims;
+        if(!chunk_size.empty())
+        {
+            dims = logical_field_dims(data,field);
+        }
+
+        if(!compress && dims.empty())
+        {
+            out_field.set_external(field);
+            continue;
+        }
+
+        // chunking alone writes the values without filters
+        std::string codec = "";
+        int level   = 0;
+        int shuffle = 0;
+        float64 tolerance = 0.0;
+        bool relative = false;
+
+        if(compress)
+        {
+            const Node &opts = options["compression"][field_name];
+
+            codec   = "deflate";
+            level   = 6;
+            shuffle = 1;
+
+            if(opts.has_child("codec"))
+            {
+                codec = opts["codec"].as_string();
+            }
+
+            if(opts.has_child("level"))
+            {
+                level = opts["level"].to_int();
+            }
+
+            if(opts.has_child("shuffle"))
+            {
+                shuffle = opts["shuffle"].as_string() == "true" ? 1 : 0;
+            }
+
+            if(codec == "quantize")
+            {
+                if(!opts.has_child("tolerance"))
+                {
+                    STRAWMAN_ERROR("compression of field " << field_name 
+                                   << " is missing a tolerance");
+                }
+                tolerance = opts["tolerance"].to_float64();
+                relative  = opts.has_child("mode") &&
+                            opts["mode"].as_string() == "relative";
+            }
+            else if(codec != "deflate")
+            {
+                STRAWMAN_ERROR("unknown compression codec " << codec
+                               << " for field " << field_name);
+            }
+        }
+
+        NodeConstIterator field_itr = field.children();
+        while(field_itr.has_next())
+        {
+            const Node &child = field_itr.next();
+            if(field_itr.name() != "values")
+            {
+                out_field[field_itr.name()].set_external(child);
+            }
+        }
+
+        if(compress)
+        {
+            Node &out_comp = out_field["compression"];
+            out_comp["codec"]   = codec;
+            out_comp["level"]   = level;
+            out_comp["shuffle"] = shuffle == 1 ? "true" : "false";
+            if(codec == "quantize")
+            {
+                out_comp["tolerance"] = tolerance;
+                out_comp["mode"]      = relative ? "relative" : "absolute";
+            }
+        }
+
+        // multi-component fields are handled one component at a time
+        const Node &values = field["values"];
+        std::vector<std::string> comp_names;
+        if(values.dtype().is_object())
+        {
+            comp_names = values.child_names();
+        }
+        else
+        {
+            comp_names.push_back("");
+        }
+
+        std::string field_path = "fields/" + field_name;
+
+        for(size_t i = 0; i < comp_names.size(); i++)
+        {
+            const std::string &comp_name = comp_names[i];
+            const Node &comp_values = comp_name.empty() ? 
+                                        values : values[comp_name];
+            std::string comp_path = join_tree_path(field_path + "/compression",
+                                                   comp_name);
+            
+            Node &ds = extras["datasets"].append();
+            ds["level"]   = level;
+            ds["shuffle"] = shuffle;
+
+            if(compress)
+            {
+                ds["raw_bytes"]   = comp_values.total_bytes_compact();
+                ds["extra_bytes"] = 0;
+                ds["ratio_path"]  = comp_path + "/ratio";
+            }
+
+            index_t num_vals = 1;
+            for(size_t a = 0; a < dims.size(); a++)
+            {
+                num_vals *= dims[a];
+            }
+
+            if(!dims.empty() &&
+               num_vals == comp_values.dtype().number_of_elements())
+            {
+                // hdf5 dims are slowest first, blueprint arrays are i fastest
+                std::vector<index_t> chunk_dims(dims.size());
+                ds["dims"].set(DataType::int64(dims.size()));
+                ds["chunk_dims"].set(DataType::int64(dims.size()));
+                int64 *ds_dims       = ds["dims"].value();
+                int64 *ds_chunk_dims = ds["chunk_dims"].value();
+                
+                for(size_t a = 0; a < dims.size(); a++)
+                {
+                    chunk_dims[a] = std::min(dims[a], chunk_size[a]);
+                    ds_dims[dims.size() - 1 - a]       = dims[a];
+                    ds_chunk_dims[dims.size() - 1 - a] = chunk_dims[a];
+                }
+
+                chunk_min_max(comp_values,
+                              dims,
+                              chunk_dims,
+                              chunk_index[join_tree_path(field_name,comp_name)]);
+            }
+
+            Node &n_store = storage.append();
+
+            if(codec == "quantize")
+            {
+                quantize_encode(comp_values, tolerance, relative, n_store);
+
+                Node &out_comp = out_field["compression"];
+                Node &out_enc  = comp_name.empty() ? out_comp : out_comp[comp_name];
+                NodeIterator enc_itr = n_store.children();
+                while(enc_itr.has_next())
+                {
+                    Node &enc_child = enc_itr.next();
+                    if(enc_itr.name() != "codes")
+                    {
+                        out_enc[enc_itr.name()].set_external(enc_child);
+                    }
+                }
+
+                if(n_store.has_child("outlier_values"))
+                {
+                    ds["extra_bytes"] = n_store["outlier_index"].total_bytes_compact() +
+                                        n_store["outlier_values"].total_bytes_compact();
+                }
+
+                ds["path"] = comp_path + "/codes";
+                ds["values"].set_external(n_store["codes"]);
+            }
+            else
+            {
+                ds["path"] = join_tree_path(field_path + "/values",comp_name);
+                if(comp_values.is_compact())
+                {
+                    ds["values"].set_external(comp_values);
+                }
+                else
+                {
+                    comp_values.compact_to(n_store);
+                    ds["values"].set_external(n_store);
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+static hid_t
+hdf5_native_type(const DataType &dtype)
+{
+    switch(dtype.id())
+    {
+        case DataType::INT8_ID:    return H5T_NATIVE_INT8;
+        case DataType::INT16_ID:   return H5T_NATIVE_INT16;
+        case DataType::INT32_ID:   return H5T_NATIVE_INT32;
+        case DataType::INT64_ID:   return H5T_NATIVE_INT64;
+        case DataType::UINT8_ID:   return H5T_NATIVE_UINT8;
+        case DataType::UINT16_ID:  return H5T_NATIVE_UINT16;
+        case DataType::UINT32_ID:  return H5T_NATIVE_UINT32;
+        case DataType::UINT64_ID:  return H5T_NATIVE_UINT64;
+        case DataType::FLOAT32_ID: return H5T_NATIVE_FLOAT;
+        case DataType::FLOAT64_ID: return H5T_NATIVE_DOUBLE;
+        default:
+            break;
+    }
+
+    STRAWMAN_ERROR("no hdf5 type for dtype " << dtype.name());
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Writes a chunked dataset described by an extras dataset entry, with the
+// shuffle and deflate filters if requested. Without dims the dataset is 1D.
+// Returns the number of bytes hdf5 used to store it, or -1 on failure.
+//-----------------------------------------------------------------------------
+static int64
+write_chunked_dataset(hid_t h5_file_id,
+                      const Node &ds)
+{
+    const Node &values = ds["values"];
+    std::string path   = ds["path"].as_string();
+    int shuffle        = ds["shuffle"].to_int();
+    int level          = ds["level"].to_int();
+
+    hid_t   h5_dtype = hdf5_native_type(values.dtype());
+    hsize_t num_vals = (hsize_t) values.dtype().number_of_elements();
+
+    if(num_vals == 0)
+    {
+        return 0;
+    }
+
+    std::vector<hsize_t> dims;
+    std::vector<hsize_t> chunk_dims;
+
+    if(ds.has_child("dims"))
+    {
+        Node n_dims, n_chunk_dims;
+        ds["dims"].to_int64_array(n_dims);
+        ds["chunk_dims"].to_int64_array(n_chunk_dims);
+        int64 *dims_vals       = n_dims.value();
+        int64 *chunk_dims_vals = n_chunk_dims.value();
+        for(index_t a = 0; a < n_dims.dtype().number_of_elements(); a++)
+        {
+            dims.push_back((hsize_t) dims_vals[a]);
+            chunk_dims.push_back((hsize_t) chunk_dims_vals[a]);
+        }
+    }
+    else
+    {
+        dims.push_back(num_vals);
+        chunk_dims.push_back(std::min(num_vals, (hsize_t) 65536));
+    }
+
+    int rank = (int) dims.size();
+
+    hid_t h5_dcpl_id  = H5Pcreate(H5P_DATASET_CREATE);
+    hid_t h5_lcpl_id  = H5Pcreate(H5P_LINK_CREATE);
+    hid_t h5_space_id = H5Screate_simple(rank, &dims[0], NULL);
+    hid_t h5_dset_id  = -1;
+    int64 storage     = -1;
+
+    // the parent groups of encoded arrays are not in the relay tree
+    H5Pset_create_intermediate_group(h5_lcpl_id, 1);
+
+    bool ok = H5Pset_chunk(h5_dcpl_id, rank, &chunk_dims[0]) >= 0;
+    
+    if(ok && shuffle)
+    {
+        ok = H5Pset_shuffle(h5_dcpl_id) >= 0;
+    }
+
+    if(ok && level > 0)
+    {
+        ok = H5Pset_deflate(h5_dcpl_id, level) >= 0;
+    }
+
+    if(ok)
+    {
+        h5_dset_id = H5Dcreate2(h5_file_id,
+                                path.c_str(),
+                                h5_dtype,
+                                h5_space_id,
+                                h5_lcpl_id,
+                                h5_dcpl_id,
+                                H5P_DEFAULT);
+        ok = h5_dset_id >= 0;
+    }
+
+    if(ok)
+    {
+        ok = H5Dwrite(h5_dset_id,
+                      h5_dtype,
+                      H5S_ALL,
+                      H5S_ALL,
+                      H5P_DEFAULT,
+                      values.element_ptr(0)) >= 0;
+    }
+
+    if(ok)
+    {
+        storage = (int64) H5Dget_storage_size(h5_dset_id);
+    }
+
+    if(h5_dset_id >= 0)
+    {
+        H5Dclose(h5_dset_id);
+    }
+
+    H5Sclose(h5_space_id);
+    H5Pclose(h5_lcpl_id);
+    H5Pclose(h5_dcpl_id);
+
+    return storage;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+write_float64_scalar(hid_t h5_file_id,
+                     const std::string &path,
+                     float64 value)
+{
+    // conduit writes scalars as 1 element arrays
+    hsize_t num_vals = 1;
+    hid_t h5_lcpl_id  = H5Pcreate(H5P_LINK_CREATE);
+    hid_t h5_space_id = H5Screate_simple(1, &num_vals, NULL);
+    H5Pset_create_intermediate_group(h5_lcpl_id, 1);
+
+    hid_t h5_dset_id = H5Dcreate2(h5_file_id,
+                                  path.c_str(),
+                                  H5T_NATIVE_DOUBLE,
+                                  h5_space_id,
+                                  h5_lcpl_id,
+                                  H5P_DEFAULT,
+                                  H5P_DEFAULT);
+    bool ok = h5_dset_id >= 0;
+    if(ok)
+    {
+        ok = H5Dwrite(h5_dset_id,
+                      H5T_NATIVE_DOUBLE,
+                      H5S_ALL,
+                      H5S_ALL,
+                      H5P_DEFAULT,
+                      &value) >= 0;
+        H5Dclose(h5_dset_id);
+    }
+    
+    H5Sclose(h5_space_id);
+    H5Pclose(h5_lcpl_id);
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+// Adds the extras to a file written by relay. Relative link targets are
+// resolved by hdf5 relative to the directory of output_file.
+//-----------------------------------------------------------------------------
+static void
+write_extras(const std::string &output_file,
+             const Node &extras)
+{
+    if(extras.number_of_children() == 0)
+    {
+        return;
+    }
+
+    hid_t h5_file_id = H5Fopen(output_file.c_str(),
+                               H5F_ACC_RDWR,
+                               H5P_DEFAULT);
+    if(h5_file_id < 0)
+    {
+        STRAWMAN_ERROR("Error: failed to open " << output_file
+                       << " to add links and compressed data");
+    }
+
+    std::string failed_path;
+
+    if(extras.has_child("links"))
+    {
+        const Node &links = extras["links"];
+        for(index_t i = 0; 
+            i < links.number_of_children() && failed_path.empty();
+            i++)
+        {
+            const Node &link = links.child(i);
+            herr_t status = H5Lcreate_external(link["file"].as_string().c_str(),
+                                               link["path"].as_string().c_str(),
+                                               h5_file_id,
+                                               link["name"].as_string().c_str(),
+                                               H5P_DEFAULT,
+                                               H5P_DEFAULT);
+            if(status < 0)
+            {
+                failed_path = link["name"].as_string();
+            }
+        }
+    }
+
+    if(extras.has_child("datasets"))
+    {
+        const Node &datasets = extras["datasets"];
+        for(index_t i = 0; 
+            i < datasets.number_of_children() && failed_path.empty();
+            i++)
+        {
+            const Node &ds = datasets.child(i);
+            int64 storage = write_chunked_dataset(h5_file_id,ds);
+            if(storage < 0)
+            {
+                failed_path = ds["path"].as_string();
+                continue;
+            }
+
+            if(!ds.has_child("ratio_path"))
+            {
+                continue;
+            }
+
+            // record the achieved ratio next to the compressed data
+            float64 stored_bytes = (float64) (storage + ds["extra_bytes"].to_int64());
+            float64 ratio = stored_bytes > 0 ? 
+                            ds["raw_bytes"].to_float64() / stored_bytes : 1.0;
+            
+            if(!write_float64_scalar(h5_file_id,
+                                     ds["ratio_path"].as_string(),
+                                     ratio))
+            {
+                failed_path = ds["ratio_path"].as_string();
+            }
+        }
+    }
+
+    H5Fclose(h5_file_id);
+
+    if(!failed_path.empty())
+    {
+        STRAWMAN_ERROR("Error: failed to write " << failed_path
+                       << " in " << output_file);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Copies src into dest as compact data. When dest already holds a tree with
+// the same layout (e.g. the previous cycle), its memory is reused and each
+// leaf is a single memcpy.
+//-----------------------------------------------------------------------------
+static void
+stage_copy(const Node &src, Node &dest)
+{
+    if(src.dtype().is_object())
+    {
+        bool reuse = dest.dtype().is_object() && 
+                     dest.number_of_children() == src.number_of_children();
+
+        NodeConstIterator itr = src.children();
+        while(reuse && itr.has_next())
+        {
+            itr.next();
+            reuse = dest.has_child(itr.name());
+        }
+
+        if(!reuse)
+        {
+            dest.reset();
+        }
+
+        itr = src.children();
+        while(itr.has_next())
+        {
+            const Node &child = itr.next();
+            stage_copy(child, dest[itr.name()]);
+        }
+    }
+    else if(src.dtype().is_list())
+    {
+        index_t num_children = src.number_of_children();
+
+        if(!dest.dtype().is_list() ||
+           dest.number_of_children() != num_children)
+        {
+            dest.reset();
+            for(index_t i = 0; i < num_children; i++)
+            {
+                dest.append();
+            }
+        }
+        
+        for(index_t i = 0; i < num_children; i++)
+        {
+            stage_copy(src.child(i), dest.child(i));
+        }
+    }
+    else if(!src.dtype().is_empty() &&
+            src.is_compact() &&
+            dest.is_compact() &&
+            dest.dtype().compatible(src.dtype()))
+    {
+        memcpy(dest.element_ptr(0),
+               src.element_ptr(0),
+               src.total_bytes_compact());
+    }
+    else
+    {
+        src.compact_to(dest);
+    }
+}
+
+#ifdef PARALLEL
+//-----------------------------------------------------------------------------
+// Packs a tree into a byte buffer (schema size, compact schema json and
+// serialized data), so trees of all ranks can be gathered in one call.
+//-----------------------------------------------------------------------------
+static void
+pack_tree(const Node &node,
+          std::vector<uint8> &buffer)
+{
+    Schema s_compact;
+    node.schema().compact_to(s_compact);
+    std::string schema_json = s_compact.to_json();
+    
+    std::vector<uint8> data;
+    node.serialize(data);
+
+    uint64 schema_size = schema_json.size();
+    buffer.resize(sizeof(uint64) + schema_size + data.size());
+    memcpy(&buffer[0], &schema_size, sizeof(uint64));
+    memcpy(&buffer[sizeof(uint64)], schema_json.c_str(), schema_size);
+    if(!data.empty())
+    {
+        memcpy(&buffer[sizeof(uint64) + schema_size], &data[0], data.size());
+    }
+}
+
+//-----------------------------------------------------------------------------
+static void
+unpack_tree(const uint8 *buffer,
+            Node &node)
+{
+    uint64 schema_size = 0;
+    memcpy(&schema_size, buffer, sizeof(uint64));
+    std::string schema_json((const char*)(buffer + sizeof(uint64)),
+                            schema_size);
+    Node n_view(Schema(schema_json),
+                (void*)(buffer + sizeof(uint64) + schema_size),
+                true);
+    node.set(n_view);
+}
+#endif
+
+#ifdef PARALLEL
+//-----------------------------------------------------------------------------
+BlueprintHDF5Pipeline::IOManager::IOManager(MPI_Comm mpi_comm)
+:m_rank(0),
+ m_mpi_comm(mpi_comm),
+ m_async(false),
+ m_shutdown(false),
+ m_mesh_ranks_per_file(0),
+ m_mesh_fingerprint(0),
+ m_root_key(0),
+ m_root_num_domains(0),
+ m_root_ranks_per_file(0)
+{
+    MPI_Comm_rank(m_mpi_comm, &m_rank);
+    MPI_Comm_size(m_mpi_comm, &m_mpi_size);
+}
+#else
+//-----------------------------------------------------------------------------
+BlueprintHDF5Pipeline::IOManager::IOManager()
+:m_rank(0),
+ m_async(false),
+ m_shutdown(false),
+ m_mesh_ranks_per_file(0),
+ m_mesh_fingerprint(0),
+ m_root_key(0),
+ m_root_num_domains(0),
+ m_root_ranks_per_file(0)
+{
+    
+}
+#endif
+
+//-----------------------------------------------------------------------------
+BlueprintHDF5Pipeline::IOManager::~IOManager()
+{
+    Finish();
+}
+
+//-----------------------------------------------------------------------------
+std::string
+BlueprintHDF5Pipeline::IOManager::Finish()
+{
+    if(m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_cond.notify_all();
+        // the writer empties the queue before it exits
+        m_writer.join();
+    }
+
+    std::string error = m_write_error;
+    m_write_error = "";
+
+    // wait for staged files to reach their final path
+    try
+    {
+        m_stager.Drain();
+    }
+    catch(conduit::Error &e)
+    {
+        if(error.empty())
+        {
+            error = e.message();
+        }
+    }
+
+    return error;
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintHDF5Pipeline::IOManager::SetOptions(const Node &options)
+{
+    m_stager.SetOptions(options);
+
+    if(options.has_path("hdf5/async") &&
+       options["hdf5/async"].as_string() == "true")
+    {
+        m_async = true;
+    }
+    
+    if(!m_async || m_writer.joinable())
+    {
+        return;
+    }
+    
+    // two outstanding dumps double buffer the output: one is
+    // written while the next cycle is staged
+    int max_outstanding = 2;
+    if(options.has_path("hdf5/max_outstanding"))
+    {
+        max_outstanding = options["hdf5/max_outstanding"].to_int();
+    }
+
+    if(max_outstanding < 1)
+    {
+        STRAWMAN_WARN("hdf5/max_outstanding must be at least 1, using 1");
+        max_outstanding = 1;
+    }
+
+    m_slots.resize(max_outstanding);
+    for(int i = max_outstanding - 1; i >= 0; i--)
+    {
+        m_free_slots.push_back(i);
+    }
+
+    m_writer = std::thread(&BlueprintHDF5Pipeline::IOManager::WriteLoop,
+                           this);
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintHDF5Pipeline::IOManager::WriteFile(const Node &data,
+                                            const std::string &output_file,
+                                            const Node &extras)
+{
+    if(!m_async)
+    {
+        std::string write_file = m_stager.StagePath(output_file);
+        {
+            std::lock_guard<std::mutex> hdf5_lock(m_hdf5_mutex);
+            relay::io::save(data,write_file);
+            write_extras(write_file,extras);
+        }
+        m_stager.Submit(write_file,output_file);
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(!m_write_error.empty())
+    {
+        std::string msg = m_write_error;
+        m_write_error = "";
+        lock.unlock();
+        STRAWMAN_ERROR("Async HDF5 write failed: " << msg);
+    }
+
+    // block the simulation only when all staging buffers are in use
+    while(m_free_slots.empty())
+    {
+        m_cond.wait(lock);
+    }
+
+    WriteRequest req;
+    req.m_slot        = m_free_slots.back();
+    req.m_output_file = output_file;
+    m_free_slots.pop_back();
+
+    // the slot is not visible to the writer until it is queued
+    lock.unlock();
+    Node &slot = m_slots[req.m_slot];
+    stage_copy(data, slot["data"]);
+    stage_copy(extras, slot["extras"]);
+    lock.lock();
+
+    m_queue.push_back(req);
+    lock.unlock();
+    m_cond.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintHDF5Pipeline::IOManager::WriteLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(true)
+    {
+        while(m_queue.empty() && !m_shutdown)
+        {
+            m_cond.wait(lock);
+        }
+
+        if(m_queue.empty())
+        {
+            break;
+        }
+
+        WriteRequest req = m_queue.front();
+        m_queue.pop_front();
+        lock.unlock();
 
+        std::string error;
+        try
+        {
+            Node &slot = m_slots[req.m_slot];
+            std::string write_file = m_stager.StagePath(req.m_output_file);
+            {
+                std::lock_guard<std::mutex> hdf5_lock(m_hdf5_mutex);
+                relay::io::save(slot["data"],write_file);
+                write_extras(write_file,slot["extras"]);
+            }
+            m_stager.Submit(write_file,req.m_output_file);
+        }
+        catch(conduit::Error &e)
+        {
+            error = e.message();
+        }
+        
+        lock.lock();
+        if(!error.empty())
+        {
+            m_write_error = error;
+        }
+        m_free_slots.push_back(req.m_slot);
+        m_cond.notify_all();
+    }
+}
 
 //-----------------------------------------------------------------------------
-// -- begin strawman:: --
-//-----------------------------------------------------------------------------
-namespace strawman
+int
+BlueprintHDF5Pipeline::IOManager::RanksPerFile(const Node &options)
 {
+    int ranks_per_file = 1;
+#ifdef PARALLEL
+    if(options.has_path("aggregation/ranks_per_file"))
+    {
+        ranks_per_file = options["aggregation/ranks_per_file"].to_int();
+    }
+    else if(options.has_path("aggregation/num_files"))
+    {
+        int num_files = options["aggregation/num_files"].to_int();
+        if(num_files > 0)
+        {
+            ranks_per_file = (m_mpi_size + num_files - 1) / num_files;
+        }
+    }
+
+    if(ranks_per_file < 1)
+    {
+        ranks_per_file = 1;
+    }
+
+    if(ranks_per_file > m_mpi_size)
+    {
+        ranks_per_file = m_mpi_size;
+    }
+#endif
+    return ranks_per_file;
+}
 
 //-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
-// Internal Class that coordinates writing.
-//-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
-class BlueprintHDF5Pipeline::IOManager
+void
+BlueprintHDF5Pipeline::IOManager::CreateOutputDirectory(const std::string &output_dir)
 {
-public:
+    bool dir_ok = false;
 
-    // construction and destruction 
+    // let rank zero handle dir creation
+    if(m_rank == 0)
+    {
+        // check of the dir exists
+        dir_ok = directory_exists(output_dir);
+        if(!dir_ok)
+        {
+            // if not try to let rank zero create it
+            dir_ok = create_directory(output_dir);
+        }
+    }
+    
 #ifdef PARALLEL
-     IOManager(MPI_Comm mpi_comm);
+    // use an mpi sum to check if the dir exists
+    Node n_src, n_reduce;
+    
+    if(dir_ok)
+        n_src = (int)1;
+    else
+        n_src = (int)0;
+
+    mpi::all_reduce(n_src,
+                    n_reduce,
+                    MPI_INT,
+                    MPI_MAX,
+                    m_mpi_comm);
+
+    // error out if something went wrong.
+    if(n_reduce.as_int() != 1)
+    {
+        STRAWMAN_ERROR("Error: failed to create directory " << output_dir);
+    } 
 #else
-     IOManager();
+    if(!dir_ok)
+    {
+        STRAWMAN_ERROR("Error: failed to create directory " << output_dir);
+    }
 #endif
-    ~IOManager();
-
-    // main call to create hdf5 file set
-    void SaveToHDF5FileSet(const Node &data, const Node &options);
+}
 
 //-----------------------------------------------------------------------------
-// private vars for MPI case
-//-----------------------------------------------------------------------------
-private:
-    int m_rank;
+std::string
+BlueprintHDF5Pipeline::IOManager::DomainFileName(uint64 domain,
+                                                 int ranks_per_file)
+{
+    char fmt_buff[64];
+    ostringstream oss;
 
-//-----------------------------------------------------------------------------
-// private vars for MPI case
-//-----------------------------------------------------------------------------
-#ifdef PARALLEL
-    MPI_Comm            m_mpi_comm;
-    int                 m_mpi_size;
-#endif 
+    // with aggregation, blocks of ranks_per_file consecutive ranks
+    // write their domains into one file
+    if(ranks_per_file == 1)
+    {
+        snprintf(fmt_buff, sizeof(fmt_buff), "%06lu",domain);
+        oss << "domain_" << fmt_buff << ".hdf5";
+    }
+    else
+    {
+        snprintf(fmt_buff, sizeof(fmt_buff), "%06d",m_rank / ranks_per_file);
+        oss << "file_" << fmt_buff << ".hdf5";
+    }
 
-};
+    return oss.str();
+}
 
-#ifdef PARALLEL
 //-----------------------------------------------------------------------------
-BlueprintHDF5Pipeline::IOManager::IOManager(MPI_Comm mpi_comm)
-:m_rank(0),
- m_mpi_comm(mpi_comm)
+void
+BlueprintHDF5Pipeline::IOManager::WriteFileSet(const Node &data,
+                                               const Node &extras,
+                                               const std::string &output_dir,
+                                               int ranks_per_file,
+                                               const std::string &link_dir)
 {
-    MPI_Comm_rank(m_mpi_comm, &m_rank);
-    MPI_Comm_size(m_mpi_comm, &m_mpi_size);
+    uint64 domain = data["state/domain_id"].to_value();
+
+    string file_name   = DomainFileName(domain,ranks_per_file);
+    string output_file = conduit::utils::join_file_path(output_dir,file_name);
+    string link_file   = "";
+    
+    if(!link_dir.empty())
+    {
+        link_file = conduit::utils::join_file_path(link_dir,file_name);
+    }
+
+    if(ranks_per_file == 1)
+    {
+        Node file_extras;
+        append_extras(extras,"",file_extras);
+        if(!link_file.empty())
+        {
+            add_mesh_links(link_file,"",file_extras);
+        }
+        WriteFile(data,output_file,file_extras);
+    }
+#ifdef PARALLEL
+    else
+    {
+        SaveAggregated(data,extras,output_file,ranks_per_file,link_file);
+    }
+#endif
 }
-#else
+
+#ifdef PARALLEL
 //-----------------------------------------------------------------------------
-BlueprintHDF5Pipeline::IOManager::IOManager()
-:m_rank(0)
+void
+BlueprintHDF5Pipeline::IOManager::SaveAggregated(const Node &data,
+                                                 const Node &extras,
+                                                 const std::string &output_file,
+                                                 int ranks_per_file,
+                                                 const std::string &link_file)
 {
+    const int agg_tag  = 4242;
+    int       agg_rank = (m_rank / ranks_per_file) * ranks_per_file;
+
+    if(m_rank != agg_rank)
+    {
+        Node n_send;
+        n_send["data"].set_external(data);
+        if(extras.number_of_children() > 0)
+        {
+            n_send["extras"].set_external(extras);
+        }
+        mpi::send(n_send, agg_rank, agg_tag, m_mpi_comm);
+        return;
+    }
     
-}
-#endif
+    int block_end = std::min(agg_rank + ranks_per_file, m_mpi_size);
+    
+    // the blueprint index addresses each domain as a tree inside the file
+    char fmt_buff[64];
+    Node file_data;
+    Node file_extras;
 
+    uint64 domain = data["state/domain_id"].to_value();
+    snprintf(fmt_buff, sizeof(fmt_buff), "domain_%06lu",domain);
+    file_data[fmt_buff].set_external(data);
+    append_extras(extras,fmt_buff,file_extras);
+    if(!link_file.empty())
+    {
+        add_mesh_links(link_file,fmt_buff,file_extras);
+    }
+    
+    std::vector<Node> recv_domains(block_end - agg_rank - 1);
 
-//-----------------------------------------------------------------------------
-BlueprintHDF5Pipeline::IOManager::~IOManager()
-{
-    // empty
+    for(int src = agg_rank + 1; src < block_end; src++)
+    {
+        Node &n_recv = recv_domains[src - agg_rank - 1];
+        mpi::recv(n_recv, src, agg_tag, m_mpi_comm);
+
+        const Node &recv_data = n_recv["data"];
+        domain = recv_data["state/domain_id"].to_value();
+        snprintf(fmt_buff, sizeof(fmt_buff), "domain_%06lu",domain);
+        file_data[fmt_buff].set_external(recv_data);
+        if(n_recv.has_child("extras"))
+        {
+            append_extras(n_recv["extras"],fmt_buff,file_extras);
+        }
+        if(!link_file.empty())
+        {
+            add_mesh_links(link_file,fmt_buff,file_extras);
+        }
+    }
+
+    WriteFile(file_data,output_file,file_extras);
 }
+#endif
 
 //-----------------------------------------------------------------------------
 void
@@ -172,57 +1518,208 @@ BlueprintHDF5Pipeline::IOManager::SaveToHDF5FileSet(const Node &data,
     oss << output_base_path << ".cycle_" << fmt_buff;
     string output_dir  =  oss.str();
     
-    snprintf(fmt_buff, sizeof(fmt_buff), "%06lu",domain);
-    oss.str("");
-    oss << "domain_" << fmt_buff << ".hdf5";
-    string output_file  = conduit::utils::join_file_path(output_dir,oss.str());
+    int ranks_per_file = RanksPerFile(options);
 
+    int num_domains = 1;
+#ifdef PARALLEL
+    num_domains = m_mpi_size;
+#endif
+    int num_files = (num_domains + ranks_per_file - 1) / ranks_per_file;
 
-    bool dir_ok = false;
+    CreateOutputDirectory(output_dir);
 
-    // let rank zero handle dir creation
-    if(m_rank == 0)
+    // compressed and chunked fields are written by write_extras instead
+    // of relay
+    Node prepared_data, extras, prepared_storage, chunk_index;
+    const Node *save_data = &data;
+    bool chunking = options.has_child("chunking");
+
+    if((options.has_child("compression") || chunking) &&
+       data.has_child("fields"))
     {
-        // check of the dir exists
-        dir_ok = directory_exists(output_dir);
-        if(!dir_ok)
+        prepare_fields(data,
+                       options,
+                       prepared_data,
+                       extras,
+                       prepared_storage,
+                       chunk_index);
+        save_data = &prepared_data;
+    }
+
+    // rank 0 collects the chunk min and max of all domains for the
+    // root file
+    Node all_chunk_index;
+    if(chunking)
+    {
+        char domain_buff[64];
+        if(chunk_index.number_of_children() > 0)
         {
-            // if not try to let rank zero create it
-            dir_ok = create_directory(output_dir);
+            snprintf(domain_buff, sizeof(domain_buff), "domain_%06lu",domain);
+            all_chunk_index[domain_buff].set_external(chunk_index);
         }
-    }
-    
-    int num_domains = 1;
 #ifdef PARALLEL
-    num_domains = m_mpi_size;
-    
-    // use an mpi sum to check if the dir exists
-    Node n_src, n_reduce;
-    
-    if(dir_ok)
-        n_src = (int)1;
-    else
-        n_src = (int)0;
+        //
+        // one gather of the packed indices, instead of a receive per rank
+        //
+        Node n_send;
+        n_send["domain_id"] = domain;
+        if(chunk_index.number_of_children() > 0)
+        {
+            n_send["chunk_index"].set_external(chunk_index);
+        }
+        std::vector<uint8> send_buffer;
+        pack_tree(n_send, send_buffer);
+
+        int send_size = (int)send_buffer.size();
+        std::vector<int> recv_sizes(m_rank == 0 ? m_mpi_size : 0);
+        MPI_Gather(&send_size, 1, MPI_INT,
+                   m_rank == 0 ? &recv_sizes[0] : NULL, 1, MPI_INT,
+                   0, m_mpi_comm);
+
+        std::vector<int>   recv_offsets(recv_sizes.size(), 0);
+        std::vector<uint8> recv_buffer;
+        if(m_rank == 0)
+        {
+            int64 total_size = 0;
+            for(int src = 0; src < m_mpi_size; src++)
+            {
+                recv_offsets[src] = (int)total_size;
+                total_size += recv_sizes[src];
+            }
+            
+            if(total_size > INT_MAX)
+            {
+                STRAWMAN_ERROR("chunk index of all domains exceeds "
+                               << INT_MAX << " bytes");
+            }
+            recv_buffer.resize(total_size);
+        }
 
-    mpi::all_reduce(n_src,
-                    n_reduce,
-                    MPI_INT,
-                    MPI_MAX,
+        MPI_Gatherv(&send_buffer[0], send_size, MPI_BYTE,
+                    m_rank == 0 ? &recv_buffer[0] : NULL,
+                    m_rank == 0 ? &recv_sizes[0] : NULL,
+                    m_rank == 0 ? &recv_offsets[0] : NULL,
+                    MPI_BYTE,
+                    0,
                     m_mpi_comm);
 
-    // error out if something went wrong.
-    if(n_reduce.as_int() != 1)
-    {
-        STRAWMAN_ERROR("Error: failed to create directory " << output_dir);
-    } 
-#else
-    if(!dir_ok)
+        if(m_rank == 0)
+        {
+            for(int src = 1; src < m_mpi_size; src++)
+            {
+                Node n_recv;
+                unpack_tree(&recv_buffer[recv_offsets[src]], n_recv);
+                if(!n_recv.has_child("chunk_index"))
+                {
+                    continue;
+                }
+                uint64 src_domain = n_recv["domain_id"].to_uint64();
+                snprintf(domain_buff, sizeof(domain_buff), "domain_%06lu",src_domain);
+                all_chunk_index[domain_buff].set(n_recv["chunk_index"]);
+            }
+        }
+#endif
+    }
+
+    bool static_mesh = options.has_path("static_mesh") &&
+                       options["static_mesh"].as_string() == "true";
+
+    if(!static_mesh)
     {
-        STRAWMAN_ERROR("Error: failed to create directory " << output_dir);
+        WriteFileSet(*save_data,extras,output_dir,ranks_per_file,"");
     }
+    else
+    {
+        // split the tree into the mesh (coordsets and topologies), which
+        // is only written when it changes, and everything else
+        Node mesh, cycle_data;
+        NodeConstIterator itr = save_data->children();
+        while(itr.has_next())
+        {
+            const Node &child = itr.next();
+            std::string name = itr.name();
+            if(name == "coordsets" || name == "topologies")
+            {
+                mesh[name].set_external(child);
+            }
+            else
+            {
+                cycle_data[name].set_external(child);
+            }
+        }
+
+        // hashed a word at a time, a byte-wise hash of large unstructured
+        // meshes costs close to the write it avoids
+        uint64 mesh_fingerprint = content_fingerprint(mesh);
+
+        int mesh_changed = 0;
+        if(m_mesh_dir.empty() ||
+           m_mesh_fingerprint    != mesh_fingerprint ||
+           m_mesh_output_path    != output_base_path ||
+           m_mesh_ranks_per_file != ranks_per_file)
+        {
+            mesh_changed = 1;
+        }
+
+#ifdef PARALLEL
+        // the mesh file set is shared, rewrite it if any domain changed
+        Node n_src, n_reduce;
+        n_src = mesh_changed;
+        mpi::all_reduce(n_src,
+                        n_reduce,
+                        MPI_INT,
+                        MPI_MAX,
+                        m_mpi_comm);
+        mesh_changed = n_reduce.as_int();
 #endif
 
-    relay::io::save(data,output_file);
+        if(mesh_changed == 1)
+        {
+            oss.str("");
+            oss << output_base_path << ".mesh_" << fmt_buff;
+            m_mesh_dir            = oss.str();
+            m_mesh_output_path    = output_base_path;
+            m_mesh_ranks_per_file = ranks_per_file;
+            m_mesh_fingerprint    = mesh_fingerprint;
+
+            CreateOutputDirectory(m_mesh_dir);
+            // state holds the domain id used to name the trees
+            mesh["state"].set_external(data["state"]);
+            WriteFileSet(mesh,Node(),m_mesh_dir,ranks_per_file,"");
+        }
+
+        // the cycle files link to the mesh files, relative to the
+        // cycle directory
+        string mesh_dir_base, mesh_dir_path;
+        // TODO: Fix for windows
+        conduit::utils::rsplit_string(m_mesh_dir,
+                                      "/",
+                                      mesh_dir_base,
+                                      mesh_dir_path);
+
+        WriteFileSet(cycle_data,
+                     extras,
+                     output_dir,
+                     ranks_per_file,
+                     conduit::utils::join_file_path("..",mesh_dir_base));
+    }
+
+    //
+    // Aggregated files are numbered by rank, but the trees inside them
+    // by domain id. Rank 0 collects the domain id of each rank so the
+    // root file can map every tree to the file that holds it.
+    //
+    std::vector<int64> rank_domains(1, (int64)domain);
+#ifdef PARALLEL
+    if(ranks_per_file > 1)
+    {
+        int64 local_domain = (int64)domain;
+        rank_domains.resize(m_rank == 0 ? m_mpi_size : 0);
+        MPI_Gather(&local_domain, 1, MPI_LONG_LONG,
+                   m_rank == 0 ? &rank_domains[0] : NULL, 1, MPI_LONG_LONG,
+                   0, m_mpi_comm);
+    }
+#endif
 
     // let rank zero write out the root file
     if(m_rank == 0)
@@ -245,29 +1742,108 @@ BlueprintHDF5Pipeline::IOManager::SaveToHDF5FileSet(const Node &data,
                                       output_dir_base,
                                       output_dir_path);
 
-        string output_file_pattern = conduit::utils::join_file_path(output_dir_base,
-                                                                    "domain_%06d.hdf5");
+        string output_file_pattern;
+        
+        if(ranks_per_file == 1)
+        {
+            output_file_pattern = conduit::utils::join_file_path(output_dir_base,
+                                                                 "domain_%06d.hdf5");
+        }
+        else
+        {
+            output_file_pattern = conduit::utils::join_file_path(output_dir_base,
+                                                                 "file_%06d.hdf5");
+        }
+
+        // the index only changes with the mesh structure and domain count,
+        // so it is only regenerated when those change
+        uint64 root_key = index_fingerprint(data);
 
+        if(m_root.dtype().is_empty()            ||
+           m_root_key            != root_key    ||
+           m_root_num_domains    != num_domains ||
+           m_root_ranks_per_file != ranks_per_file)
+        {
+            m_root.reset();
+            Node &bp_idx = m_root["blueprint_index"];
 
-        Node root;
-        Node &bp_idx = root["blueprint_index"];
+            blueprint::mesh::generate_index(data,
+                                            "",
+                                            num_domains,
+                                            bp_idx["mesh"]);
+            
+            m_root["protocol/name"]    = "conduit_hdf5";
+            m_root["protocol/version"] = "0.2.1";
 
-        blueprint::mesh::generate_index(data,
-                                        "",
-                                        num_domains,
-                                        bp_idx["mesh"]);
+            m_root["number_of_files"]  = num_files;
+            m_root["number_of_trees"]  = num_domains;
             
-        root["protocol/name"]    = "conduit_hdf5";
-        root["protocol/version"] = "0.2.1";
+            if(ranks_per_file == 1)
+            {
+                m_root["tree_pattern"] = "/";
+            }
+            else
+            {
+                m_root["tree_pattern"] = "domain_%06d";
+            }
+
+            m_root_key            = root_key;
+            m_root_num_domains    = num_domains;
+            m_root_ranks_per_file = ranks_per_file;
+        }
 
-        root["number_of_files"]  = num_domains;
-        root["number_of_trees"]  = num_domains;
+        // patch the parts that change every dump
         // TODO: make sure this is relative 
-        root["file_pattern"]     = output_file_pattern;
-        root["tree_pattern"]     = "/";
+        m_root["file_pattern"] = output_file_pattern;
+
+        if(ranks_per_file > 1)
+        {
+            // tree_files[i] is the file that holds tree (domain) i
+            m_root["tree_files"].set(DataType::int32(num_domains));
+            int32_array tree_files = m_root["tree_files"].value();
+            for(int i = 0; i < num_domains; i++)
+            {
+                tree_files[i] = -1;
+            }
+
+            for(size_t r = 0; r < rank_domains.size(); r++)
+            {
+                int64 tree = rank_domains[r];
+                if(tree < 0 || tree >= num_domains || tree_files[tree] != -1)
+                {
+                    STRAWMAN_ERROR("Aggregated saves need the domain ids to"
+                                   " be unique and in [0," << num_domains
+                                   << "), rank " << r << " has domain id "
+                                   << tree);
+                }
+                tree_files[tree] = (int32)(r / ranks_per_file);
+            }
+        }
+
+        if(m_root.has_child("chunk_index"))
+        {
+            m_root.remove("chunk_index");
+        }
+
+        if(all_chunk_index.number_of_children() > 0)
+        {
+            m_root["chunk_index"].set(all_chunk_index);
+        }
+
+        Node &bp_idx_mesh = m_root["blueprint_index/mesh"];
+        if(bp_idx_mesh.has_path("state/cycle") && data.has_path("state/cycle"))
+        {
+            bp_idx_mesh["state/cycle"].set(data["state/cycle"]);
+        }
+
+        if(bp_idx_mesh.has_path("state/time") && data.has_path("state/time"))
+        {
+            bp_idx_mesh["state/time"].set(data["state/time"]);
+        }
 
         CONDUIT_INFO("Creating: " << root_file);
-        relay::io::save(root,root_file,"hdf5");
+        std::lock_guard<std::mutex> hdf5_lock(m_hdf5_mutex);
+        relay::io::save(m_root,root_file,"hdf5");
 
     }
 }
@@ -322,6 +1898,7 @@ BlueprintHDF5Pipeline::Initialize(const conduit::Node &options)
     m_io = new IOManager();
 #endif
 
+    m_io->SetOptions(options);
 }
 
 
@@ -329,12 +1906,21 @@ BlueprintHDF5Pipeline::Initialize(const conduit::Node &options)
 void
 BlueprintHDF5Pipeline::Cleanup()
 {
-    if(m_io != NULL)
+    if(m_io == NULL)
     {
-        delete m_io;
+        return;
     }
 
+    // finishes any outstanding async writes
+    IOManager *io = m_io;
     m_io = NULL;
+    std::string error = io->Finish();
+    delete io;
+
+    if(!error.empty())
+    {
+        STRAWMAN_WARN("Async HDF5 write failed: " << error);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -360,6 +1946,17 @@ BlueprintHDF5Pipeline::Execute(const conduit::Node &actions)
         {
             m_io->SaveToHDF5FileSet(m_data,action);
         }
+        else if (action["action"].as_string() == "save_extract")
+        {
+            // the extract is a mesh of its own, with its own file set
+            // and blueprint index
+            Node extract;
+            {
+                STRAWMAN_BLOCK_TIMER(EXTRACT);
+                extract_mesh(m_data,action,extract);
+            }
+            m_io->SaveToHDF5FileSet(extract,action);
+        }
         else
         {
             STRAWMAN_INFO("Warning : unknown action "
@@ -52,6 +52,7 @@
 
 // standard lib includes
 #include <iostream>
+#include <fstream>
 #include <string.h>
 #include <limits.h>
 #include <cstdlib>
@@ -103,6 +104,9 @@
 #include <eavlIsosurfaceFilter.h>
 #include <eavlBoxMutator.h>
 
+//--- eavl exporters
+#include <eavlVTKExporter.h>
+
 
 // mpi related includes
 #ifdef PARALLEL
@@ -118,6 +122,7 @@
 #include <strawman_block_timer.hpp>
 #include <strawman_png_encoder.hpp>
 #include <strawman_web_interface.hpp>
+#include <strawman_file_stager.hpp>
 
 using namespace conduit;
 
@@ -138,11 +143,24 @@ struct EAVLPipeline::Plot
     std::string        m_cell_set_name;
     bool               m_drawn;
     bool               m_hidden;
+    std::string        m_color_table;
     eavlDataSet       *m_eavl_dataset;
     eavlPlot          *m_eavl_plot;
     Node               m_render_options;
 };
 
+//-----------------------------------------------------------------------------
+// The output of a filter, which is a cell set and field of a data set
+// owned by the pipeline for the current cycle.
+//-----------------------------------------------------------------------------
+struct EAVLPipeline::FilterOutput
+{
+    eavlDataSet       *m_eavl_dataset;
+    std::string        m_cell_set_name;
+    std::string        m_var_name;
+    std::string        m_color_table;
+};
+
 
 //-----------------------------------------------------------------------------
 //
@@ -329,6 +347,7 @@ private:
     bool                m_web_stream_enabled; // CDH: move to pipeline ?
     
     WebInterface        m_web_interface;
+    FileStager          m_file_stager;
     PNGEncoder          m_png_data;
 
 //-----------------------------------------------------------------------------
@@ -862,7 +881,11 @@ EAVLPipeline::Renderer::SetOptions(const Node &options)
         m_web_stream_enabled = true;
     }
     
-    
+    // frame rate and image size requested for the web client
+    m_web_interface.SetOptions(options);
+
+    // optional staging directory for saved images
+    m_file_stager.SetOptions(options);
 }
 
 //-----------------------------------------------------------------------------
@@ -1025,6 +1048,24 @@ EAVLPipeline::Renderer::Render(eavlPlot *plot,
     try
     {
         PNGEncoder png;
+
+        //
+        // Images that are only streamed use the size
+        // requested for the web client (if any)
+        //
+        if(image_file_name == NULL && m_web_stream_enabled)
+        {
+            if(m_web_interface.TargetWidth() > 0)
+            {
+                image_width = m_web_interface.TargetWidth();
+            }
+
+            if(m_web_interface.TargetHeight() > 0)
+            {
+                image_height = m_web_interface.TargetHeight();
+            }
+        }
+
         //
         // Do some check to see if we need
         // to re-init rendering
@@ -1262,7 +1303,11 @@ EAVLPipeline::Renderer::Render(eavlPlot *plot,
             ofname +=  ".png";
             if(save_image)
             {
-                m_png_data.Save(ofname);
+                // with staging, the image is written locally and moved
+                // to ofname in the background
+                string stage_name = m_file_stager.StagePath(ofname);
+                m_png_data.Save(stage_name);
+                m_file_stager.Submit(stage_name,ofname);
             }
         }
         else
@@ -2111,11 +2156,7 @@ void
 EAVLPipeline::Cleanup()
 {
 
-    for(int i  = 0; i < m_plots.size(); i++)
-    {
-        delete m_plots.at(i).m_eavl_dataset;
-    }
-    m_plots.clear();
+    ClearCycleData();
     m_renderer->ClearScene();
 
     // Uncommenting out this line writes all the timers to a file.
@@ -2134,14 +2175,11 @@ EAVLPipeline::Publish(const conduit::Node &data)
     //
     // We need to clear the scene and 
     // the current plot list when the 
-    // is re-published;
+    // is re-published. Filter outputs are only
+    // valid for one cycle.
     //
     
-    for(int i  = 0; i < m_plots.size(); i++)
-    {
-        delete m_plots.at(i).m_eavl_dataset;
-    }
-    m_plots.clear();
+    ClearCycleData();
     m_renderer->ClearScene();
 }
 
@@ -2169,6 +2207,10 @@ EAVLPipeline::Execute(const conduit::Node &actions)
         {
             DrawPlots();
         }
+        else if (action["action"].as_string() == "save")
+        {
+            Save(action);
+        }
         else
         {
             STRAWMAN_INFO("Warning : unknown action "<<action["action"].as_string());
@@ -2176,6 +2218,13 @@ EAVLPipeline::Execute(const conduit::Node &actions)
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::Info(conduit::Node &out)
+{
+    out.set(m_info);
+}
+
 
 
 
@@ -2194,35 +2243,89 @@ EAVLPipeline::Execute(const conduit::Node &actions)
 
 
 //-----------------------------------------------------------------------------
-void 
+//
+// Filters with a "name" are declared as nodes of a filter dag. A named
+// filter reads either the output of another named filter ("input") or
+// the published mesh with a field ("field_name"). Nodes are only evaluated
+// when a plot or a save action consumes them, so unreferenced branches
+// are never executed, and each node is evaluated once per cycle and shared
+// by its consumers.
+//
+// Filters without a name are applied to the first plot, or to the plot
+// selected with ``plot``.
+//
+//-----------------------------------------------------------------------------
+void
 EAVLPipeline::AddFilter(const conduit::Node &node)
 {
+    if(node.has_path("name"))
+    {
+        const std::string name = node["name"].as_string();
+
+        if(!node.has_path("input") && !node.has_path("field_name"))
+        {
+            STRAWMAN_ERROR("Filter " << name << " needs an input filter"
+                           << " or a field_name");
+        }
+
+        if(m_filters.has_child(name))
+        {
+            STRAWMAN_ERROR("Filter " << name << " was already added");
+        }
+
+        m_filters[name] = node;
+        return;
+    }
+
     if(m_plots.size() < 1)
     {
         STRAWMAN_ERROR("There must be a least one plot to add a filter.");
     }
 
+    int plot_id = 0;
+    if(node.has_path("plot"))
+    {
+        plot_id = node["plot"].to_int();
+    }
+
+    if(plot_id < 0 || plot_id >= (int)m_plots.size())
+    {
+        STRAWMAN_ERROR("Filter plot " << plot_id << " does not exist, "
+                       << m_plots.size() << " plots were added");
+    }
+
+    Plot *current_plot = &m_plots[plot_id];
+    FilterOutput data = PlotData(*current_plot);
+    ApplyFilter(node, data);
+    SetPlotData(*current_plot, data);
+}
+
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::ApplyFilter(const conduit::Node &node,
+                          FilterOutput &data)
+{
     if(node["type"].as_string() == "box_filter")
     {
-        BoxFilter(node);
+        BoxFilter(node, data);
     }
     else if(node["type"].as_string() == "isosurface_filter")
     {
-        IsosurfaceFilter(node);
+        IsosurfaceFilter(node, data);
     }
     else if(node["type"].as_string() == "cell_to_node_filter")
     {
-        CellToNodeFilter(node);
+        CellToNodeFilter(node, data);
     }
     else if(node["type"].as_string() == "threshold_filter")
     {
-        ThresholdFilter(node);
+        ThresholdFilter(node, data);
     }
     else if(node["type"].as_string() == "external_faces_filter")
     {
-        ExternalFacesFilter();
+        ExternalFacesFilter(data);
     }
-    else 
+    else
     {
         STRAWMAN_INFO( "Warning: Unknown filter type "
                        << node["type"].as_string()
@@ -2231,18 +2334,221 @@ EAVLPipeline::AddFilter(const conduit::Node &node)
     }
 }
 
+//-----------------------------------------------------------------------------
+EAVLPipeline::FilterOutput
+EAVLPipeline::EvaluateFilter(const std::string &name)
+{
+    std::map<std::string, FilterOutput>::iterator itr;
+    itr = m_filter_outputs.find(name);
+    if(itr != m_filter_outputs.end())
+    {
+        return itr->second;
+    }
+
+    if(!m_filters.has_child(name))
+    {
+        STRAWMAN_ERROR("Unknown filter " << name);
+    }
+
+    if(m_evaluating.find(name) != m_evaluating.end())
+    {
+        STRAWMAN_ERROR("Filter " << name << " depends on itself");
+    }
+
+    m_evaluating.insert(name);
+
+    const Node &options = m_filters[name];
+    FilterOutput data = FilterInput(options);
+    ApplyFilter(options, data);
+
+    m_evaluating.erase(name);
+
+    m_filter_outputs[name] = data;
+    
+    Node &evaluations = m_info["filters"][name]["evaluations"];
+    evaluations = evaluations.dtype().is_empty() ? 1 : evaluations.to_int() + 1;
+
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+EAVLPipeline::FilterOutput
+EAVLPipeline::FilterInput(const conduit::Node &options)
+{
+    if(options.has_path("input"))
+    {
+        return EvaluateFilter(options["input"].as_string());
+    }
+
+    return SourceData(options["field_name"].as_string(), true);
+}
+
+//-----------------------------------------------------------------------------
+EAVLPipeline::FilterOutput
+EAVLPipeline::SourceData(const std::string &field_name,
+                         bool use_cache)
+{
+    if(use_cache)
+    {
+        std::map<std::string, FilterOutput>::iterator itr;
+        itr = m_source_outputs.find(field_name);
+        if(itr != m_source_outputs.end())
+        {
+            return itr->second;
+        }
+    }
+
+    FilterOutput data;
+    data.m_eavl_dataset  = DataAdapter::BlueprintToEAVLDataSet(m_data,
+                                                               field_name);
+    m_data_sets.push_back(data.m_eavl_dataset);
+
+    Node &conversions = m_info["sources"][field_name]["conversions"];
+    conversions = conversions.dtype().is_empty() ? 1 : conversions.to_int() + 1;
+
+    data.m_cell_set_name = data.m_eavl_dataset->GetCellSet(0)->GetName();
+    data.m_var_name      = field_name;
+    data.m_color_table   = "Spectral";
+
+    if(use_cache)
+    {
+        m_source_outputs[field_name] = data;
+    }
+
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+EAVLPipeline::FilterOutput
+EAVLPipeline::PlotData(const Plot &plot)
+{
+    FilterOutput data;
+    data.m_eavl_dataset  = plot.m_eavl_dataset;
+    data.m_cell_set_name = plot.m_cell_set_name;
+    data.m_var_name      = plot.m_var_name;
+    data.m_color_table   = plot.m_color_table;
+    return data;
+}
+
 //-----------------------------------------------------------------------------
 void
-EAVLPipeline::ExternalFacesFilter()
+EAVLPipeline::SetPlotData(Plot &plot,
+                          const FilterOutput &data)
+{
+    //
+    // Create new plot to replace the current one
+    //
+    eavlPlot *new_plot = new eavlPlot(data.m_eavl_dataset,
+                                      data.m_cell_set_name);
+    new_plot->SetField(data.m_var_name);
+    new_plot->SetColorTableByName(data.m_color_table);
+
+    // drawn plots are owned by the renderer's scene
+    if(!plot.m_drawn)
+    {
+        delete plot.m_eavl_plot;
+    }
+    plot.m_eavl_plot = new_plot;
+
+    //
+    // Set the Plot names so another filter can operate
+    // on the data if needed.
+    //
+    plot.m_eavl_dataset  = data.m_eavl_dataset;
+    plot.m_cell_set_name = data.m_cell_set_name;
+    plot.m_var_name      = data.m_var_name;
+    plot.m_color_table   = data.m_color_table;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Box and threshold add a cell set with a fixed name to their input data
+// set, so two of them on the same input would collide. Each one works on
+// a shallow copy of its input instead, which shares the arrays but gets
+// its own list of cell sets and fields.
+//
+//-----------------------------------------------------------------------------
+EAVLPipeline::FilterOutput
+EAVLPipeline::ShallowCopy(const FilterOutput &data)
+{
+    FilterOutput copy = data;
+    copy.m_eavl_dataset = data.m_eavl_dataset->CreateShallowCopy();
+    m_data_sets.push_back(copy.m_eavl_dataset);
+
+    std::map<eavlDataSet*, std::set<std::string> >::iterator itr;
+    itr = m_derived_names.find(data.m_eavl_dataset);
+    if(itr != m_derived_names.end())
+    {
+        m_derived_names[copy.m_eavl_dataset] = itr->second;
+    }
+
+    return copy;
+}
+
+//-----------------------------------------------------------------------------
+bool
+EAVLPipeline::IsDerived(eavlDataSet *data_set,
+                        const std::string &name)
+{
+    std::map<eavlDataSet*, std::set<std::string> >::iterator itr;
+    itr = m_derived_names.find(data_set);
+    if(itr == m_derived_names.end())
+    {
+        return false;
+    }
+    return itr->second.find(name) != itr->second.end();
+}
+
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::SetDerived(eavlDataSet *data_set,
+                         const std::string &name)
+{
+    m_derived_names[data_set].insert(name);
+}
+
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::ClearCycleData()
+{
+    for(int i  = 0; i < m_data_sets.size(); i++)
+    {
+        delete m_data_sets[i];
+    }
+    m_data_sets.clear();
+    m_derived_names.clear();
+
+    m_plots.clear();
+    m_filters.reset();
+    m_filter_outputs.clear();
+    m_source_outputs.clear();
+    m_evaluating.clear();
+    m_info.reset();
+}
+
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::ExternalFacesFilter(FilterOutput &data)
 {
     STRAWMAN_BLOCK_TIMER(EXTERNAL_FACES);
+
+    //Use eavl's default naming convention
+    string new_cell_set_name = "extface_of_";
+    new_cell_set_name += data.m_cell_set_name;
+
     //
-    // Box plot is an EAVL mutator, which adds a cell set to 
-    // the plot data set. For now, we assume only a single plot
+    // External faces is an EAVL mutator, which adds a cell set to
+    // the data set. It has no parameters, so an existing result can
+    // be shared.
     //
-    Plot *current_plot = &m_plots[0];
+    if(IsDerived(data.m_eavl_dataset, new_cell_set_name))
+    {
+        data.m_cell_set_name = new_cell_set_name;
+        return;
+    }
+
     // Get dimensionality
-    const int topo_dims = current_plot->m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
+    const int topo_dims = data.m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
     eavlExternalFaceMutator facer;
     if(topo_dims != 3)
     {
@@ -2250,8 +2556,8 @@ EAVLPipeline::ExternalFacesFilter()
     }
     try
     {
-        facer.SetDataSet(current_plot->m_eavl_dataset);
-        facer.SetCellSet(current_plot->m_cell_set_name);
+        facer.SetDataSet(data.m_eavl_dataset);
+        facer.SetCellSet(data.m_cell_set_name);
         facer.Execute();
     }
     catch (const eavlException &e)
@@ -2259,52 +2565,36 @@ EAVLPipeline::ExternalFacesFilter()
         STRAWMAN_ERROR("EAVL exception while applying external Faces filter "
                         << e.GetErrorText());
     }
-    //
-    // Create new plot to replace the current one 
-    //
-    
-    //Use eavl's default naming convention
-    
-    string new_cell_set_name = "extface_of_";
-    new_cell_set_name += current_plot->m_cell_set_name;
-    
-    eavlPlot *newPlot = new eavlPlot(current_plot->m_eavl_dataset,
-                                     new_cell_set_name);
-    newPlot->SetColorTableByName("Spectral");
-    
-    string new_var_name = current_plot->m_var_name; 
-    
-    newPlot->SetField(new_var_name);
-    
-    delete current_plot->m_eavl_plot;
-    current_plot->m_eavl_plot = newPlot;
 
-    //
-    // Set the Plot names so another filter can operate
-    // on the data if needed.
-    //
-    current_plot->m_cell_set_name = new_cell_set_name;
+    SetDerived(data.m_eavl_dataset, new_cell_set_name);
+    data.m_cell_set_name = new_cell_set_name;
 }
 
 //-----------------------------------------------------------------------------
 void
-EAVLPipeline::BoxFilter(const conduit::Node &node)
+EAVLPipeline::BoxFilter(const conduit::Node &node,
+                        FilterOutput &data)
 {
-    
+    //eavl's default naming convention
+    string new_cell_set_name = "box_of_";
+    new_cell_set_name += data.m_cell_set_name;
+
     //
-    // Box plot is a mutator, which adds a cell set to 
-    // the plot data set. For now, we assume only a single plot
+    // Box is a mutator, which adds a cell set to the data set.
+    // Different ranges can't share the same cell set name, so the
+    // cell set is added to a copy of the input.
     //
-    Plot *current_plot = &m_plots[0];
+    data = ShallowCopy(data);
+
     // Get dimensionality
-    const int dims = current_plot->m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
+    const int dims = data.m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
     eavlBoxMutator boxer;
     const float64 *range = node["range"].as_float64_ptr();
-    
+
     try
     {
-        boxer.SetDataSet(current_plot->m_eavl_dataset);
-        
+        boxer.SetDataSet(data.m_eavl_dataset);
+
         if(dims == 2)
         {
             boxer.SetRange2D(range[0], range[1], range[2],range[3]);
@@ -2318,7 +2608,7 @@ EAVLPipeline::BoxFilter(const conduit::Node &node)
                              range[4],
                              range[5]);
         }
-        boxer.SetCellSet(current_plot->m_cell_set_name);
+        boxer.SetCellSet(data.m_cell_set_name);
         boxer.Execute();
     }
     catch (const eavlException &e)
@@ -2326,67 +2616,50 @@ EAVLPipeline::BoxFilter(const conduit::Node &node)
         STRAWMAN_ERROR("EAVL exception while applying external Faces filter "
                        << e.GetErrorText());
     }
-    
-    //
-    // Create new plot to replace the current one 
-    //
-    
-    //eavl's default naming convention
-    
-    string new_cell_set_name = "box_of_";
-    new_cell_set_name += current_plot->m_cell_set_name;
-    
-    eavlPlot *new_plot = new eavlPlot(current_plot->m_eavl_dataset,
-                                      new_cell_set_name);
-    
-    new_plot->SetColorTableByName("Spectral");
-    
+
     string new_var_name;
-    eavlField *field = current_plot->m_eavl_dataset->GetField(current_plot->m_var_name);
-    
+    eavlField *field = data.m_eavl_dataset->GetField(data.m_var_name);
+
     if(field->GetAssociation() == eavlField::ASSOC_CELL_SET)
     {
         new_var_name = "subset_of_";
-        new_var_name += current_plot->m_var_name; 
+        new_var_name += data.m_var_name;
     }
-    else 
+    else
     {
-        new_var_name = current_plot->m_var_name;
+        new_var_name = data.m_var_name;
     }
-    new_plot->SetField(new_var_name);
-    
-    delete current_plot->m_eavl_plot;
-    current_plot->m_eavl_plot = new_plot;
 
-    //
-    // Set the Plot names so another filter can operate
-    // on the data if needed.
-    //
-    current_plot->m_var_name = new_var_name;
-    current_plot->m_cell_set_name = new_cell_set_name;
+    SetDerived(data.m_eavl_dataset, new_cell_set_name);
+    data.m_var_name = new_var_name;
+    data.m_cell_set_name = new_cell_set_name;
 }
 
 //-----------------------------------------------------------------------------
 void
-EAVLPipeline::ThresholdFilter(const conduit::Node &node)
+EAVLPipeline::ThresholdFilter(const conduit::Node &node,
+                              FilterOutput &data)
 {
-    
+    //eavl's default naming convention
+    string new_cell_set_name = "threshold_of_";
+    new_cell_set_name += data.m_cell_set_name;
+
     //
-    // Threshold plot is a mutator, which adds a cell set to 
-    // the plot data set. For now, we assume only a single plot
+    // Threshold is a mutator, which adds a cell set to the data set.
+    // Different ranges can't share the same cell set name, so the
+    // cell set is added to a copy of the input.
     //
-    Plot *current_plot = &m_plots[0];
-    // Get dimensionality
-    const int dims = current_plot->m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
+    data = ShallowCopy(data);
+
     eavlThresholdMutator thresh;
     float64 min_val = node["min_value"].to_float64();
     float64 max_val = node["max_value"].to_float64();
-    
+
     try
     {
-        thresh.SetDataSet(current_plot->m_eavl_dataset);
-        thresh.SetCellSet(current_plot->m_cell_set_name);
-        thresh.SetField(current_plot->m_var_name);
+        thresh.SetDataSet(data.m_eavl_dataset);
+        thresh.SetCellSet(data.m_cell_set_name);
+        thresh.SetField(data.m_var_name);
         thresh.SetRange(min_val, max_val);
         thresh.Execute();
     }
@@ -2395,65 +2668,44 @@ EAVLPipeline::ThresholdFilter(const conduit::Node &node)
         STRAWMAN_ERROR("EAVL exception while applying a threshold filter "
                        << e.GetErrorText());
     }
-    
-    //
-    // Create new plot to replace the current one 
-    //
-    
-    //eavl's default naming convention
-    
-    string new_cell_set_name = "threshold_of_";
-    new_cell_set_name += current_plot->m_cell_set_name;
-    
-    eavlPlot *new_plot = new eavlPlot(current_plot->m_eavl_dataset,
-                                      new_cell_set_name);
-    new_plot->SetColorTableByName("Spectral");
-    
+
     string new_var_name;
-    eavlField *field = current_plot->m_eavl_dataset->GetField(current_plot->m_var_name);
+    eavlField *field = data.m_eavl_dataset->GetField(data.m_var_name);
     if(field->GetAssociation() == eavlField::ASSOC_CELL_SET)
     {
         new_var_name = "subset_of_";
-        new_var_name += current_plot->m_var_name; 
+        new_var_name += data.m_var_name;
     }
-    else 
+    else
     {
-        new_var_name = current_plot->m_var_name;
+        new_var_name = data.m_var_name;
     }
-    new_plot->SetField(new_var_name);
-    
-    delete current_plot->m_eavl_plot;
-    current_plot->m_eavl_plot = new_plot;
-    //
-    // Set the Plot names so another filter can operate
-    // on the data if needed.
-    //
-    current_plot->m_var_name = new_var_name;
-    current_plot->m_cell_set_name = new_cell_set_name;
 
+    SetDerived(data.m_eavl_dataset, new_cell_set_name);
+    data.m_var_name = new_var_name;
+    data.m_cell_set_name = new_cell_set_name;
 }
 
 
 //-----------------------------------------------------------------------------
 void
-EAVLPipeline::IsosurfaceFilter(const conduit::Node &node)
+EAVLPipeline::IsosurfaceFilter(const conduit::Node &node,
+                               FilterOutput &data)
 {
     //
-    // Isosurface will replace the current
-    // data set.
-    // 
-    Plot *current_plot = &m_plots[0];
+    // Isosurface creates a new data set.
+    //
     eavlIsosurfaceFilter iso;
 
     try
     {
-        iso.SetInput(current_plot->m_eavl_dataset);
+        iso.SetInput(data.m_eavl_dataset);
         float64 isoValue = node["iso_value"].to_float64();
-        iso.SetCellSet(current_plot->m_cell_set_name);
-        iso.SetField(current_plot->m_var_name);
+        iso.SetCellSet(data.m_cell_set_name);
+        iso.SetField(data.m_var_name);
         iso.SetIsoValue(isoValue);
         iso.Execute();
-        
+
         if(DEBUG)
         {
             ostringstream oss;
@@ -2466,51 +2718,51 @@ EAVLPipeline::IsosurfaceFilter(const conduit::Node &node)
         STRAWMAN_ERROR("EAVL exception while applying a isosurface filter "
                        << e.GetErrorText());
     }
-    
+
     //
-    // Create new plot to replace the current one 
-    // and follow eavl's default names
+    // The input may be shared with other filters, so it lives
+    // until the end of the cycle. Follow eavl's default names.
     //
-
-    string new_cell_set_name = "iso";
     eavlDataSet *output = iso.GetOutput();
-    eavlPlot *new_plot = new eavlPlot(output,
-                                      new_cell_set_name);
-    delete current_plot->m_eavl_dataset;
-    current_plot->m_eavl_dataset = output;
-    
-    new_plot->SetField(current_plot->m_var_name);
-    new_plot->SetColorTableByName("blue");
-    
-    delete current_plot->m_eavl_plot;
-    
-    current_plot->m_eavl_plot = new_plot;
-
-    //set the Plot names so another filter can operate
-    //on the data if needed.
-    current_plot->m_cell_set_name = new_cell_set_name;
+    m_data_sets.push_back(output);
 
+    data.m_eavl_dataset  = output;
+    data.m_cell_set_name = "iso";
+    data.m_color_table   = "blue";
 }
 
 //-----------------------------------------------------------------------------
 void
-EAVLPipeline::CellToNodeFilter(const conduit::Node &node)
+EAVLPipeline::CellToNodeFilter(const conduit::Node &node,
+                               FilterOutput &data)
 {
-    // For now, we assume only a single plot
-    Plot *current_plot = &m_plots[0];
-    
+    //eavls default naming convention
+    string new_var_name;
+    new_var_name = "nodecentered_";
+    new_var_name += data.m_var_name;
+
+    //
+    // Recentering adds a field to the data set. It has no parameters,
+    // so an existing result can be shared.
+    //
+    if(IsDerived(data.m_eavl_dataset, new_var_name))
+    {
+        data.m_var_name = new_var_name;
+        return;
+    }
+
     eavlCellToNodeRecenterMutator cell_to_node;
     try
     {
-        cell_to_node.SetDataSet(current_plot->m_eavl_dataset);
-        cell_to_node.SetField(current_plot->m_var_name);
-        cell_to_node.SetCellSet(current_plot->m_cell_set_name);
+        cell_to_node.SetDataSet(data.m_eavl_dataset);
+        cell_to_node.SetField(data.m_var_name);
+        cell_to_node.SetCellSet(data.m_cell_set_name);
         cell_to_node.Execute();
 
         if(DEBUG)
         {
             ostringstream oss;
-            current_plot->m_eavl_dataset->PrintSummary(oss);
+            data.m_eavl_dataset->PrintSummary(oss);
             STRAWMAN_INFO("Adding CellToNode Filter\n" << oss.str());
         }
 
@@ -2521,63 +2773,40 @@ EAVLPipeline::CellToNodeFilter(const conduit::Node &node)
                        << e.GetErrorText());
     }
 
-    //
-    // Create new plot to replace the current one 
-    //
-    
-    eavlPlot *new_plot = new eavlPlot(current_plot->m_eavl_dataset,
-                                      current_plot->m_cell_set_name);
-
-    new_plot->SetColorTableByName("Spectral");
-    
-    //eavls default naming convention
-    string new_var_name;
-    new_var_name = "nodecentered_";
-    new_var_name += current_plot->m_var_name; 
-    new_plot->SetField(new_var_name);
-    
-    delete current_plot->m_eavl_plot;
-    current_plot->m_eavl_plot = new_plot;
-
-    //
-    // Set the Plot names so another filter can operate
-    // on the data if needed.
-    //
-    current_plot->m_var_name = new_var_name;
-
+    SetDerived(data.m_eavl_dataset, new_var_name);
+    data.m_var_name = new_var_name;
 }
 
 
-
 //-----------------------------------------------------------------------------
 void
 EAVLPipeline::AddPlot(const conduit::Node &action)
 {
-    const std::string field_name = action["field_name"].as_string();
+    //
+    // Plots either consume a named filter or the published mesh with
+    // a field. Plots of a mesh field get their own data set, so filters
+    // without names only change the plot they are applied to.
+    //
+    FilterOutput data;
+    if(action.has_path("input"))
+    {
+        data = EvaluateFilter(action["input"].as_string());
+    }
+    else
+    {
+        data = SourceData(action["field_name"].as_string(), false);
+    }
 
     //
     // Create the plot.
     //
     Plot plot;
-    plot.m_var_name = field_name;
     plot.m_drawn = false;
     plot.m_hidden = false;
-    plot.m_eavl_dataset = DataAdapter::BlueprintToEAVLDataSet(m_data,
-                                                              field_name);
-    plot.m_eavl_plot    = new eavlPlot(plot.m_eavl_dataset,
-                                       plot.m_eavl_dataset->GetCellSet(0)->GetName());
-
-    // we need the topo name ...
-    //const Node &n_field  = m_data["fields"][field_name];
-    //string topo_name     = n_field["topology"].as_string();
-    string topo_name = "cells";
-    
-    
-    plot.m_cell_set_name = topo_name;
+    plot.m_eavl_plot = NULL;
 
     //This will force the plot to get the data extents
-    plot.m_eavl_plot->SetField(field_name.c_str());
-    plot.m_eavl_plot->SetColorTableByName("Spectral");
+    SetPlotData(plot, data);
    
     if(action.has_path("render_options"))
     {
@@ -2594,8 +2823,8 @@ EAVLPipeline::AddPlot(const conduit::Node &action)
         plot.m_eavl_dataset->PrintSummary(oss);
         
         STRAWMAN_INFO("Adding plot " 
-                      << plot.m_eavl_dataset->GetCellSet(0)->GetName()
-                      << " and variable "<< field_name
+                      << plot.m_cell_set_name
+                      << " and variable "<< plot.m_var_name
                       << " " << oss.str());
     }
 
@@ -2618,6 +2847,72 @@ EAVLPipeline::DrawPlots()
     }
 }
 
+//-----------------------------------------------------------------------------
+//
+// Saves the output of a named filter, so extracts can be written without
+// rendering them. The filter is evaluated through the same cache as the
+// plots. Each domain is written as a legacy VTK file named
+// <output_path>_<domain id>.vtk.
+//
+//-----------------------------------------------------------------------------
+void
+EAVLPipeline::Save(const conduit::Node &action)
+{
+    if(!action.has_path("input"))
+    {
+        STRAWMAN_ERROR("EAVL save needs the name of a filter (input)");
+    }
+
+    if(!action.has_path("output_path"))
+    {
+        STRAWMAN_ERROR("EAVL save needs an output_path");
+    }
+
+    FilterOutput data = EvaluateFilter(action["input"].as_string());
+
+    int cell_set_index = -1;
+    for(int i = 0; i < data.m_eavl_dataset->GetNumCellSets(); i++)
+    {
+        if(data.m_eavl_dataset->GetCellSet(i)->GetName() == data.m_cell_set_name)
+        {
+            cell_set_index = i;
+        }
+    }
+
+    if(cell_set_index == -1)
+    {
+        STRAWMAN_ERROR("EAVL save: no cell set named " << data.m_cell_set_name);
+    }
+
+    int domain = 0;
+    if(m_data.has_path("state/domain_id"))
+    {
+        domain = m_data["state/domain_id"].to_int();
+    }
+
+    char domain_buff[32];
+    snprintf(domain_buff, sizeof(domain_buff), "_%06d.vtk", domain);
+    std::string file_name = action["output_path"].as_string() + domain_buff;
+
+    std::ofstream ofs(file_name.c_str());
+    if(!ofs.is_open())
+    {
+        STRAWMAN_ERROR("EAVL save failed to open " << file_name);
+    }
+
+    try
+    {
+        STRAWMAN_BLOCK_TIMER(SAVE);
+        eavlVTKExporter exporter(data.m_eavl_dataset, cell_set_index);
+        exporter.Export(ofs);
+    }
+    catch (const eavlException &e)
+    {
+        STRAWMAN_ERROR("EAVL exception while saving " << file_name << " "
+                       << e.GetErrorText());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 EAVLPipeline::RenderPlot(const int plot_id, conduit::Node &render_options)
@@ -2653,8 +2948,9 @@ EAVLPipeline::RenderPlot(const int plot_id, conduit::Node &render_options)
     //         topological dimension. Cellset dims are topological.
     //         topo dims is how many dims a cell has (e.g., 2 for a triangle and 3 for a tet
     //         render dims is how many axes the coordinates have (e.g., 2 = 2d plot)
-    int topo_dims = m_plots[0].m_eavl_dataset->GetCellSet(m_plots[0].m_cell_set_name)->GetDimensionality();
-    const int render_dims = m_plots[0].m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
+    Plot &plot = m_plots[plot_id];
+    int topo_dims = plot.m_eavl_dataset->GetCellSet(plot.m_cell_set_name)->GetDimensionality();
+    const int render_dims = plot.m_eavl_dataset->GetCoordinateSystem(0)->GetDimension();
 
     if(render_options.has_path("renderer"))
     {
@@ -2716,7 +3012,12 @@ EAVLPipeline::RenderPlot(const int plot_id, conduit::Node &render_options)
     if((m_render_mode == Renderer::OPENGL ||
        m_render_mode == Renderer::RAYTRACER) && topo_dims == 3)
     {
-        ExternalFacesFilter();
+        FilterOutput data = PlotData(plot);
+        ExternalFacesFilter(data);
+        if(data.m_cell_set_name != plot.m_cell_set_name)
+        {
+            SetPlotData(plot, data);
+        }
     }
 
     //
@@ -2737,7 +3038,7 @@ EAVLPipeline::RenderPlot(const int plot_id, conduit::Node &render_options)
     }
   
 
-    m_renderer->Render(m_plots[plot_id].m_eavl_plot,
+    m_renderer->Render(plot.m_eavl_plot,
                        image_width,
                        image_height,
                        m_render_mode,
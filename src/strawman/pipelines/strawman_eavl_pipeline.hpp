@@ -55,6 +55,13 @@
 #include <strawman.hpp>
 #include <strawman_pipeline.hpp>
 
+#include <map>
+#include <set>
+#include <vector>
+
+// eavl forward declarations
+class eavlDataSet;
+
 
 //-----------------------------------------------------------------------------
 // -- begin strawman:: --
@@ -78,6 +85,9 @@ public:
     void  Publish(const conduit::Node &data);
     void  Execute(const conduit::Node &actions);
     
+    // conversions and filter nodes evaluated this cycle
+    void  Info(conduit::Node &out);
+
     void  Cleanup();
 
 private:
@@ -85,22 +95,47 @@ private:
     class DataAdapter;
     class Renderer;
     class Plot;
+    class FilterOutput;
     
     
     // actions
     void            AddPlot(const conduit::Node &options);
+    void            Save(const conduit::Node &options);
     void            DrawPlots();
     void            RenderPlot(const int plot_id, conduit::Node &options);
 
 
     //filters and mutators
     void            AddFilter(const conduit::Node &options);
-    void            BoxFilter(const conduit::Node &options);
-    void            IsosurfaceFilter(const conduit::Node &options);
+    void            ApplyFilter(const conduit::Node &options,
+                                FilterOutput &data);
+    void            BoxFilter(const conduit::Node &options,
+                              FilterOutput &data);
+    void            IsosurfaceFilter(const conduit::Node &options,
+                                     FilterOutput &data);
     // TODO: this should be called Recenter
-    void            CellToNodeFilter(const conduit::Node &options);
-    void            ThresholdFilter(const conduit::Node &options);
-    void            ExternalFacesFilter();
+    void            CellToNodeFilter(const conduit::Node &options,
+                                     FilterOutput &data);
+    void            ThresholdFilter(const conduit::Node &options,
+                                    FilterOutput &data);
+    void            ExternalFacesFilter(FilterOutput &data);
+
+    // named filters form a dag that is evaluated lazily, once per cycle
+    FilterOutput    EvaluateFilter(const std::string &name);
+    FilterOutput    FilterInput(const conduit::Node &options);
+    FilterOutput    SourceData(const std::string &field_name,
+                               bool use_cache);
+
+    // helpers for filter outputs
+    FilterOutput    PlotData(const Plot &plot);
+    void            SetPlotData(Plot &plot,
+                                const FilterOutput &data);
+    FilterOutput    ShallowCopy(const FilterOutput &data);
+    bool            IsDerived(eavlDataSet *data_set,
+                              const std::string &name);
+    void            SetDerived(eavlDataSet *data_set,
+                               const std::string &name);
+    void            ClearCycleData();
 
     // conduit node that (externally) holds the data from the simulation 
     conduit::Node     m_data; 
@@ -108,6 +143,20 @@ private:
     // holds the pipeline's plots
     std::vector<Plot> m_plots;
 
+    // named filter declarations and their cached outputs for this cycle
+    conduit::Node                         m_filters;
+    std::map<std::string, FilterOutput>   m_filter_outputs;
+    std::map<std::string, FilterOutput>   m_source_outputs;
+    std::set<std::string>                 m_evaluating;
+
+    // evaluation counts of this cycle, reported by Info
+    conduit::Node                         m_info;
+
+    // eavl data sets created this cycle, and the cell sets and fields
+    // that filters derived in place in each of them
+    std::vector<eavlDataSet*>                          m_data_sets;
+    std::map<eavlDataSet*, std::set<std::string> >     m_derived_names;
+
     // rendering
     Renderer          *m_renderer;
 
@@ -200,6 +200,45 @@ EmptyPipeline::Execute(const conduit::Node &actions)
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+EmptyPipeline::Info(conduit::Node &out)
+{
+    out.reset();
+
+    if(m_data.has_child("coordsets"))
+    {
+        NodeIterator itr = m_data["coordsets"].children();
+        while(itr.has_next())
+        {
+            const Node &coordset = itr.next();
+            if(coordset.has_child("dims"))
+            {
+                out["mesh/coordsets"][itr.name()]["dims"].set(coordset["dims"]);
+            }
+        }
+    }
+
+    if(m_data.has_child("fields"))
+    {
+        NodeIterator itr = m_data["fields"].children();
+        while(itr.has_next())
+        {
+            const Node &field = itr.next();
+            if(!field.has_child("values"))
+            {
+                continue;
+            }
+            
+            // the first component of multi component fields
+            const Node &values = field["values"].number_of_children() > 0 ?
+                                 field["values"].child(0) : field["values"];
+            out["mesh/fields"][itr.name()]["values"] =
+                (int64) values.dtype().number_of_elements();
+        }
+    }
+}
+
 
 
 
@@ -76,6 +76,9 @@ public:
     void  Publish(const conduit::Node &data);
     void  Execute(const conduit::Node &actions);
     
+    // summary of the published mesh: coordset dims and field sizes
+    void  Info(conduit::Node &out);
+
     void  Cleanup();
 
 private:
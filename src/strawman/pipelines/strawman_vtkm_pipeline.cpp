@@ -176,6 +176,13 @@ VTKMPipeline::Execute(const conduit::Node &actions)
     m_backend->Execute(actions);
 }
 
+//-----------------------------------------------------------------------------
+void
+VTKMPipeline::Info(conduit::Node &out)
+{
+    m_backend->Info(out);
+}
+
 
 
 //-----------------------------------------------------------------------------
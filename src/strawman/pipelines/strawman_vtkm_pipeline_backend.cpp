@@ -57,6 +57,7 @@
 #include <limits.h>
 #include <cstdlib>
 #include <sstream>
+#include <cmath>
 
 // thirdparty includes
 
@@ -65,6 +66,12 @@
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DataSetBuilderRectilinear.h>
 #include <vtkm/rendering/Actor.h>
+#include <vtkm/filter/Clip.h>
+#include <vtkm/filter/ExternalFaces.h>
+#include <vtkm/filter/MarchingCubes.h>
+#include <vtkm/filter/Threshold.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
 
 #ifdef VTKM_CUDA
 #include <vtkm/cont/cuda/ChooseCudaDevice.h>
@@ -72,6 +79,8 @@
 
 // other strawman includes
 #include <strawman_block_timer.hpp>
+#include <strawman_fingerprint.hpp>
+#include <strawman_subsample.hpp>
 
 using namespace std;
 using namespace conduit;
@@ -87,6 +96,80 @@ namespace strawman
 typedef vtkm::cont::DataSet                vtkmDataSet;
 typedef vtkm::rendering::Actor             vtkmActor;
 
+// points per axis of the macrocells used to skip empty space
+static const index_t MACROCELL_SIZE = 8;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// signed distance of each point to a plane, used to slice and clip
+//-----------------------------------------------------------------------------
+class PlaneDistance : public vtkm::worklet::WorkletMapField
+{
+public:
+    typedef void ControlSignature(FieldIn<Vec3>, FieldOut<Scalar>);
+    typedef void ExecutionSignature(_1, _2);
+
+    VTKM_CONT_EXPORT
+    PlaneDistance(const vtkm::Vec<vtkm::Float64,3> &origin,
+                  const vtkm::Vec<vtkm::Float64,3> &normal)
+    : m_origin(origin),
+      m_normal(normal)
+    {}
+
+    template <typename T>
+    VTKM_EXEC_EXPORT
+    void operator()(const vtkm::Vec<T,3> &point,
+                    vtkm::Float64 &distance) const
+    {
+        distance = (point[0] - m_origin[0]) * m_normal[0] +
+                   (point[1] - m_origin[1]) * m_normal[1] +
+                   (point[2] - m_origin[2]) * m_normal[2];
+    }
+
+private:
+    vtkm::Vec<vtkm::Float64,3> m_origin;
+    vtkm::Vec<vtkm::Float64,3> m_normal;
+};
+
+//-----------------------------------------------------------------------------
+// runs a vtkm field filter and maps the plot variable onto its output
+//-----------------------------------------------------------------------------
+template <typename FilterType>
+vtkmDataSet *
+execute_field_filter(FilterType &filter,
+                     const vtkmDataSet &input,
+                     const std::string &field_name,
+                     const std::string &var_name,
+                     const std::string &filter_name)
+{
+    vtkm::filter::ResultDataSet result = filter.Execute(input, field_name);
+
+    if(!result.IsValid())
+    {
+        STRAWMAN_ERROR("VTKm "<< filter_name
+                       << " filter failed on field "<< field_name);
+    }
+
+    if(!filter.MapFieldOntoOutput(result, input.GetField(var_name)))
+    {
+        STRAWMAN_ERROR("VTKm "<< filter_name
+                       << " filter could not map field "<< var_name
+                       << " onto its output");
+    }
+
+    return new vtkmDataSet(result.GetDataSet());
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
 template <class DEVICE_ADAPTOR>
 struct VTKMPipelineBackend<DEVICE_ADAPTOR>::Plot
 {
@@ -94,6 +177,8 @@ struct VTKMPipelineBackend<DEVICE_ADAPTOR>::Plot
     std::string        m_cell_set_name;
     bool               m_drawn;
     bool               m_hidden;
+    bool               m_filtered;
+    conduit::uint64    m_input_key;    // fingerprint of the plot inputs
     vtkmDataSet       *m_data_set;     //typedefs are in renderer TODO: move to typedefs file
     vtkmActor         *m_plot;
     Node               m_render_options;
@@ -677,6 +762,9 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::DataAdapter::AddVariableField
 //-----------------------------------------------------------------------------
 template <class DEVICE_ADAPTOR>
 VTKMPipelineBackend<DEVICE_ADAPTOR>::VTKMPipelineBackend()
+: m_change_detection(false),
+  m_sample_stride(64),
+  m_publish_count(0)
 {
   STRAWMAN_BLOCK_TIMER(CONSTRUCTOR)
 }
@@ -755,6 +843,27 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::Initialize(const conduit::Node &options)
 
 #endif
     
+    m_renderer->SetOptions(options);
+
+    //
+    // With change detection, plots whose inputs and render options
+    // did not change since the last frame reuse the encoded image
+    //
+    if(options.has_path("change_detection/enabled") &&
+       options["change_detection/enabled"].as_string() == "true")
+    {
+        m_change_detection = true;
+    }
+
+    if(options.has_path("change_detection/sample_stride"))
+    {
+        m_sample_stride = options["change_detection/sample_stride"].to_int64();
+        if(m_sample_stride < 1)
+        {
+            STRAWMAN_WARN("change_detection/sample_stride must be at least 1,"
+                          " got " << m_sample_stride);
+        }
+    }
 }
 
 
@@ -780,6 +889,8 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::Publish(const conduit::Node &data)
      delete m_plots[i].m_plot; 
     }
     m_plots.clear();
+    m_fingerprints.clear();
+    m_publish_count++;
     m_data.set_external(data);
 }
 
@@ -788,6 +899,8 @@ template <class DEVICE_ADAPTOR>
 void
 VTKMPipelineBackend<DEVICE_ADAPTOR>::Execute(const conduit::Node &actions)
 {
+    m_info.reset();
+
     //
     // Loop over the actions
     //
@@ -809,11 +922,11 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::Execute(const conduit::Node &actions)
         }
         else if (action["action"].as_string() == "add_filter")
         {
-            STRAWMAN_INFO("VTKm add_filter not implemented");
+            AddFilter(action);
         }
         else if (action["action"].as_string() == "draw_plots")
         {
-            DrawPlots();
+            DrawPlots(action);
         }
         else
         {
@@ -821,6 +934,14 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::Execute(const conduit::Node &actions)
         }
    }
 }
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::Info(conduit::Node &out)
+{
+    out.set(m_info);
+}
 //-----------------------------------------------------------------------------
 template <class DEVICE_ADAPTOR>
 void
@@ -836,6 +957,8 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::AddPlot(const conduit::Node &action)
     plot.m_var_name = field_name;
     plot.m_drawn = false;
     plot.m_hidden = false;
+    plot.m_filtered = false;
+    plot.m_input_key = 0;
     plot.m_data_set = DataAdapter::BlueprintToVTKmDataSet(m_data,field_name);
     
     // we need the topo name ...
@@ -867,15 +990,646 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::AddPlot(const conduit::Node &action)
     {
         STRAWMAN_ERROR("AddPlot Got the unexpected error: " << error.GetMessage() << std::endl);
     }
+
+    if(m_change_detection)
+    {
+        plot.m_input_key = FieldFingerprint(field_name);
+    }
+
     m_plots.push_back(plot);
     
 }
 
+//-----------------------------------------------------------------------------
+//
+// Filters reduce the data set of a plot before it is rendered, so ray
+// tracing and compositing costs scale with the extract rather than the
+// full mesh. Filters can be chained. As in the EAVL pipeline, a filter
+// is applied to the first plot unless it selects one with ``plot``.
+//
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::AddFilter(const conduit::Node &action)
+{
+    if(m_plots.size() < 1)
+    {
+        STRAWMAN_ERROR("There must be a least one plot to add a filter.");
+    }
+
+    int plot_id = 0;
+    if(action.has_path("plot"))
+    {
+        plot_id = action["plot"].to_int();
+    }
+
+    if(plot_id < 0 || plot_id >= (int)m_plots.size())
+    {
+        STRAWMAN_ERROR("Filter plot " << plot_id << " does not exist, "
+                       << m_plots.size() << " plots were added");
+    }
+
+    Plot &plot = m_plots[plot_id];
+    const std::string filter_type = action["type"].as_string();
+
+    if(m_change_detection)
+    {
+        // the filter and its parameters are plot inputs, as is the
+        // data of a filter field other than the plot variable
+        plot.m_input_key = combine_fingerprints(plot.m_input_key,
+                                                data_fingerprint(action));
+        if(action.has_path("field_name") &&
+           m_data.has_path("fields/" + action["field_name"].as_string()))
+        {
+            plot.m_input_key = combine_fingerprints(plot.m_input_key,
+                                                    FieldFingerprint(action["field_name"].as_string()));
+        }
+    }
+
+    try
+    {
+        if(filter_type == "threshold_filter")
+        {
+            ThresholdFilter(plot, action);
+        }
+        else if(filter_type == "isosurface_filter")
+        {
+            IsosurfaceFilter(plot, action);
+        }
+        else if(filter_type == "slice_filter")
+        {
+            SliceFilter(plot, action);
+        }
+        else if(filter_type == "clip_filter")
+        {
+            ClipFilter(plot, action);
+        }
+        else if(filter_type == "external_faces_filter")
+        {
+            ExternalFacesFilter(plot);
+        }
+        else
+        {
+            STRAWMAN_INFO( "Warning: Unknown filter type "
+                           << filter_type
+                           <<" Filter not applied.");
+            action.print();
+        }
+    }
+    catch (vtkm::cont::Error error)
+    {
+        STRAWMAN_ERROR("AddFilter ("<< filter_type << ") got the unexpected error: "
+                       << error.GetMessage() << std::endl);
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::ThresholdFilter(Plot &plot,
+                                                     const conduit::Node &action)
+{
+    STRAWMAN_BLOCK_TIMER(THRESHOLD);
+
+    const std::string field_name = FilterFieldName(plot, action);
+
+    vtkm::filter::Threshold thresholder;
+    thresholder.SetLowerThreshold(action["min_value"].to_float64());
+    thresholder.SetUpperThreshold(action["max_value"].to_float64());
+
+    SetPlotDataSet(plot, detail::execute_field_filter(thresholder,
+                                                      *plot.m_data_set,
+                                                      field_name,
+                                                      plot.m_var_name,
+                                                      "threshold"));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::IsosurfaceFilter(Plot &plot,
+                                                      const conduit::Node &action)
+{
+    STRAWMAN_BLOCK_TIMER(ISOSURFACE);
+
+    const std::string field_name = FilterFieldName(plot, action);
+
+    if(plot.m_data_set->GetField(field_name).GetAssociation() !=
+       vtkm::cont::Field::ASSOC_POINTS)
+    {
+        STRAWMAN_ERROR("VTKm isosurface filter requires a vertex "
+                       "associated field: "<< field_name);
+    }
+
+    vtkm::filter::MarchingCubes iso;
+    iso.SetIsoValue(action["iso_value"].to_float64());
+
+    SetPlotDataSet(plot, detail::execute_field_filter(iso,
+                                                      *plot.m_data_set,
+                                                      field_name,
+                                                      plot.m_var_name,
+                                                      "isosurface"));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::SliceFilter(Plot &plot,
+                                                 const conduit::Node &action)
+{
+    STRAWMAN_BLOCK_TIMER(SLICE);
+
+    //
+    // A slice is the zero isosurface of the distance to the plane
+    //
+    const std::string field_name = "strawman_slice_distance";
+    AddPlaneDistanceField(plot.m_data_set, action, field_name);
+
+    vtkm::filter::MarchingCubes slicer;
+    slicer.SetIsoValue(0.0);
+
+    SetPlotDataSet(plot, detail::execute_field_filter(slicer,
+                                                      *plot.m_data_set,
+                                                      field_name,
+                                                      plot.m_var_name,
+                                                      "slice"));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::ClipFilter(Plot &plot,
+                                                const conduit::Node &action)
+{
+    STRAWMAN_BLOCK_TIMER(CLIP);
+
+    //
+    // Clip either by a plane (keeping the side the normal points to)
+    // or by a field value.
+    //
+    std::string field_name;
+    float64 clip_value = 0.0;
+
+    if(action.has_path("normal"))
+    {
+        field_name = "strawman_clip_distance";
+        AddPlaneDistanceField(plot.m_data_set, action, field_name);
+    }
+    else
+    {
+        field_name = FilterFieldName(plot, action);
+        clip_value = action["clip_value"].to_float64();
+    }
+
+    if(plot.m_data_set->GetField(field_name).GetAssociation() !=
+       vtkm::cont::Field::ASSOC_POINTS)
+    {
+        STRAWMAN_ERROR("VTKm clip filter requires a vertex "
+                       "associated field: "<< field_name);
+    }
+
+    vtkm::filter::Clip clipper;
+    clipper.SetClipValue(clip_value);
+
+    SetPlotDataSet(plot, detail::execute_field_filter(clipper,
+                                                      *plot.m_data_set,
+                                                      field_name,
+                                                      plot.m_var_name,
+                                                      "clip"));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::ExternalFacesFilter(Plot &plot)
+{
+    STRAWMAN_BLOCK_TIMER(EXTERNAL_FACES);
+
+    vtkm::filter::ExternalFaces facer;
+    vtkm::filter::ResultDataSet result = facer.Execute(*plot.m_data_set);
+
+    if(!result.IsValid())
+    {
+        STRAWMAN_ERROR("VTKm external faces filter failed");
+    }
+
+    if(!facer.MapFieldOntoOutput(result,
+                                 plot.m_data_set->GetField(plot.m_var_name)))
+    {
+        STRAWMAN_ERROR("VTKm external faces filter could not map field "
+                       << plot.m_var_name << " onto its output");
+    }
+
+    SetPlotDataSet(plot, new vtkmDataSet(result.GetDataSet()));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+std::string
+VTKMPipelineBackend<DEVICE_ADAPTOR>::FilterFieldName(const Plot &plot,
+                                                     const conduit::Node &action)
+{
+    //
+    // Filters operate on the plot variable unless a field is given
+    //
+    if(!action.has_path("field_name"))
+    {
+        return plot.m_var_name;
+    }
+
+    const std::string field_name = action["field_name"].as_string();
+
+    if(field_name != plot.m_var_name)
+    {
+        if(!m_data.has_path("fields/" + field_name))
+        {
+            STRAWMAN_ERROR("Filter field "<< field_name << " does not exist");
+        }
+
+        // fields are only added to the data set as filters need them, and
+        // only the original mesh can accept published fields
+        if(plot.m_filtered)
+        {
+            STRAWMAN_ERROR("Filter field "<< field_name << " must be the"
+                           " plot variable after the plot has been filtered");
+        }
+
+        const Node &n_field = m_data["fields"][field_name];
+        int num_values = n_field["values"].dtype().number_of_elements();
+        DataAdapter::AddVariableField(field_name,
+                                      n_field,
+                                      plot.m_cell_set_name,
+                                      num_values,
+                                      num_values,
+                                      plot.m_data_set);
+    }
+
+    return field_name;
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::AddPlaneDistanceField(vtkmDataSet *data_set,
+                                                           const conduit::Node &action,
+                                                           const std::string &field_name)
+{
+    Node n_origin;
+    Node n_normal;
+    action["origin"].to_float64_array(n_origin);
+    action["normal"].to_float64_array(n_normal);
+
+    if(n_origin.dtype().number_of_elements() != 3 ||
+       n_normal.dtype().number_of_elements() != 3)
+    {
+        STRAWMAN_ERROR("Plane origin and normal must have three components");
+    }
+
+    const float64 *origin_ptr = n_origin.as_float64_ptr();
+    const float64 *normal_ptr = n_normal.as_float64_ptr();
+
+    float64 mag = sqrt(normal_ptr[0] * normal_ptr[0] +
+                       normal_ptr[1] * normal_ptr[1] +
+                       normal_ptr[2] * normal_ptr[2]);
+    if(mag == 0.0)
+    {
+        STRAWMAN_ERROR("Plane normal must not be zero");
+    }
+
+    vtkm::Vec<vtkm::Float64,3> origin(origin_ptr[0],
+                                      origin_ptr[1],
+                                      origin_ptr[2]);
+    vtkm::Vec<vtkm::Float64,3> normal(normal_ptr[0] / mag,
+                                      normal_ptr[1] / mag,
+                                      normal_ptr[2] / mag);
+
+    vtkm::cont::ArrayHandle<vtkm::Float64> distance;
+    vtkm::worklet::DispatcherMapField<detail::PlaneDistance, DEVICE_ADAPTOR>
+        dispatcher(detail::PlaneDistance(origin, normal));
+    dispatcher.Invoke(data_set->GetCoordinateSystem().GetData(), distance);
+
+    data_set->AddField(vtkm::cont::Field(field_name,
+                                         vtkm::cont::Field::ASSOC_POINTS,
+                                         distance));
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+void
+VTKMPipelineBackend<DEVICE_ADAPTOR>::SetPlotDataSet(Plot &plot,
+                                                    vtkmDataSet *data_set)
+{
+    //
+    // Replace the plot's data set and actor with the filter output
+    //
+    delete plot.m_plot;
+    delete plot.m_data_set;
+
+    plot.m_data_set      = data_set;
+    plot.m_cell_set_name = data_set->GetCellSet(0).GetName();
+    plot.m_filtered      = true;
+
+    vtkm::rendering::ColorTable color_table("Spectral");
+    plot.m_plot = new vtkmActor(data_set->GetCellSet(0),
+                                data_set->GetCoordinateSystem(),
+                                data_set->GetField(plot.m_var_name),
+                                color_table);
+}
+
+//-----------------------------------------------------------------------------
+//
+// The volume renderer marches every ray through the whole data set with a
+// fixed step. For vertex fields on uniform and rectilinear meshes we size
+// the step from the cell spacing, and use a macrocell min/max grid with the
+// transfer function opacity to crop the data set to the part that is not
+// fully transparent.
+//
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+vtkmActor *
+VTKMPipelineBackend<DEVICE_ADAPTOR>::PrepareVolumePlot(Plot &plot,
+                                                       const conduit::Node &render_options,
+                                                       vtkmDataSet *&data_set)
+{
+    data_set = NULL;
+
+    if(plot.m_filtered)
+    {
+        return plot.m_plot;
+    }
+
+    if(render_options.has_path("sampling"))
+    {
+        const std::string sampling = render_options["sampling"].as_string();
+        if(sampling == "fixed")
+        {
+            return plot.m_plot;
+        }
+        else if(sampling != "adaptive")
+        {
+            STRAWMAN_WARN("VTK-m Pipeline: unknown volume sampling " << sampling
+                          << " (expected adaptive or fixed)");
+        }
+    }
+
+    const std::string &field_name = plot.m_var_name;
+    const Node &n_field  = m_data["fields"][field_name];
+    const std::string topo_name   = n_field["topology"].as_string();
+    const Node &n_topo   = m_data["topologies"][topo_name];
+    const std::string topo_type   = n_topo["type"].as_string();
+    const std::string coords_name = n_topo["coordset"].as_string();
+    const Node &n_coords = m_data["coordsets"][coords_name];
+    const Node &n_values = n_field["values"];
+
+    //
+    // The opacity table below reduces over all ranks, so every rank has
+    // to take the same path
+    //
+    bool supported = (topo_type == "uniform" || topo_type == "rectilinear") &&
+                     n_field["association"].as_string() == "vertex" &&
+                     n_values.number_of_children() == 0;
+
+    if(!m_renderer->AllRanks(supported))
+    {
+        return plot.m_plot;
+    }
+
+    //
+    // Points per axis and the smallest cell spacing
+    //
+    const char *dim_names[3]     = {"i", "j", "k"};
+    const char *axis_names[3]    = {"x", "y", "z"};
+    const char *spacing_names[3] = {"dx", "dy", "dz"};
+
+    index_t dims[3] = {1, 1, 1};
+    float64 min_spacing = 0.0;
+    for(int a = 0; a < 3; a++)
+    {
+        float64 spacing = 0.0;
+        if(topo_type == "uniform")
+        {
+            if(!n_coords.has_path(std::string("dims/") + dim_names[a]))
+            {
+                continue;
+            }
+            dims[a] = n_coords["dims"][dim_names[a]].to_index_t();
+            spacing = 1.0;
+            if(n_coords.has_path(std::string("spacing/") + spacing_names[a]))
+            {
+                spacing = n_coords["spacing"][spacing_names[a]].to_float64();
+            }
+        }
+        else
+        {
+            if(!n_coords.has_path(std::string("values/") + axis_names[a]))
+            {
+                continue;
+            }
+            Node n_axis;
+            n_coords["values"][axis_names[a]].to_float64_array(n_axis);
+            const float64 *axis = n_axis.as_float64_ptr();
+            dims[a] = n_axis.dtype().number_of_elements();
+            for(index_t i = 1; i < dims[a]; i++)
+            {
+                float64 delta = fabs(axis[i] - axis[i - 1]);
+                if(spacing == 0.0 || (delta > 0.0 && delta < spacing))
+                {
+                    spacing = delta;
+                }
+            }
+        }
+
+        spacing = fabs(spacing);
+        if(dims[a] > 1 && spacing > 0.0 && 
+           (min_spacing == 0.0 || spacing < min_spacing))
+        {
+            min_spacing = spacing;
+        }
+    }
+
+    // two samples per cell
+    m_renderer->SetVolumeSampleDistance(0.5f * min_spacing);
+
+    //
+    // (Re)build the macrocell grid when the field changed. Without a
+    // generation counter we only reuse the field hash change detection
+    // already computed, otherwise we rebuild once per publish, which
+    // takes a single pass over the field like hashing it would.
+    //
+    conduit::uint64 key = 0;
+    if(m_data.has_path("state/generation"))
+    {
+        key = m_data["state/generation"].to_uint64();
+    }
+    else if(m_change_detection)
+    {
+        key = Fingerprint("fields/" + field_name);
+    }
+    else
+    {
+        key = m_publish_count;
+    }
+
+    for(int a = 0; a < 3; a++)
+    {
+        key = combine_fingerprints(key, dims[a]);
+    }
+
+    MacrocellGrid &grid = m_macrocell_grids[field_name];
+    if(grid.Empty() || grid.Key() != key)
+    {
+        grid.Build(n_values, dims, MACROCELL_SIZE, key);
+    }
+
+    std::vector<float> opacity;
+    float64 range_min = 0.0;
+    float64 range_max = 0.0;
+    m_renderer->OpacityTable(plot.m_plot, 256, opacity, range_min, range_max);
+
+    index_t start[3];
+    index_t end[3];
+    index_t num_visible = grid.VisibleExtent(opacity,
+                                             range_min,
+                                             range_max,
+                                             start,
+                                             end);
+
+    // nothing to skip, or nothing visible on this rank
+    if(num_visible == 0 || num_visible == grid.NumberOfMacrocells())
+    {
+        return plot.m_plot;
+    }
+
+    bool cropped = false;
+    for(int a = 0; a < 3; a++)
+    {
+        if(start[a] > 0 || end[a] < dims[a])
+        {
+            cropped = true;
+        }
+    }
+
+    if(!cropped)
+    {
+        return plot.m_plot;
+    }
+
+    STRAWMAN_BLOCK_TIMER(VOLUME_CROP);
+
+    Node crop_opts;
+    crop_opts["stride"]   = 1;
+    crop_opts["topology"] = topo_name;
+    crop_opts["fields"]   = field_name;
+    crop_opts["extent/start"].set(start, 3);
+    crop_opts["extent/end"].set(end, 3);
+
+    // VTK-m arrays point into the cropped mesh, so it is a member
+    subsample_mesh(m_data, crop_opts, m_volume_data);
+
+    STRAWMAN_INFO("VTK-m Pipeline: volume of " << field_name << " cropped to "
+                  << num_visible << " of " << grid.NumberOfMacrocells()
+                  << " macrocells");
+
+    data_set = DataAdapter::BlueprintToVTKmDataSet(m_volume_data, field_name);
+
+    int cell_set_index = data_set->GetCellSetIndex(topo_name);
+    vtkmActor *actor = new vtkmActor(data_set->GetCellSet(cell_set_index),
+                                     data_set->GetCoordinateSystem(),
+                                     data_set->GetField(field_name),
+                                     plot.m_plot->ColorTable);
+
+    // keep the colors and the default camera of the full data set
+    actor->ScalarRange   = plot.m_plot->ScalarRange;
+    actor->SpatialBounds = plot.m_plot->SpatialBounds;
+
+    return actor;
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+conduit::uint64
+VTKMPipelineBackend<DEVICE_ADAPTOR>::Fingerprint(const std::string &path)
+{
+    //
+    // Plots often share a topology and coordset, so we only hash them
+    // once per publish
+    //
+    std::map<std::string, conduit::uint64>::iterator itr = m_fingerprints.find(path);
+    if(itr != m_fingerprints.end())
+    {
+        return itr->second;
+    }
+
+    STRAWMAN_BLOCK_TIMER(FINGERPRINT);
+
+    //
+    // When the simulation provides a generation counter, it tells us
+    // when the data changes and a sampled hash is enough to catch the
+    // generation not being advanced.
+    //
+    conduit::index_t stride = 1;
+    if(m_data.has_path("state/generation"))
+    {
+        stride = m_sample_stride;
+    }
+
+    conduit::uint64 hash = content_fingerprint(m_data[path], stride);
+    m_fingerprints[path] = hash;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+template <class DEVICE_ADAPTOR>
+conduit::uint64
+VTKMPipelineBackend<DEVICE_ADAPTOR>::FieldFingerprint(const std::string &field_name)
+{
+    const Node &n_field = m_data["fields"][field_name];
+    string topo_name    = n_field["topology"].as_string();
+    string coords_name  = m_data["topologies"][topo_name]["coordset"].as_string();
+
+    conduit::uint64 hash = 0;
+    if(m_data.has_path("state/generation"))
+    {
+        hash = m_data["state/generation"].to_uint64();
+    }
+
+    hash = combine_fingerprints(hash, Fingerprint("fields/" + field_name));
+    hash = combine_fingerprints(hash, Fingerprint("topologies/" + topo_name));
+    hash = combine_fingerprints(hash, Fingerprint("coordsets/" + coords_name));
+    return hash;
+}
+
 //-----------------------------------------------------------------------------
 template <class DEVICE_ADAPTOR>
 void 
-VTKMPipelineBackend<DEVICE_ADAPTOR>::DrawPlots()
+VTKMPipelineBackend<DEVICE_ADAPTOR>::DrawPlots(const conduit::Node &action)
 {
+    //
+    // The optional budget covers all plots, the renderer lowers the
+    // quality of each plot to stay within its share
+    //
+    float budget_ms = 0.0f;
+    if(action.has_path("budget_ms"))
+    {
+        budget_ms = action["budget_ms"].to_float32();
+
+        int num_visible = 0;
+        for (int i = 0; i < m_plots.size(); ++i)
+        {
+            if(!m_plots[i].m_hidden)
+            {
+                num_visible++;
+            }
+        }
+
+        if(num_visible > 1)
+        {
+            budget_ms /= num_visible;
+        }
+    }
+
+    m_renderer->SetRenderBudget(budget_ms);
+
     for (int i = 0; i < m_plots.size(); ++i)
     {
         if(!m_plots[i].m_hidden)
@@ -940,6 +1694,16 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::RenderPlot(const int plot_id,
     {
         m_render_mode = RAYTRACER;
     }
+
+    //
+    // Filter outputs are unstructured, which only the ray tracer supports
+    //
+    if(m_render_mode == VOLUME && m_plots[plot_id].m_filtered)
+    {
+        STRAWMAN_INFO("VTK-m Pipeline: volume rendering of a filtered"
+                      " plot is not supported, using the ray tracer");
+        m_render_mode = RAYTRACER;
+    }
     
     const char *image_file_name = NULL;
     //
@@ -955,6 +1719,32 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::RenderPlot(const int plot_id,
         options["web/stream"] = "true";
         m_renderer->SetOptions(options);
     }
+
+    //
+    // Full resolution images are only rendered on the cycles selected
+    // by save_every. On the other cycles we only stream a (low res)
+    // preview to the web client, or skip the plot if nobody is watching.
+    //
+    if(image_file_name != NULL && render_options.has_path("save_every"))
+    {
+        int save_every = render_options["save_every"].to_int();
+        int cycle      = 0;
+
+        if(m_data.has_path("state/cycle"))
+        {
+            cycle = m_data["state/cycle"].to_int();
+        }
+
+        if(save_every > 1 && (cycle % save_every) != 0)
+        {
+            if(!m_renderer->WebStreamEnabled())
+            {
+                return;
+            }
+
+            image_file_name = NULL;
+        }
+    }
     
     //
     //    Check for camera attributes
@@ -972,13 +1762,92 @@ VTKMPipelineBackend<DEVICE_ADAPTOR>::RenderPlot(const int plot_id,
         m_renderer->SetTransferFunction(render_options.fetch("color_map"));
     }
     int dims = 3;
+
+    //
+    // Volume plots of uniform and rectilinear meshes may render a 
+    // cropped data set that leaves out transparent space
+    //
+    vtkmActor   *render_plot  = m_plots[plot_id].m_plot;
+    vtkmDataSet *cropped_data = NULL;
+    m_renderer->SetVolumeSampleDistance(0.0f);
+    if(m_render_mode == VOLUME)
+    {
+        render_plot = PrepareVolumePlot(m_plots[plot_id],
+                                        render_options,
+                                        cropped_data);
+    }
+
+    //
+    // The frame key covers the plot inputs and render options. The file
+    // name changes every cycle but not the image, so it is left out.
+    //
+    conduit::uint64 frame_key = 0;
+    if(m_change_detection)
+    {
+        conduit::Node image_options;
+        image_options.set(render_options);
+        if(image_options.has_child("file_name"))
+        {
+            image_options.remove("file_name");
+        }
+        if(image_options.has_child("save_every"))
+        {
+            image_options.remove("save_every");
+        }
+
+        frame_key = combine_fingerprints(m_plots[plot_id].m_input_key,
+                                         data_fingerprint(image_options));
+        frame_key = combine_fingerprints(frame_key, m_render_mode);
+    }
     
-    m_renderer->Render(m_plots[plot_id].m_plot,
-                       image_height,
-                       image_width,
-                       m_render_mode,
-                       dims,
-                       image_file_name);
+    //
+    // Pseudocolor plots of 2D uniform and rectilinear meshes are mapped
+    // straight to pixels, unless the render options ask for the ray tracer
+    //
+    bool rendered = false;
+    if(m_render_mode == RAYTRACER && 
+       !m_plots[plot_id].m_filtered &&
+       !(render_options.has_path("raster_2d") && 
+         render_options["raster_2d"].as_string() == "false"))
+    {
+        rendered = m_renderer->Render2D(render_plot,
+                                        m_data,
+                                        m_plots[plot_id].m_var_name,
+                                        image_height,
+                                        image_width,
+                                        image_file_name,
+                                        frame_key);
+    }
+
+    if(!rendered)
+    {
+        m_renderer->Render(render_plot,
+                           image_height,
+                           image_width,
+                           m_render_mode,
+                           dims,
+                           image_file_name,
+                           frame_key);
+    }
+
+    Node &frame_info = m_info["renders"].append();
+    m_renderer->FrameInfo(frame_info);
+    frame_info["plot"] = plot_id;
+    // cells of the (filtered) plot data set, before any volume cropping
+    const Plot &plot = m_plots[plot_id];
+    int cell_set_index = plot.m_data_set->GetCellSetIndex(plot.m_cell_set_name);
+    frame_info["cells"] = (conduit::uint64)
+        plot.m_data_set->GetCellSet(cell_set_index).GetNumberOfCells();
+    if(image_file_name != NULL)
+    {
+        frame_info["file_name"] = image_file_name;
+    }
+
+    if(cropped_data != NULL)
+    {
+        delete render_plot;
+        delete cropped_data;
+    }
 }
 
 };
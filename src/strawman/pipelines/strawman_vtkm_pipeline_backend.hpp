@@ -53,6 +53,7 @@
 #define STRAWMAN_VTKM_PIPELINE_BACKEND_HPP
 
 #include "strawman_pipeline.hpp"
+#include "strawman_macrocell_grid.hpp"
 
 
 // thirdparty includes
@@ -64,11 +65,17 @@ namespace cont
 {
 class DataSet;
 };
+namespace rendering
+{
+class Actor;
+};
 };
 
 // conduit includes
 #include <conduit.hpp>
 
+#include <map>
+
 
 //-----------------------------------------------------------------------------
 // -- begin strawman:: --
@@ -95,6 +102,7 @@ public:
 
     void  Publish(const conduit::Node &data);
     void  Execute(const conduit::Node &actions);
+    void  Info(conduit::Node &out);
     
     void  Cleanup();
 
@@ -115,6 +123,13 @@ public:
     static vtkm::cont::DataSet  *BlueprintToVTKmDataSet(const conduit::Node &n,
                                                         const std::string &field_name);
 
+    // helper for adding field data
+    static void                  AddVariableField(const std::string &field_name,
+                                                  const conduit::Node &n_field,
+                                                  const std::string &topo_name,
+                                                  int neles,
+                                                  int nverts,
+                                                  vtkm::cont::DataSet *dset);
 
 private:
     // helpers for specific conversion cases
@@ -147,14 +162,6 @@ private:
                                                                     int &neles,
                                                                     int &nverts);
 
-    // helper for adding field data
-    static void                  AddVariableField(const std::string &field_name,
-                                                  const conduit::Node &n_field,
-                                                  const std::string &topo_name,
-                                                  int neles,
-                                                  int nverts,
-                                                  vtkm::cont::DataSet *dset);
-
 };
 
 private:
@@ -163,20 +170,65 @@ private:
     //class Renderer;
 
     // Actions
-    void            DrawPlots();
+    void            DrawPlots(const conduit::Node &action);
     void            RenderPlot(const int plot_id,
                                const conduit::Node &render_options);
     // conduit node that (externally) holds the data from the simulation 
     conduit::Node     m_data; 
 
+    // the frames rendered by the last Execute
+    conduit::Node     m_info;
+
     // holds the pipeline's plots
     std::vector<Plot> m_plots;
 
     Renderer<DEVICE_ADAPTOR> *m_renderer;
 
+    // change detection, which lets the renderer reuse unchanged frames
+    bool                 m_change_detection;
+    conduit::index_t     m_sample_stride;
+    std::map<std::string, conduit::uint64> m_fingerprints;
+    conduit::uint64      m_publish_count;
+
+    // empty space skipping for volume plots, by field name. Grids are
+    // kept across publishes and only rebuilt when the field changes.
+    std::map<std::string, MacrocellGrid>   m_macrocell_grids;
+    // cropped mesh of the volume plot being rendered
+    conduit::Node                          m_volume_data;
+
     int cuda_device;
     // actions
     void            AddPlot(const conduit::Node &action);
+    void            AddFilter(const conduit::Node &action);
+
+    // filters, which replace the data set of the most recent plot
+    void            ThresholdFilter(Plot &plot,
+                                    const conduit::Node &action);
+    void            IsosurfaceFilter(Plot &plot,
+                                     const conduit::Node &action);
+    void            SliceFilter(Plot &plot,
+                                const conduit::Node &action);
+    void            ClipFilter(Plot &plot,
+                               const conduit::Node &action);
+    void            ExternalFacesFilter(Plot &plot);
+
+    // filter helpers
+    std::string     FilterFieldName(const Plot &plot,
+                                    const conduit::Node &action);
+    void            AddPlaneDistanceField(vtkm::cont::DataSet *data_set,
+                                          const conduit::Node &action,
+                                          const std::string &field_name);
+    void            SetPlotDataSet(Plot &plot,
+                                   vtkm::cont::DataSet *data_set);
+
+    // volume plot helper, returns the actor to render
+    vtkm::rendering::Actor *PrepareVolumePlot(Plot &plot,
+                                              const conduit::Node &render_options,
+                                              vtkm::cont::DataSet *&data_set);
+
+    // change detection helpers
+    conduit::uint64 Fingerprint(const std::string &path);
+    conduit::uint64 FieldFingerprint(const std::string &field_name);
 };
 
 //-----------------------------------------------------------------------------
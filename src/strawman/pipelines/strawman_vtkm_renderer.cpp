@@ -55,15 +55,116 @@
 #include <limits.h>
 #include <cstdlib>
 #include <sstream>
+#include <algorithm>
 
 // other strawman includes
 #include <strawman_block_timer.hpp>
+#include <strawman_fingerprint.hpp>
 #include <strawman_png_encoder.hpp>
+#include <strawman_raster_2d.hpp>
 #include <strawman_web_interface.hpp>
 
 using namespace std;
 using namespace conduit;
 namespace strawman {
+
+// number of encoded frames kept for change detection
+static const size_t FRAME_CACHE_SIZE = 16;
+
+//-----------------------------------------------------------------------------
+// Quality levels used to stay within a render budget, from full quality
+// down. Each level scales the image size and the volume sample count, and
+// the lowest levels composite 8-bit instead of float colors.
+//-----------------------------------------------------------------------------
+static const int   NUM_QUALITY_LEVELS = 5;
+static const float QUALITY_IMAGE_SCALE[NUM_QUALITY_LEVELS]    = {1.0f, 0.75f, 0.5f, 0.35f, 0.25f};
+static const float QUALITY_VOLUME_SAMPLES[NUM_QUALITY_LEVELS] = {200.f, 150.f, 100.f, 64.f, 32.f};
+static const int   QUALITY_UBYTE_COMPOSITE = 3;
+// number of recent frames the cost estimate is based on
+static const size_t FRAME_COST_HISTORY = 8;
+
+//-----------------------------------------------------------------------------
+// Direct 2D pseudocolor renders sample the color table into a lookup
+// table, and frame the bounds like the default 2D camera view
+// (tan(64 deg) * tan(30 deg), from the camera distance and field of view).
+//-----------------------------------------------------------------------------
+static const int     RASTER_2D_LUT_SIZE = 1024;
+static const float64 RASTER_2D_MARGIN   = 1.18;
+
+//-----------------------------------------------------------------------------
+// relative cost of a quality level, paint and composite time scale with
+// the number of pixels and the number of volume samples
+//-----------------------------------------------------------------------------
+static double
+QualityCostFactor(int level, RendererType type)
+{
+    double scale  = QUALITY_IMAGE_SCALE[level];
+    double factor = scale * scale;
+    if(type == VOLUME)
+    {
+        factor *= QUALITY_VOLUME_SAMPLES[level] / QUALITY_VOLUME_SAMPLES[0];
+    }
+    return factor;
+}
+
+//-----------------------------------------------------------------------------
+// milliseconds the last frame spent painting and compositing, as measured
+// by the RENDER_PAINT and RENDER_COMPOSITE block timers
+//-----------------------------------------------------------------------------
+static double
+FrameMilliseconds()
+{
+    double seconds = BlockTimer::LastElapsed("RENDER_PAINT");
+#ifdef PARALLEL
+    seconds += BlockTimer::LastElapsed("RENDER_COMPOSITE");
+#endif
+    return seconds * 1000.0;
+}
+
+//-----------------------------------------------------------------------------
+// nearest neighbor upscale of an rgba image rendered at a reduced size, 
+// so saved and streamed images keep the requested size
+//-----------------------------------------------------------------------------
+template<typename T>
+static const T *
+UpscaleImage(const T *rgba_in,
+             int in_width,
+             int in_height,
+             int width,
+             int height,
+             std::vector<T> &rgba_out)
+{
+    if(in_width == width && in_height == height)
+    {
+        return rgba_in;
+    }
+
+    rgba_out.resize(4 * width * height);
+
+    std::vector<int> src_offset(width);
+    for(int x = 0; x < width; x++)
+    {
+        src_offset[x] = 4 * std::min(in_width - 1, (x * in_width) / width);
+    }
+
+    for(int y = 0; y < height; y++)
+    {
+        int src_y = std::min(in_height - 1, (y * in_height) / height);
+        const T *src_row = rgba_in + 4 * in_width * src_y;
+        T *dst_row = &rgba_out[4 * width * y];
+        for(int x = 0; x < width; x++)
+        {
+            const T *src = src_row + src_offset[x];
+            dst_row[4 * x + 0] = src[0];
+            dst_row[4 * x + 1] = src[1];
+            dst_row[4 * x + 2] = src[2];
+            dst_row[4 * x + 3] = src[3];
+        }
+    }
+
+    return &rgba_out[0];
+}
+
 //-----------------------------------------------------------------------------
 // Renderer public methods
 //-----------------------------------------------------------------------------
@@ -109,6 +210,11 @@ Renderer<DeviceAdapter>::Init()
     m_bg_color.Components[3] = 1.0f;
 
     m_web_stream_enabled = false;
+    m_web_preview_scale  = 1.0f;
+
+    m_render_budget = 0.0f;
+    m_quality_level = 0;
+    m_volume_sample_distance = 0.0f;
 }
 
 //-----------------------------------------------------------------------------
@@ -514,7 +620,178 @@ Renderer<DeviceAdapter>::SetOptions(const Node &options)
         m_web_stream_enabled = true;
     }
     
-    
+    // fraction of the image size used for frames that are only streamed
+    if(options.has_path("web/preview_scale"))
+    {
+        m_web_preview_scale = options["web/preview_scale"].to_float32();
+        if(m_web_preview_scale <= 0.0f || m_web_preview_scale > 1.0f)
+        {
+            STRAWMAN_WARN("web/preview_scale must be in (0,1], got "
+                          << m_web_preview_scale << ". Using 1.0");
+            m_web_preview_scale = 1.0f;
+        }
+    }
+
+    // frame rate and image size requested for the web client
+    m_web_interface.SetOptions(options);
+
+    // optional staging directory for saved images
+    m_file_stager.SetOptions(options);
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+bool
+Renderer<DeviceAdapter>::WebStreamEnabled() const
+{
+    return m_web_stream_enabled;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::SetRenderBudget(float budget_ms)
+{
+    m_render_budget = budget_ms;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+int
+Renderer<DeviceAdapter>::QualityLevel() const
+{
+    return m_quality_level;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::SetVolumeSampleDistance(float distance)
+{
+    m_volume_sample_distance = distance;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::OpacityTable(vtkmActor *plot,
+                                      int num_entries,
+                                      std::vector<float> &opacity,
+                                      float64 &range_min,
+                                      float64 &range_max)
+{
+    //
+    // Same color table selection as Render
+    //
+    vtkmColorTable color_table = plot->ColorTable;
+    if(!m_transfer_function.dtype().is_empty())
+    {
+        color_table = SetColorMapFromNode();
+    }
+    else
+    {
+        CreateDefaultTransferFunction(color_table);
+    }
+
+    opacity.resize(num_entries);
+    for(int i = 0; i < num_entries; i++)
+    {
+        vtkm::Float32 scalar = vtkm::Float32(i) / vtkm::Float32(num_entries - 1);
+        opacity[i] = color_table.MapAlpha(scalar);
+    }
+
+    range_min = plot->ScalarRange.Min;
+    range_max = plot->ScalarRange.Max;
+
+#ifdef PARALLEL
+    // colors are mapped over the range of all ranks
+    float64 local_min = range_min;
+    float64 local_max = range_max;
+    MPI_Allreduce(&local_min, &range_min, 1, MPI_DOUBLE, MPI_MIN, m_mpi_comm);
+    MPI_Allreduce(&local_max, &range_max, 1, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+bool
+Renderer<DeviceAdapter>::AllRanks(bool value)
+{
+    int local = value ? 1 : 0;
+    int all   = local;
+#ifdef PARALLEL
+    MPI_Allreduce(&local, &all, 1, MPI_INT, MPI_MIN, m_mpi_comm);
+#endif
+    return all == 1;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+int
+Renderer<DeviceAdapter>::ChooseQualityLevel(RendererType type)
+{
+    if(m_render_budget <= 0.0f)
+    {
+        return 0;
+    }
+
+    //
+    // Estimate the full quality cost from the recent frames
+    //
+    const std::deque<double> &costs = m_frame_costs[type];
+    double full_cost = 0.0;
+    for(size_t i = 0; i < costs.size(); i++)
+    {
+        full_cost += costs[i];
+    }
+
+    if(!costs.empty())
+    {
+        full_cost /= costs.size();
+    }
+
+#ifdef PARALLEL
+    //
+    // All ranks have to render at the same size, so they agree on
+    // the slowest estimate
+    //
+    double local_cost = full_cost;
+    MPI_Allreduce(&local_cost, &full_cost, 1, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+#endif
+
+    //
+    // Pick the highest quality expected to fit, without any history
+    // we start at full quality
+    //
+    int level = 0;
+    while(level < NUM_QUALITY_LEVELS - 1 &&
+          full_cost * QualityCostFactor(level, type) > m_render_budget)
+    {
+        level++;
+    }
+
+    if(level != m_quality_level)
+    {
+        STRAWMAN_INFO("Render budget of " << m_render_budget << " ms, "
+                      "estimated cost " << full_cost << " ms at full quality,"
+                      " using quality level " << level);
+    }
+
+    return level;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::RecordFrameCost(RendererType type,
+                                         double frame_ms)
+{
+    std::deque<double> &costs = m_frame_costs[type];
+    costs.push_back(frame_ms / QualityCostFactor(m_quality_level, type));
+    if(costs.size() > FRAME_COST_HISTORY)
+    {
+        costs.pop_front();
+    }
 }
 //-----------------------------------------------------------------------------
 template<typename DeviceAdapter>
@@ -727,6 +1004,9 @@ Renderer<DeviceAdapter>::WebSocketPush(PNGEncoder &png)
     //status = m_data->fetch("state");
     //status.remove("domain");
     status["data/ndomains"] = ndomains;
+    // quality level the frame was rendered at, see SetRenderBudget
+    status["render/quality"] = m_quality_level;
+    status["render/image_scale"] = QUALITY_IMAGE_SCALE[m_quality_level];
     
     m_web_interface.PushMessage(status);
     m_web_interface.PushImage(png);
@@ -784,20 +1064,157 @@ Renderer<DeviceAdapter>::WebSocketPush(const std::string &img_file_path)
 //-----------------------------------------------------------------------------
 template<typename DeviceAdapter>
 void
-Renderer<DeviceAdapter>::SaveImage(const char *image_file_name)
+Renderer<DeviceAdapter>::FrameInfo(conduit::Node &info) const
 {
+    info.set(m_frame_info);
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::SetFrameInfo(int image_height,
+                                      int image_width,
+                                      bool raster_2d)
+{
+    m_frame_info.reset();
+    m_frame_info["width"]         = image_width;
+    m_frame_info["height"]        = image_height;
+    m_frame_info["quality_level"] = m_quality_level;
+    m_frame_info["raster_2d"]     = raster_2d ? 1 : 0;
+    m_frame_info["reused"]        = 0;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+conduit::uint64
+Renderer<DeviceAdapter>::FrameKey(conduit::uint64 frame_key,
+                                  const char *image_file_name,
+                                  int image_height,
+                                  int image_width,
+                                  int dims)
+{
+    //
+    // The camera and color map persist across plots, so they are
+    // part of the key along with the final image size. A reused frame
+    // is pushed to the web client as is, so the key also tells streamed
+    // previews from saved frames.
+    //
+    const bool preview = image_file_name == NULL && m_web_stream_enabled;
+    const float preview_scale = preview ? m_web_preview_scale : 1.0f;
+
+    conduit::uint64 key = frame_key;
+    key = combine_fingerprints(key, (conduit::uint64)image_height);
+    key = combine_fingerprints(key, (conduit::uint64)image_width);
+    key = combine_fingerprints(key, (conduit::uint64)(preview ? 1 : 0));
+    key = combine_fingerprints(key, (conduit::uint64)(preview_scale * 1000000.0f));
+    key = combine_fingerprints(key, (conduit::uint64)dims);
+    key = combine_fingerprints(key, (conduit::uint64)m_quality_level);
+    key = combine_fingerprints(key, data_fingerprint(m_camera));
+    key = combine_fingerprints(key, data_fingerprint(m_transfer_function));
+    return key;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+bool
+Renderer<DeviceAdapter>::ReuseFrame(conduit::uint64 key)
+{
+    int hit = m_frame_cache.find(key) != m_frame_cache.end() ? 1 : 0;
+
 #ifdef PARALLEL
+    //
+    // A frame is only reused if the inputs are unchanged on all ranks,
+    // otherwise everyone has to take part in compositing
+    //
+    int all_hit = 0;
+    MPI_Allreduce(&hit, &all_hit, 1, MPI_INT, MPI_MIN, m_mpi_comm);
+    hit = all_hit;
+#endif
+
+    if(hit == 0)
+    {
+        return false;
+    }
+
     if(m_rank == 0)
     {
-        string ofname(image_file_name);
-        ofname +=  ".png";
-        m_png_data.Save(ofname);
+        const std::vector<unsigned char> &png = m_frame_cache[key];
+        m_png_data.SetPngBuffer(png.empty() ? NULL : &png[0], png.size());
     }
-#else 
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::CacheFrame(conduit::uint64 key)
+{
+    if(m_frame_cache.size() >= FRAME_CACHE_SIZE)
+    {
+        m_frame_cache.clear();
+    }
+
+    // other ranks only record the key, so they can vote on reuse
+    std::vector<unsigned char> &png = m_frame_cache[key];
+    if(m_rank == 0 && m_png_data.PngBuffer() != NULL)
+    {
+        const unsigned char *png_data = (const unsigned char*)m_png_data.PngBuffer();
+        png.assign(png_data, png_data + m_png_data.PngBufferSize());
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::SaveImage(const char *image_file_name)
+{
+#ifdef PARALLEL
+    if(m_rank != 0)
+    {
+        return;
+    }
+#endif
     string ofname(image_file_name);
     ofname +=  ".png";
-    m_png_data.Save(ofname);
-#endif
+    // with staging, the image is written locally and moved to ofname
+    // in the background
+    string stage_name = m_file_stager.StagePath(ofname);
+    m_png_data.Save(stage_name);
+    m_file_stager.Submit(stage_name,ofname);
+}
+
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
+void
+Renderer<DeviceAdapter>::FrameSize(const char *image_file_name,
+                                   int &image_height,
+                                   int &image_width)
+{
+    //
+    // Images that are only streamed use the size
+    // requested for the web client (if any)
+    //
+    if(image_file_name == NULL && m_web_stream_enabled)
+    {
+        if(m_web_interface.TargetWidth() > 0)
+        {
+            image_width = m_web_interface.TargetWidth();
+        }
+
+        if(m_web_interface.TargetHeight() > 0)
+        {
+            image_height = m_web_interface.TargetHeight();
+        }
+
+        // low resolution preview, full resolution is only
+        // needed for the images we save
+        if(m_web_preview_scale < 1.0f)
+        {
+            image_width  = std::max(16, int(image_width  * m_web_preview_scale));
+            image_height = std::max(16, int(image_height * m_web_preview_scale));
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -808,12 +1225,54 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
                                int image_width,
                                RendererType mode,
                                int dims,
-                               const char *image_file_name)
+                               const char *image_file_name,
+                               conduit::uint64 frame_key)
 {
     STRAWMAN_BLOCK_TIMER(RENDER)
     try
     {
-        PNGEncoder png;
+        FrameSize(image_file_name, image_height, image_width);
+
+        //
+        // With a render budget, frames may be painted at a reduced size
+        // and upscaled before encoding
+        //
+        m_quality_level = ChooseQualityLevel(mode);
+
+        const int full_width  = image_width;
+        const int full_height = image_height;
+        const float image_scale = QUALITY_IMAGE_SCALE[m_quality_level];
+        if(image_scale < 1.0f)
+        {
+            image_width  = std::max(16, int(full_width  * image_scale));
+            image_height = std::max(16, int(full_height * image_scale));
+        }
+
+        SetFrameInfo(full_height, full_width, false);
+
+        //
+        // If nothing that goes into the image changed, skip painting,
+        // compositing and encoding and send the previous frame again
+        //
+        conduit::uint64 cache_key = 0;
+        if(frame_key != 0)
+        {
+            cache_key = FrameKey(frame_key,
+                                 image_file_name,
+                                 full_height,
+                                 full_width,
+                                 dims);
+
+            if(ReuseFrame(cache_key))
+            {
+                STRAWMAN_BLOCK_TIMER(RENDER_REUSE);
+                m_frame_info["reused"] = 1;
+                WebSocketPush(m_png_data);
+                if(image_file_name != NULL) SaveImage(image_file_name);
+                return;
+            }
+        }
+
         //
         // Do some check to see if we need
         // to re-init rendering
@@ -898,12 +1357,25 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
         {
 
               //set sample distance
-              const vtkm::Float32 num_samples = 200.f;
               vtkm::Vec<vtkm::Float32,3> totalExtent;
               totalExtent[0] = vtkm::Float32(plot->SpatialBounds.X.Max - plot->SpatialBounds.X.Min);
               totalExtent[1] = vtkm::Float32(plot->SpatialBounds.Y.Max - plot->SpatialBounds.Y.Min);
               totalExtent[2] = vtkm::Float32(plot->SpatialBounds.Z.Max - plot->SpatialBounds.Z.Min);
-              vtkm::Float32 sample_distance = vtkm::Magnitude(totalExtent) / num_samples;
+              vtkm::Float32 sample_distance = vtkm::Magnitude(totalExtent) / QUALITY_VOLUME_SAMPLES[0];
+
+              // coarse grids need fewer samples than the default
+              if(m_volume_sample_distance > sample_distance)
+              {
+                  sample_distance = m_volume_sample_distance;
+              }
+
+              // and lower quality levels take fewer samples
+              sample_distance *= QUALITY_VOLUME_SAMPLES[0] / QUALITY_VOLUME_SAMPLES[m_quality_level];
+#ifdef PARALLEL
+              // ranks have to agree on the opacity of each step
+              vtkm::Float32 local_distance = sample_distance;
+              MPI_Allreduce(&local_distance, &sample_distance, 1, MPI_FLOAT, MPI_MIN, m_mpi_comm);
+#endif
               vtkmVolumeRenderer *volume_renderer = static_cast<vtkmVolumeRenderer*>(m_renderer);
               
               volume_renderer->SetSampleDistance(sample_distance);
@@ -940,6 +1412,7 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
     
         }
 #endif
+
         //---------------------------------------------------------------------
         {// open block for RENDER_PAINT Timer
         //---------------------------------------------------------------------
@@ -955,7 +1428,8 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
         //Save the image.
 #ifdef PARALLEL
 
-        const float *result_color_buffer = NULL;
+        const float         *result_color_buffer = NULL;
+        const unsigned char *result_ubyte_buffer = NULL;
         //---------------------------------------------------------------------
         {// open block for RENDER_COMPOSITE Timer
         //---------------------------------------------------------------------
@@ -977,15 +1451,43 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
           
             input_color_buffer = &m_canvas->ColorBuffer[0];
             input_depth_buffer = &m_canvas->DepthBuffer[0];
+
+            //
+            // At the lowest quality levels we composite 8-bit colors,
+            // which sends a quarter of the color data
+            //
+            std::vector<unsigned char> input_ubyte_buffer;
+            if(m_quality_level >= QUALITY_UBYTE_COMPOSITE)
+            {
+                const int num_values = 4 * image_width * image_height;
+                input_ubyte_buffer.resize(num_values);
+                for(int i = 0; i < num_values; i++)
+                {
+                    float value = std::min(1.0f, std::max(0.0f, input_color_buffer[i]));
+                    input_ubyte_buffer[i] = (unsigned char)(value * 255.0f + 0.5f);
+                }
+            }
             
             if(m_render_type != VOLUME)
             {   
-                result_color_buffer = m_icet.Composite(image_width,
-                                                       image_height,
-                                                       input_color_buffer,
-                                                       input_depth_buffer,
-                                                       view_port,
-                                                       m_bg_color.Components);
+                if(input_ubyte_buffer.empty())
+                {
+                    result_color_buffer = m_icet.Composite(image_width,
+                                                           image_height,
+                                                           input_color_buffer,
+                                                           input_depth_buffer,
+                                                           view_port,
+                                                           m_bg_color.Components);
+                }
+                else
+                {
+                    result_ubyte_buffer = m_icet.Composite(image_width,
+                                                           image_height,
+                                                           &input_ubyte_buffer[0],
+                                                           input_depth_buffer,
+                                                           view_port,
+                                                           m_bg_color.Components);
+                }
             }
             else
             {    
@@ -993,11 +1495,22 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
                 // Volume rendering uses a visibility ordering 
                 // by rank instead of a depth buffer
                 //
-                result_color_buffer = m_icet.Composite(image_width,
-                                                       image_height,
-                                                       input_color_buffer,
-                                                       vis_order,
-                                                       m_bg_color.Components);
+                if(input_ubyte_buffer.empty())
+                {
+                    result_color_buffer = m_icet.Composite(image_width,
+                                                           image_height,
+                                                           input_color_buffer,
+                                                           vis_order,
+                                                           m_bg_color.Components);
+                }
+                else
+                {
+                    result_ubyte_buffer = m_icet.Composite(image_width,
+                                                           image_height,
+                                                           &input_ubyte_buffer[0],
+                                                           vis_order,
+                                                           m_bg_color.Components);
+                }
                 // leak?
                 free(vis_order);
             }
@@ -1005,7 +1518,8 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
         //---------------------------------------------------------------------
         }// close block for RENDER_COMPOSITE Timer
         //---------------------------------------------------------------------
-          
+
+        RecordFrameCost(mode, FrameMilliseconds());
                 
         //---------------------------------------------------------------------
         {// open block for RENDER_ENCODE Timer
@@ -1018,9 +1532,30 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
         //
         if(m_rank == 0)
         {   
-            m_png_data.Encode(result_color_buffer,
-                              image_width,
-                              image_height);
+            if(result_ubyte_buffer != NULL)
+            {
+                std::vector<unsigned char> upscaled;
+                m_png_data.Encode(UpscaleImage(result_ubyte_buffer,
+                                               image_width,
+                                               image_height,
+                                               full_width,
+                                               full_height,
+                                               upscaled),
+                                  full_width,
+                                  full_height);
+            }
+            else
+            {
+                std::vector<float> upscaled;
+                m_png_data.Encode(UpscaleImage(result_color_buffer,
+                                               image_width,
+                                               image_height,
+                                               full_width,
+                                               full_height,
+                                               upscaled),
+                                  full_width,
+                                  full_height);
+            }
         }
         
         //---------------------------------------------------------------------
@@ -1029,10 +1564,23 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
           
 
 #else
-        m_png_data.Encode(&(m_canvas->ColorBuffer[0]),
-                          image_width,
-                          image_height);
+        RecordFrameCost(mode, FrameMilliseconds());
+
+        std::vector<float> upscaled;
+        m_png_data.Encode(UpscaleImage(&(m_canvas->ColorBuffer[0]),
+                                       image_width,
+                                       image_height,
+                                       full_width,
+                                       full_height,
+                                       upscaled),
+                          full_width,
+                          full_height);
 #endif
+
+        if(cache_key != 0)
+        {
+            CacheFrame(cache_key);
+        }
     
 
 #if PARALLEL
@@ -1051,6 +1599,257 @@ Renderer<DeviceAdapter>::Render(vtkmActor *plot,
 }
 //-----------------------------------------------------------------------------
 template<typename DeviceAdapter>
+bool
+Renderer<DeviceAdapter>::Render2D(vtkmActor *plot,
+                                  const conduit::Node &mesh,
+                                  const std::string &field_name,
+                                  int image_height,
+                                  int image_width,
+                                  const char *image_file_name,
+                                  conduit::uint64 frame_key)
+{
+    STRAWMAN_BLOCK_TIMER(RENDER_2D)
+
+    //
+    // Camera parameters need the general path
+    //
+    Raster2D raster;
+    int supported = (m_camera.dtype().is_empty() && 
+                     raster.SetField(mesh, field_name)) ? 1 : 0;
+
+    float64 bounds[4];
+    raster.Bounds(bounds);
+
+    float64 range_min = plot->ScalarRange.Min;
+    float64 range_max = plot->ScalarRange.Max;
+
+#ifdef PARALLEL
+    //
+    // all ranks take the same path, and share the view and color range
+    //
+    int all_supported = 0;
+    MPI_Allreduce(&supported, &all_supported, 1, MPI_INT, MPI_MIN, m_mpi_comm);
+    supported = all_supported;
+
+    if(supported == 1)
+    {
+        float64 local_min[3] = {bounds[0], bounds[2], range_min};
+        float64 local_max[3] = {bounds[1], bounds[3], range_max};
+        float64 global_min[3];
+        float64 global_max[3];
+        MPI_Allreduce(local_min, global_min, 3, MPI_DOUBLE, MPI_MIN, m_mpi_comm);
+        MPI_Allreduce(local_max, global_max, 3, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+
+        bounds[0] = global_min[0];
+        bounds[1] = global_max[0];
+        bounds[2] = global_min[1];
+        bounds[3] = global_max[1];
+        range_min = global_min[2];
+        range_max = global_max[2];
+    }
+#endif
+
+    if(supported == 0)
+    {
+        return false;
+    }
+
+    FrameSize(image_file_name, image_height, image_width);
+
+    // painting is cheap enough that the budget does not apply
+    m_quality_level = 0;
+
+    SetFrameInfo(image_height, image_width, true);
+
+    conduit::uint64 cache_key = 0;
+    if(frame_key != 0)
+    {
+        cache_key = FrameKey(frame_key,
+                             image_file_name,
+                             image_height,
+                             image_width,
+                             2);
+
+        if(ReuseFrame(cache_key))
+        {
+            STRAWMAN_BLOCK_TIMER(RENDER_REUSE);
+            m_frame_info["reused"] = 1;
+            WebSocketPush(m_png_data);
+            if(image_file_name != NULL) SaveImage(image_file_name);
+            return true;
+        }
+    }
+
+    //
+    // Same color table selection as Render, sampled into a lookup table.
+    // Pseudocolor plots are opaque, alpha marks the covered pixels.
+    //
+    vtkmColorTable color_table = plot->ColorTable;
+    if(!m_transfer_function.dtype().is_empty())
+    {
+        color_table = SetColorMapFromNode();
+    }
+
+    std::vector<unsigned char> lut(4 * RASTER_2D_LUT_SIZE);
+    for(int i = 0; i < RASTER_2D_LUT_SIZE; i++)
+    {
+        vtkm::Float32 scalar = vtkm::Float32(i) / vtkm::Float32(RASTER_2D_LUT_SIZE - 1);
+        vtkmColor color = color_table.MapRGB(scalar);
+        for(int c = 0; c < 3; c++)
+        {
+            float value = std::min(1.0f, std::max(0.0f, color.Components[c]));
+            lut[4 * i + c] = (unsigned char)(value * 255.0f + 0.5f);
+        }
+        lut[4 * i + 3] = 255;
+    }
+
+    //
+    // Fit the bounds to the image keeping the aspect ratio, with the
+    // margin of the default 2D camera view
+    //
+    float64 extent[2] = {bounds[1] - bounds[0], bounds[3] - bounds[2]};
+    float64 pixel_size = std::max(extent[0] / image_width,
+                                  extent[1] / image_height) * RASTER_2D_MARGIN;
+    if(!(pixel_size > 0.0))
+    {
+        pixel_size = 1.0;
+    }
+
+    float64 origin[2];
+    origin[0] = bounds[0] + 0.5 * (extent[0] - pixel_size * image_width);
+    origin[1] = bounds[2] + 0.5 * (extent[1] - pixel_size * image_height);
+
+    std::vector<unsigned char> rgba(4 * image_width * image_height, 0);
+
+    //---------------------------------------------------------------------
+    {// open block for RENDER_PAINT Timer
+    //---------------------------------------------------------------------
+        STRAWMAN_BLOCK_TIMER(RENDER_PAINT);
+
+        raster.Rasterize(origin,
+                         pixel_size,
+                         image_width,
+                         image_height,
+                         lut,
+                         range_min,
+                         range_max,
+                         &rgba[0]);
+
+    //---------------------------------------------------------------------
+    } // close block for RENDER_PAINT Timer
+    //---------------------------------------------------------------------
+
+#ifdef PARALLEL
+    //---------------------------------------------------------------------
+    {// open block for RENDER_COMPOSITE Timer
+    //---------------------------------------------------------------------
+        STRAWMAN_BLOCK_TIMER(RENDER_COMPOSITE);
+
+        //
+        // Domains can overlap (ghost layers, or shared edges that round
+        // to the same pixel), so the highest rank covering a pixel owns
+        // it. The others clear it, and the images combine with a bitwise
+        // or and no depth.
+        //
+        const int num_pixels = image_width * image_height;
+        std::vector<int> coverage(num_pixels, 0);
+        for(int p = 0; p < num_pixels; p++)
+        {
+            if(rgba[4 * p + 3] != 0)
+            {
+                coverage[p] = m_rank + 1;
+            }
+        }
+
+        std::vector<int> owner(num_pixels, 0);
+        MPI_Allreduce(&coverage[0],
+                      &owner[0],
+                      num_pixels,
+                      MPI_INT,
+                      MPI_MAX,
+                      m_mpi_comm);
+
+        for(int p = 0; p < num_pixels; p++)
+        {
+            if(owner[p] != m_rank + 1)
+            {
+                rgba[4 * p + 0] = 0;
+                rgba[4 * p + 1] = 0;
+                rgba[4 * p + 2] = 0;
+                rgba[4 * p + 3] = 0;
+            }
+        }
+
+        if(m_rank == 0)
+        {
+            MPI_Reduce(MPI_IN_PLACE,
+                       &rgba[0],
+                       (int)rgba.size(),
+                       MPI_UNSIGNED_CHAR,
+                       MPI_BOR,
+                       0,
+                       m_mpi_comm);
+        }
+        else
+        {
+            MPI_Reduce(&rgba[0],
+                       NULL,
+                       (int)rgba.size(),
+                       MPI_UNSIGNED_CHAR,
+                       MPI_BOR,
+                       0,
+                       m_mpi_comm);
+        }
+
+    //---------------------------------------------------------------------
+    }// close block for RENDER_COMPOSITE Timer
+    //---------------------------------------------------------------------
+#endif
+
+    //---------------------------------------------------------------------
+    {// open block for RENDER_ENCODE Timer
+    //---------------------------------------------------------------------
+        STRAWMAN_BLOCK_TIMER(RENDER_ENCODE);
+
+        if(m_rank == 0)
+        {
+            unsigned char bg_color[4];
+            for(int c = 0; c < 4; c++)
+            {
+                float value = std::min(1.0f, std::max(0.0f, m_bg_color.Components[c]));
+                bg_color[c] = (unsigned char)(value * 255.0f + 0.5f);
+            }
+
+            const int num_pixels = image_width * image_height;
+            for(int i = 0; i < num_pixels; i++)
+            {
+                if(rgba[4 * i + 3] == 0)
+                {
+                    memcpy(&rgba[4 * i], bg_color, 4);
+                }
+            }
+
+            m_png_data.Encode(&rgba[0], image_width, image_height);
+        }
+
+    //---------------------------------------------------------------------
+    }// close block for RENDER_ENCODE Timer
+    //---------------------------------------------------------------------
+
+    if(cache_key != 0)
+    {
+        CacheFrame(cache_key);
+    }
+
+    // png will be null if rank !=0, thats fine
+    WebSocketPush(m_png_data);
+
+    if(image_file_name != NULL) SaveImage(image_file_name);
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+template<typename DeviceAdapter>
 void
 Renderer<DeviceAdapter>::SetupCamera()
 {
@@ -60,8 +60,13 @@
 
 #include <strawman_png_encoder.hpp>
 #include <strawman_web_interface.hpp>
+#include <strawman_file_stager.hpp>
 #include <strawman_logging.hpp>
 
+#include <deque>
+#include <map>
+#include <vector>
+
 
 // mpi related includes
 #ifdef PARALLEL
@@ -129,6 +134,28 @@ public:
       ~Renderer();
   
       void SetOptions(const conduit::Node &options);
+      bool WebStreamEnabled() const;
+
+      // time budget in milliseconds for painting and compositing a plot,
+      // 0 renders at full quality
+      void SetRenderBudget(float budget_ms);
+      // quality level of the last frame, 0 is full quality
+      int  QualityLevel() const;
+
+      // Volume plots take at most 200 samples along the diagonal of the
+      // bounds. A larger distance (e.g. based on the cell spacing) takes 
+      // fewer, 0 restores the default.
+      void SetVolumeSampleDistance(float distance);
+      // samples the opacity the next volume render of the plot will use
+      // evenly over its (global) scalar range
+      void OpacityTable(vtkmActor *plot,
+                        int num_entries,
+                        std::vector<float> &opacity,
+                        conduit::float64 &range_min,
+                        conduit::float64 &range_max);
+      // true when value is true on every rank, so callers can agree on
+      // a path before collective calls
+      bool AllRanks(bool value);
 
       void SetTransferFunction(const conduit::Node &tFunction);
       void CreateDefaultTransferFunction(vtkmColorTable &color_table);
@@ -143,8 +170,24 @@ public:
                   int image_width, 
                   RendererType type,
                   int dims,
-                  const char *image_file_name = NULL);
+                  const char *image_file_name = NULL,
+                  conduit::uint64 frame_key = 0);
+
+      // Pseudocolor render of a field on a 2D uniform or rectilinear
+      // mesh that maps cells directly to pixels. Returns false (without
+      // rendering) if the field or the camera is not supported, in which
+      // case the plot should go through Render.
+      bool Render2D(vtkmActor *plot,
+                    const conduit::Node &mesh,
+                    const std::string &field_name,
+                    int image_height,
+                    int image_width,
+                    const char *image_file_name = NULL,
+                    conduit::uint64 frame_key = 0);
  
+      // size (as encoded), quality level and path of the last frame
+      void FrameInfo(conduit::Node &info) const;
+
       // TODO: Move to pipeline?
       void WebSocketPush(PNGEncoder &png);
       void WebSocketPush(const std::string &img_file_path);
@@ -185,6 +228,22 @@ private:
     void SetDefaultCameraView(vtkmActor *plot);
     void SetupCamera();
     vtkmColorTable  SetColorMapFromNode();
+    void            SetFrameInfo(int image_height,
+                                 int image_width,
+                                 bool raster_2d);
+    void            FrameSize(const char *image_file_name,
+                              int &image_height,
+                              int &image_width);
+    int             ChooseQualityLevel(RendererType type);
+    void            RecordFrameCost(RendererType type,
+                                    double frame_ms);
+    conduit::uint64 FrameKey(conduit::uint64 frame_key,
+                             const char *image_file_name,
+                             int image_height,
+                             int image_width,
+                             int dims);
+    bool            ReuseFrame(conduit::uint64 key);
+    void            CacheFrame(conduit::uint64 key);
 //-----------------------------------------------------------------------------
 // private methods for MPI case
 //-----------------------------------------------------------------------------
@@ -218,10 +277,24 @@ private:
   
     conduit::Node       m_options;              // CDH: need to store?
     bool                m_web_stream_enabled;   // CDH: move to pipeline ?
+    float               m_web_preview_scale;    // size of web only images
     WebInterface        m_web_interface;        // CDH: move to pipeline ?
+    FileStager          m_file_stager;          // optional image staging
   
     PNGEncoder          m_png_data;
 
+    // recent paint + composite times per renderer type, scaled to
+    // full quality, used to stay within the render budget
+    float               m_render_budget;
+    int                 m_quality_level;
+    float               m_volume_sample_distance;
+    std::deque<double>  m_frame_costs[2];
+
+    conduit::Node       m_frame_info;
+
+    // encoded images of recent frames, by frame key (only kept on rank 0)
+    std::map<conduit::uint64, std::vector<unsigned char> > m_frame_cache;
+
 //-----------------------------------------------------------------------------
 // private vars for MPI case
 //-----------------------------------------------------------------------------
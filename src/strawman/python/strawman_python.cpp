@@ -350,6 +350,42 @@ PyStrawman_Strawman_execute(PyStrawman_Strawman *self,
     Py_RETURN_NONE; 
 }
 
+//-----------------------------------------------------------------------------
+static PyObject *
+PyStrawman_Strawman_info(PyStrawman_Strawman *self,
+                         PyObject *args,
+                         PyObject *kwargs)
+{
+
+    static const char *kwlist[] = {"out",
+                                    NULL};
+
+     PyObject *py_node = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args,
+                                     kwargs,
+                                     "O",
+                                     const_cast<char**>(kwlist),
+                                     &py_node))
+    {
+        return NULL;
+    }
+    
+     
+    if(!PyConduit_Node_Check(py_node))
+    {
+        PyErr_SetString(PyExc_TypeError,
+                        "Strawman::Info 'out' argument must be a "
+                        "conduit::Node");
+        return NULL;
+    }
+    
+    Node *node = PyConduit_Node_Get_Node_Ptr(py_node);
+    self->strawman->Info(*node);
+
+    Py_RETURN_NONE; 
+}
+
 //---------------------------------------------------------------------------//
 static PyObject *
 PyStrawman_Strawman_close(PyStrawman_Strawman *self)
@@ -384,6 +420,11 @@ static PyMethodDef PyStrawman_Strawman_METHODS[] = {
       (PyCFunction)PyStrawman_Strawman_execute,
      METH_VARARGS | METH_KEYWORDS,
       "{todo}"},
+     //-----------------------------------------------------------------------//
+     {"info",
+      (PyCFunction)PyStrawman_Strawman_info,
+     METH_VARARGS | METH_KEYWORDS,
+      "{todo}"},
     //-----------------------------------------------------------------------//
     {"close",
      (PyCFunction)PyStrawman_Strawman_close, 
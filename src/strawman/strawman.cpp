@@ -51,6 +51,10 @@
 
 #include <strawman.hpp>
 #include <strawman_pipeline.hpp>
+#include <strawman_capture.hpp>
+#include <strawman_statistics.hpp>
+#include <strawman_derived_fields.hpp>
+#include <strawman_subsample.hpp>
 
 #include <pipelines/strawman_empty_pipeline.hpp>
 
@@ -66,6 +70,10 @@
     #include <pipelines/strawman_blueprint_hdf5_pipeline.hpp>
 #endif
 
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
 
 using namespace conduit;
 //-----------------------------------------------------------------------------
@@ -77,13 +85,19 @@ namespace strawman
 
 //-----------------------------------------------------------------------------
 Strawman::Strawman()
-: m_pipeline(NULL)
+: m_pipeline(NULL),
+  m_capture(NULL),
+  m_derived_fields(new DerivedFields()),
+  m_has_derived_data(false),
+  m_pipeline_data(NULL),
+  m_mpi_comm_id(-1)
 {
 }
 
 //-----------------------------------------------------------------------------
 Strawman::~Strawman()
 {
+    delete m_derived_fields;
 
 }
 
@@ -96,7 +110,7 @@ Strawman::Open()
 }
 
 //-----------------------------------------------------------------------------
-void
+static void
 CheckForJSONFile(std::string file_name, conduit::Node &node)
 {
     if(!conduit::utils::is_file(file_name))
@@ -169,13 +183,74 @@ Strawman::Open(const conduit::Node &options)
     }
     
     m_pipeline->Initialize(processed_opts);
+
+#ifdef PARALLEL
+    if(processed_opts.has_child("mpi_comm"))
+    {
+        m_mpi_comm_id = processed_opts["mpi_comm"].to_int();
+    }
+#endif
+
+    if(processed_opts.has_path("timers/counters") &&
+       processed_opts["timers/counters"].as_string() == "true")
+    {
+        BlockTimer::EnableCounters();
+    }
+
+    if(processed_opts.has_path("tracing/enabled") &&
+       processed_opts["tracing/enabled"].as_string() == "true")
+    {
+        int max_events = 65536;
+        if(processed_opts.has_path("tracing/max_events"))
+        {
+            max_events = processed_opts["tracing/max_events"].to_int();
+        }
+        
+        m_trace_file = "strawman_trace.json";
+        if(processed_opts.has_path("tracing/file"))
+        {
+            m_trace_file = processed_opts["tracing/file"].as_string();
+        }
+
+        BlockTimer::EnableTracing(max_events);
+    }
+
+    if(processed_opts.has_path("capture/path"))
+    {
+        int rank = 0;
+#ifdef PARALLEL
+        if(processed_opts.has_child("mpi_comm"))
+        {
+            int mpi_handle = processed_opts["mpi_comm"].to_int();
+            MPI_Comm_rank(MPI_Comm_f2c(mpi_handle), &rank);
+        }
+#endif
+        std::string capture_path = processed_opts["capture/path"].as_string();
+        m_capture = new CaptureWriter();
+        m_capture->Open(capture_file_name(capture_path, rank), processed_opts);
+        m_capture->RecordOpen(processed_opts);
+    }
 }
 
 //-----------------------------------------------------------------------------
 void
 Strawman::Publish(const conduit::Node &data)
 {
+    if(data.has_path("state/cycle"))
+    {
+        BlockTimer::SetCycle(data["state/cycle"].to_uint64());
+    }
+
+    if(m_capture != NULL)
+    {
+        m_capture->RecordPublish(data);
+    }
     m_pipeline->Publish(data);
+    m_data.set_external(data);
+    m_pipeline_data = &m_data;
+    m_derived_data.reset();
+    m_has_derived_data = false;
+    m_subsampled_data.reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -184,7 +259,279 @@ Strawman::Execute(const conduit::Node &actions)
 {
     Node processed_actions(actions);
     CheckForJSONFile("strawman_actions.json", processed_actions);
-    m_pipeline->Execute(processed_actions);
+    if(m_capture != NULL)
+    {
+        m_capture->RecordExecute(processed_actions);
+    }
+
+    m_info.reset();
+
+    // add_derived_field, statistics and subsample actions do not depend on
+    // the pipeline, so strawman runs them and passes the remaining actions
+    // on
+    Node pipeline_actions;
+    const Node *subsample = NULL;
+    bool strawman_actions = false;
+    bool derived_changed = false;
+    for(index_t i = 0; i < processed_actions.number_of_children(); i++)
+    {
+        const Node &action = processed_actions.child(i);
+        std::string action_name = "";
+        if(action.has_child("action"))
+        {
+            action_name = action["action"].as_string();
+        }
+        
+        if(action_name == "add_derived_field")
+        {
+            const std::string field_name = action["field_name"].as_string();
+            if(m_derived_fields->Add(field_name,
+                                     action["expression"].as_string()))
+            {
+                derived_changed = RemoveDerivedValues(field_name) ||
+                                  derived_changed;
+            }
+            strawman_actions = true;
+        }
+        else if(action_name == "statistics")
+        {
+            strawman_actions = true;
+        }
+        else if(action_name == "subsample")
+        {
+            // the last subsample action applies to all pipeline actions
+            subsample = &action;
+            strawman_actions = true;
+        }
+        else
+        {
+            pipeline_actions.append().set(action);
+        }
+    }
+
+    bool data_changed = EvaluateDerivedFields(processed_actions) ||
+                        derived_changed;
+    const Node *pipeline_data = m_has_derived_data ? &m_derived_data : &m_data;
+
+    if(subsample != NULL)
+    {
+        subsample_mesh(*pipeline_data, *subsample, m_subsampled_data);
+        pipeline_data = &m_subsampled_data;
+        data_changed = true;
+    }
+
+    // the pipeline keeps the mesh it was given last
+    if(m_pipeline_data != NULL &&
+       (data_changed || pipeline_data != m_pipeline_data))
+    {
+        m_pipeline->Publish(*pipeline_data);
+        m_pipeline_data = pipeline_data;
+    }
+
+    for(index_t i = 0; i < processed_actions.number_of_children(); i++)
+    {
+        const Node &action = processed_actions.child(i);
+        if(action.has_child("action") &&
+           action["action"].as_string() == "statistics")
+        {
+            ExecuteStatistics(action);
+        }
+    }
+
+    if(!strawman_actions)
+    {
+        m_pipeline->Execute(processed_actions);
+    }
+    else if(pipeline_actions.number_of_children() > 0)
+    {
+        m_pipeline->Execute(pipeline_actions);
+    }
+}
+
+//-----------------------------------------------------------------------------
+static void
+CollectFieldReferences(const conduit::Node &node,
+                       std::set<std::string> &names)
+{
+    for(index_t i = 0; i < node.number_of_children(); i++)
+    {
+        const Node &child = node.child(i);
+        const std::string child_name = node.dtype().is_object() ? 
+                                       child.name() : "";
+
+        if(child_name == "field_name" && child.dtype().is_string())
+        {
+            names.insert(child.as_string());
+        }
+        else if(child_name == "fields" && child.dtype().is_string())
+        {
+            names.insert(child.as_string());
+        }
+        else if(child_name == "fields" && child.dtype().is_list())
+        {
+            for(index_t f = 0; f < child.number_of_children(); f++)
+            {
+                names.insert(child.child(f).as_string());
+            }
+        }
+        else
+        {
+            CollectFieldReferences(child, names);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//
+// Derived values are kept until the next Publish. When a field is given a
+// new expression, its values and those of the derived fields that read it
+// are stale. Returns true if any values were removed.
+//
+//-----------------------------------------------------------------------------
+bool
+Strawman::RemoveDerivedValues(const std::string &field_name)
+{
+    if(!m_has_derived_data || !m_derived_data.has_child("fields"))
+    {
+        return false;
+    }
+
+    std::set<std::string> stale;
+    m_derived_fields->Dependents(field_name, stale);
+
+    bool removed = false;
+    Node &fields = m_derived_data["fields"];
+    std::set<std::string>::const_iterator itr;
+    for(itr = stale.begin(); itr != stale.end(); ++itr)
+    {
+        // published fields hide derived fields of the same name
+        if(fields.has_child(*itr) && !m_data.has_path("fields/" + *itr))
+        {
+            fields.remove(*itr);
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+//-----------------------------------------------------------------------------
+bool
+Strawman::EvaluateDerivedFields(const conduit::Node &actions)
+{
+    if(m_derived_fields->Empty())
+    {
+        return false;
+    }
+
+    // derived fields are only evaluated when an action reads them, or 
+    // saves the whole mesh
+    std::set<std::string> referenced;
+    for(index_t i = 0; i < actions.number_of_children(); i++)
+    {
+        const Node &action = actions.child(i);
+        std::string action_name = "";
+        if(action.has_child("action"))
+        {
+            action_name = action["action"].as_string();
+        }
+
+        if(action_name == "add_derived_field")
+        {
+            continue;
+        }
+        else if(action_name == "save")
+        {
+            std::vector<std::string> names = m_derived_fields->Names();
+            referenced.insert(names.begin(), names.end());
+        }
+        else
+        {
+            CollectFieldReferences(action, referenced);
+        }
+    }
+
+    std::set<std::string> names;
+    std::set<std::string>::const_iterator itr;
+    for(itr = referenced.begin(); itr != referenced.end(); ++itr)
+    {
+        if(m_derived_fields->Has(*itr) &&
+           !(m_has_derived_data && m_derived_data.has_path("fields/" + *itr)))
+        {
+            names.insert(*itr);
+        }
+    }
+
+    if(names.empty())
+    {
+        return false;
+    }
+
+    // the published tree is zero copied, only derived values are owned
+    if(!m_has_derived_data)
+    {
+        m_derived_data.set_external(m_data);
+        m_has_derived_data = true;
+    }
+
+    m_derived_fields->Evaluate(names, m_derived_data);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+Strawman::ExecuteStatistics(const conduit::Node &action)
+{
+    Node options(action);
+    int rank = 0;
+#ifdef PARALLEL
+    // without an mpi_comm open option, reduce over all ranks
+    MPI_Comm mpi_comm = MPI_COMM_WORLD;
+    if(m_mpi_comm_id != -1)
+    {
+        options["mpi_comm"] = m_mpi_comm_id;
+        mpi_comm = MPI_Comm_f2c(m_mpi_comm_id);
+    }
+    else if(options.has_child("mpi_comm"))
+    {
+        options.remove("mpi_comm");
+    }
+    MPI_Comm_rank(mpi_comm, &rank);
+#endif
+
+    Node stats;
+    compute_statistics(m_has_derived_data ? m_derived_data : m_data,
+                       options,
+                       stats);
+    m_info["statistics"].update(stats);
+
+    if(rank == 0 && action.has_child("log_file"))
+    {
+        int cycle = 0;
+        if(m_data.has_path("state/cycle"))
+        {
+            cycle = m_data["state/cycle"].to_int();
+        }
+        append_statistics_log(action["log_file"].as_string(), cycle, stats);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+Strawman::Info(conduit::Node &out)
+{
+    out.reset();
+    out.set(m_info);
+
+    if(m_pipeline != NULL)
+    {
+        Node pipeline_info;
+        m_pipeline->Info(pipeline_info);
+        if(pipeline_info.number_of_children() > 0)
+        {
+            out["pipeline"].set(pipeline_info);
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -197,6 +544,27 @@ Strawman::Close()
         delete m_pipeline;
         m_pipeline = NULL;
     }
+
+    if(m_capture != NULL)
+    {
+        m_capture->RecordClose();
+        delete m_capture;
+        m_capture = NULL;
+    }
+
+    m_data.reset();
+    m_derived_data.reset();
+    m_has_derived_data = false;
+    m_subsampled_data.reset();
+    m_pipeline_data = NULL;
+    delete m_derived_fields;
+    m_derived_fields = new DerivedFields();
+
+    if(!m_trace_file.empty())
+    {
+        BlockTimer::WriteTraceFile(m_trace_file);
+        m_trace_file = "";
+    }
 }
 
 //---------------------------------------------------------------------------//
@@ -73,6 +73,10 @@ namespace strawman
 
 // Forward Declare the strawman::Pipeline interface class.
 class Pipeline;
+// Forward Declare the capture log writer.
+class CaptureWriter;
+// Forward Declare the add_derived_field registry.
+class DerivedFields;
 
 //-----------------------------------------------------------------------------
 /// Strawman Interface
@@ -87,11 +91,35 @@ public:
     void   Open(const conduit::Node &options);
     void   Publish(const conduit::Node &data);
     void   Execute(const conduit::Node &actions);
+    // results of the last Execute (e.g. statistics actions)
+    void   Info(conduit::Node &out);
     void   Close();
 
 private:
+    void   ExecuteStatistics(const conduit::Node &action);
+    // evaluates the derived fields the actions read, returns true when 
+    // fields were added
+    bool   EvaluateDerivedFields(const conduit::Node &actions);
+    // drops the values of a redefined derived field and its dependents,
+    // returns true when values were removed
+    bool   RemoveDerivedValues(const std::string &field_name);
     
-    Pipeline *m_pipeline;
+    Pipeline      *m_pipeline;
+    CaptureWriter *m_capture;
+    DerivedFields *m_derived_fields;
+    // BlockTimer trace output file, empty when tracing is off
+    std::string    m_trace_file;
+    // zero copied published data, used by actions strawman runs itself
+    conduit::Node  m_data;
+    // m_data plus the derived fields evaluated this cycle
+    conduit::Node  m_derived_data;
+    bool           m_has_derived_data;
+    // output of the last subsample action
+    conduit::Node  m_subsampled_data;
+    // mesh the pipeline was last given
+    const conduit::Node *m_pipeline_data;
+    conduit::Node  m_info;
+    int            m_mpi_comm_id;
 };
 
 
@@ -69,6 +69,13 @@ Pipeline::~Pipeline()
 
 }
 
+//-----------------------------------------------------------------------------
+void
+Pipeline::Info(conduit::Node &out)
+{
+    out.reset();
+}
+
 //-----------------------------------------------------------------------------
 };
 //-----------------------------------------------------------------------------
@@ -72,6 +72,9 @@ public:
 
     virtual void  Publish(const conduit::Node &data)=0;
     virtual void  Execute(const conduit::Node &actions)=0;
+
+    // optional details of the last Execute, reported by Strawman::Info
+    virtual void  Info(conduit::Node &out);
     
     virtual void  Cleanup()=0;
 };
@@ -61,7 +61,12 @@
 #include <unistd.h>
 #include <set>
 #include <map>
+#include <vector>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
 #ifdef STRAWMAN_PLATFORM_UNIX
 #include <sys/sysinfo.h>
 #endif
@@ -71,9 +76,7 @@
 using namespace conduit;
 
 #ifdef PARALLEL
-#include "conduit_relay_mpi.hpp"
 #include <mpi.h>
-using namespace conduit::relay::mpi;
 #endif
 
 
@@ -84,13 +87,55 @@ using namespace conduit::relay::mpi;
 namespace strawman
 {
 
+//-----------------------------------------------------------------------------
+// timer state of one thread
+//-----------------------------------------------------------------------------
+struct BlockTimer::ThreadState
+{
+    ThreadState(int thread_index)
+    : m_thread_index(thread_index),
+      m_depth(0),
+      m_current_path(""),
+      m_counters_open(false),
+      m_trace_head(0),
+      m_trace_wrapped(false)
+    {}
+
+    int                                         m_thread_index;
+    
+    // timer tree and stack
+    conduit::Node                               m_root;
+    int                                         m_depth;
+    std::string                                 m_current_path;
+    std::map<std::string, timeval>              m_timers;
+    // seconds of the last finished block of each name
+    std::map<std::string, double>               m_last_elapsed;
+    std::set<std::string>                       m_visited;
+
+    // hardware counters count per thread
+    PerfCounters                                m_counters;
+    bool                                        m_counters_open;
+    std::map<std::string, PerfCounters::Sample> m_counter_starts;
+
+    // trace ring buffer
+    std::vector<TraceEvent>                     m_trace_events;
+    size_t                                      m_trace_head;
+    bool                                        m_trace_wrapped;
+    std::vector<std::string>                    m_trace_names;
+    std::map<std::string, int>                  m_trace_name_ids;
+};
+
 // Initialize BlockTimer static data members.
-int                             BlockTimer::s_global_depth = 0;
 conduit::Node                   BlockTimer::s_global_root;
-std::string                     BlockTimer::s_current_path = "";
-std::map<std::string, timeval>  BlockTimer::s_timers;
-std::set<std::string>           BlockTimer::s_visited;
+conduit::Node                   BlockTimer::s_reduced_root;
 int                             BlockTimer::s_rank = 0;
+std::thread::id                 BlockTimer::s_main_thread = std::this_thread::get_id();
+std::vector<BlockTimer::ThreadState*> BlockTimer::s_thread_states;
+std::mutex                      BlockTimer::s_thread_states_mutex;
+std::atomic<bool>               BlockTimer::s_counters_enabled(false);
+std::atomic<bool>               BlockTimer::s_tracing(false);
+std::atomic<int>                BlockTimer::s_trace_max_events(65536);
+std::atomic<uint64>             BlockTimer::s_cycle(0);
 
 //-----------------------------------------------------------------------------
 BlockTimer::BlockTimer(std::string const &name)
@@ -129,31 +174,61 @@ parseLine(char *line)
     return i;
 }
 
+//-----------------------------------------------------------------------------
+BlockTimer::ThreadState &
+BlockTimer::LocalState()
+{
+    static thread_local ThreadState *state = NULL;
+    
+    if(state == NULL)
+    {
+        std::lock_guard<std::mutex> lock(s_thread_states_mutex);
+        // small, stable thread ids are easier to read in traces
+        state = new ThreadState((int)s_thread_states.size());
+        s_thread_states.push_back(state);
+    }
+    
+    return *state;
+}
+
 //-----------------------------------------------------------------------------
 void
 BlockTimer::Start(const std::string &name)
 {
+    ThreadState &state = LocalState();
+
+    if(std::this_thread::get_id() == s_main_thread)
+    {
 #ifdef PARALLEL
-    MPI_Comm_rank(MPI_COMM_WORLD, &s_rank);
-    MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Comm_rank(MPI_COMM_WORLD, &s_rank);
+        MPI_Barrier(MPI_COMM_WORLD);
 #else
-    s_rank = 0;
+        s_rank = 0;
 #endif
+    }
     
-    ++s_global_depth;
+    ++state.m_depth;
+
+    // Start timing, blocks below MAX_DEPTH are only left out of the tree
+    gettimeofday(&state.m_timers[name], NULL);
 
-    if (s_global_depth <= MAX_DEPTH)
+    if (state.m_depth <= MAX_DEPTH)
     {
-        s_current_path += "children/" + name + "/";
-        Precheck();
+        state.m_current_path += "children/" + name + "/";
+        Precheck(state);
 
-        // Start timing.
-        if (s_timers.count(name) == 0)
+        if(s_counters_enabled)
         {
-            timeval timer;
-            s_timers.insert(std::pair<std::string, timeval>(name, timer));
+            if(!state.m_counters_open)
+            {
+                state.m_counters.Open();
+                state.m_counters_open = true;
+            }
+            if(!state.m_counters.Read(state.m_counter_starts[name]))
+            {
+                state.m_counter_starts.erase(name);
+            }
         }
-        gettimeofday(&s_timers[name], NULL);
     }
 
 }
@@ -161,20 +236,29 @@ BlockTimer::Start(const std::string &name)
 void
 BlockTimer::Stop(const std::string &name)
 {
-#ifdef PARALLEL
-    //MPI_Barrier(MPI_COMM_WORLD);
-#endif
-    if (s_global_depth <= MAX_DEPTH)
+    ThreadState &state = LocalState();
+
+    timeval start, end;
+    gettimeofday(&end, NULL);
+    start = state.m_timers[name];
+
+    // Calculate elapsed time.
+    double elapsed_time = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_usec - start.tv_usec))/1000000;
+    state.m_last_elapsed[name] = elapsed_time;
+
+    if (state.m_depth <= MAX_DEPTH)
     {
         // Record timer.
-        timeval start, end;
-        gettimeofday(&end, NULL);
-        start = s_timers[name];
+        PerfCounters::Sample counter_end;
+        bool counters_read = state.m_counters_open &&
+                             state.m_counters.Read(counter_end);
 
-        // Calculate elapsed time.
-        double elapsed_time = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_usec - start.tv_usec))/1000000;
+        if(s_tracing)
+        {
+            RecordEvent(state, name, start, end);
+        }
 
-        Node &curr = CurrentNode();
+        Node &curr = CurrentNode(state);
 
         // Update time spent at current location. added after max (changed)
         double newval = curr["value"].as_float64() + elapsed_time;
@@ -186,6 +270,28 @@ BlockTimer::Stop(const std::string &name)
         //increment the counter
         unsigned int count = curr["count"].as_uint32() + 1;
         curr["count"] = count;
+
+        // accumulate the hardware counts of the available counters
+        std::map<std::string, PerfCounters::Sample>::iterator counter_start =
+            state.m_counter_starts.find(name);
+        if(counters_read && counter_start != state.m_counter_starts.end())
+        {
+            uint64 counts[PerfCounters::NUM_COUNTERS];
+            PerfCounters::Difference(counter_start->second, counter_end, counts);
+            
+            Node &curr_counters = curr["counters"];
+            for(int i = 0; i < PerfCounters::NUM_COUNTERS; i++)
+            {
+                if(!state.m_counters.Available(i))
+                {
+                    continue;
+                }
+                
+                Node &counter = curr_counters[PerfCounters::Name(i)];
+                uint64 total = counter.dtype().is_empty() ? 0 : counter.as_uint64();
+                counter = total + counts[i];
+            }
+        }
        
         // 
         // Get system memory info and average
@@ -229,13 +335,27 @@ BlockTimer::Stop(const std::string &name)
         curr["sysMemUsed"] = 0;
         curr["procMemMB"]  = 0;
 #endif
-        GoUp();
+        GoUp(state);
     }
     
     // Update current location.
-    --s_global_depth;
+    --state.m_depth;
 
 }
+//-----------------------------------------------------------------------------
+double
+BlockTimer::LastElapsed(const std::string &name)
+{
+    const ThreadState &state = LocalState();
+    std::map<std::string, double>::const_iterator itr;
+    itr = state.m_last_elapsed.find(name);
+    if(itr == state.m_last_elapsed.end())
+    {
+        return 0.0;
+    }
+    return itr->second;
+}
+
 //-----------------------------------------------------------------------------
 BlockTimer::~BlockTimer()
 {
@@ -247,26 +367,26 @@ Node &
 BlockTimer::Finalize()
 {
     BlockTimer::ReduceGlobalRoot();
-    return GlobalRoot();
+    return s_reduced_root;
 }
 
 
 //-----------------------------------------------------------------------------
 Node &
-BlockTimer::CurrentNode()
+BlockTimer::CurrentNode(ThreadState &state)
 {
-    return s_global_root[s_current_path];
+    return state.m_root[state.m_current_path];
 }
 
 //-----------------------------------------------------------------------------
-// Initializes values if the current location hasn't been s_visited yet,
-// and updates the set of s_visited locations.
+// Initializes values if the current location hasn't been visited yet,
+// and updates the set of visited locations.
 //-----------------------------------------------------------------------------
-void BlockTimer::Precheck()
+void BlockTimer::Precheck(ThreadState &state)
 {
-    if (s_visited.count(s_current_path + "value") == 0)
+    if (state.m_visited.count(state.m_current_path + "value") == 0)
     { // != "" is to prevent a root of ""
-        Node &curr= CurrentNode();
+        Node &curr= CurrentNode(state);
         curr["value"]      = 0.0;
         curr["id"]         = s_rank;
         curr["count"]      = 0u;
@@ -277,41 +397,28 @@ void BlockTimer::Precheck()
         curr["sysMemUsed"] = 0ul;
         curr["procMemMB"]  = 0;
 
-        s_visited.insert(s_current_path + "value");
+        state.m_visited.insert(state.m_current_path + "value");
     }
 }
 
-//-----------------------------------------------------------------------------
-bool
-BlockTimer::CheckForKnownPath(std::string &path)
-{
-  if(path == "value")       return true;
-  if(path == "id")          return true;
-  if(path == "count")       return true;
-  if(path == "avg")         return true;
-  if(path == "minimum")     return true;
-  if(path == "minid")       return true;
-  if(path == "sysMemUsed")  return true;
-  if(path == "procMemMB")   return true;
-  return false;
-}
 //-----------------------------------------------------------------------------
 // Goes up one function in the current location path.
 //-----------------------------------------------------------------------------
 void
-BlockTimer::GoUp()
+BlockTimer::GoUp(ThreadState &state)
 {
-    const unsigned int len = s_current_path.length();
+    std::string &current_path = state.m_current_path;
+    const unsigned int len = current_path.length();
     if (len == 0)
     {
-        s_current_path = "";
+        current_path = "";
         return;
     }
     
     unsigned int ctr = 1;
     unsigned int numslashes = 0;
   
-    std::string::iterator striter = s_current_path.end();
+    std::string::iterator striter = current_path.end();
     --striter;
 
     while (ctr < len)
@@ -321,7 +428,7 @@ BlockTimer::GoUp()
             numslashes += 1;
             if (numslashes >= 3)
             {
-                s_current_path = s_current_path.substr(0, len - ctr + 1);
+                current_path = current_path.substr(0, len - ctr + 1);
                 return;
             }
         }
@@ -330,151 +437,457 @@ BlockTimer::GoUp()
         ++ctr;
     }
     
-    s_current_path = "";
+    current_path = "";
     return;
 }
 
 //-----------------------------------------------------------------------------
-void 
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// per timer statistics, reduced over ranks with a single MPI_Reduce
+//-----------------------------------------------------------------------------
+enum TimerStat
+{
+    STAT_NUM_RANKS = 0, // ranks that ran the timer
+    STAT_SUM,           // sum of the per call times
+    STAT_SUM_SQ,        // sum of the squared per call times
+    STAT_MIN,
+    STAT_MIN_RANK,
+    STAT_MAX,
+    STAT_MAX_RANK,
+    STAT_CALLS,         // total number of calls
+    STAT_SYS_MEM,       // sum of system memory used (MB)
+    STAT_PROC_MEM,      // sum of process memory used (MB)
+    STAT_COUNTERS_REQ,  // ranks that asked for hardware counters
+    // per hardware counter: sum of the counts, and the calls they cover
+    STAT_COUNTERS,
+    NUM_TIMER_STATS = STAT_COUNTERS + 2 * PerfCounters::NUM_COUNTERS
+};
+
+//-----------------------------------------------------------------------------
+// combines the stats of b into a
 //-----------------------------------------------------------------------------
-BlockTimer::Reduce(Node &a, Node &b)
-{
-    // If a has it
-    if (a.dtype().is_object() && a.has_path("value")) 
-    {
-      // Update (reduce) data
-      a["count"] = a["count"].as_uint32() + b["count"].as_uint32();
-      
-      if (b["value"].as_float64() > a["value"].as_float64())
-      {
-          a["value"] = b["value"];
-          a["id"] = b["id"];
-      }
-      
-      // added after max
-      if (a["min"].as_float64() > b["min"].as_float64())
-      {
-          a["min"] = b["min"];
-          a["minid"] = b["minid"];
-      }
-      
-      unsigned int count_a = a["count"].as_uint32();
-      unsigned int count_b = b["count"].as_uint32();
-      a["avg"] = (a["avg"].as_float64() * count_a + b["avg"].as_float64() * count_b) / (count_a + count_b);
+void
+combine_timer_stats(const double *b, double *a)
+{
+    if(b[STAT_NUM_RANKS] == 0.0)
+    {
+        return;
+    }
+    
+    if(a[STAT_NUM_RANKS] == 0.0)
+    {
+        for(int i = 0; i < NUM_TIMER_STATS; i++)
+        {
+            a[i] = b[i];
+        }
+        return;
     }
-  
-    NodeIterator itr_b(&b);
 
-    while(itr_b.has_next())
+    a[STAT_NUM_RANKS] += b[STAT_NUM_RANKS];
+    a[STAT_SUM]       += b[STAT_SUM];
+    a[STAT_SUM_SQ]    += b[STAT_SUM_SQ];
+    a[STAT_CALLS]     += b[STAT_CALLS];
+    a[STAT_SYS_MEM]   += b[STAT_SYS_MEM];
+    a[STAT_PROC_MEM]  += b[STAT_PROC_MEM];
+    
+    for(int i = STAT_COUNTERS_REQ; i < NUM_TIMER_STATS; i++)
     {
-        itr_b.next();
-        std::string bpath = itr_b.name();
-        //
-        // If we don't know the path then
-        // it is a timer that needs processing 
-        //
-        if(CheckForKnownPath(bpath))
+        a[i] += b[i];
+    }
+
+    // ties go to the lower rank, so the result does not depend on the
+    // reduction order
+    if(b[STAT_MIN] < a[STAT_MIN] ||
+       (b[STAT_MIN] == a[STAT_MIN] && b[STAT_MIN_RANK] < a[STAT_MIN_RANK]))
+    {
+        a[STAT_MIN]      = b[STAT_MIN];
+        a[STAT_MIN_RANK] = b[STAT_MIN_RANK];
+    }
+
+    if(b[STAT_MAX] > a[STAT_MAX] ||
+       (b[STAT_MAX] == a[STAT_MAX] && b[STAT_MAX_RANK] < a[STAT_MAX_RANK]))
+    {
+        a[STAT_MAX]      = b[STAT_MAX];
+        a[STAT_MAX_RANK] = b[STAT_MAX_RANK];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// collects the paths of all timers in the tree
+//-----------------------------------------------------------------------------
+void
+collect_timer_paths(const Node &node,
+                    const std::string &path,
+                    std::set<std::string> &paths)
+{
+    if(!node.dtype().is_object())
+    {
+        return;
+    }
+
+    if(node.has_child("value") && !path.empty())
+    {
+        paths.insert(path);
+    }
+
+    if(node.has_child("children"))
+    {
+        NodeConstIterator itr = node["children"].children();
+        while(itr.has_next())
         {
-            continue;
+            const Node &child = itr.next();
+            std::string child_path = "children/" + itr.name();
+            if(!path.empty())
+            {
+                child_path = path + "/" + child_path;
+            }
+            collect_timer_paths(child, child_path, paths);
         }
-        
-        if (a.dtype().is_object() &&  a.has_path(bpath))
+    }
+}
+
+//-----------------------------------------------------------------------------
+// adds the timers of the src tree to the dest tree
+//-----------------------------------------------------------------------------
+void
+merge_timer_trees(const Node &src, Node &dest)
+{
+    if(src.has_child("value"))
+    {
+        if(!dest.has_child("value"))
+        {
+            // new timer, copy everything but the children
+            NodeConstIterator itr = src.children();
+            while(itr.has_next())
+            {
+                const Node &child = itr.next();
+                if(itr.name() != "children")
+                {
+                    dest[itr.name()].set(child);
+                }
+            }
+        }
+        else
         {
-            Reduce(a[bpath], b[bpath]);
+            dest["value"] = dest["value"].to_float64() + 
+                            src["value"].to_float64();
+            dest["count"] = (uint32)(dest["count"].to_uint64() + 
+                                     src["count"].to_uint64());
+            dest["sysMemUsed"] = std::max(dest["sysMemUsed"].to_uint64(),
+                                          src["sysMemUsed"].to_uint64());
+            dest["procMemMB"]  = std::max(dest["procMemMB"].to_int(),
+                                          src["procMemMB"].to_int());
+
+            if(src.has_child("counters"))
+            {
+                NodeConstIterator itr = src["counters"].children();
+                while(itr.has_next())
+                {
+                    const Node &counter = itr.next();
+                    Node &dest_counter = dest["counters"][itr.name()];
+                    uint64 total = dest_counter.dtype().is_empty() ? 
+                                   0 : dest_counter.to_uint64();
+                    dest_counter = total + counter.to_uint64();
+                }
+            }
         }
     }
 
-    return;
+    if(src.has_child("children"))
+    {
+        NodeConstIterator itr = src["children"].children();
+        while(itr.has_next())
+        {
+            const Node &child = itr.next();
+            merge_timer_trees(child, dest["children"][itr.name()]);
+        }
+    }
 }
+
+#ifdef PARALLEL
 //-----------------------------------------------------------------------------
-void 
-BlockTimer::AverageByCount(Node &node, int numRanks)
+void
+timer_stats_op(void *in, void *inout, int *len, MPI_Datatype *)
 {
-    if(node.dtype().is_object() && node.has_path("value"))
+    const double *b = (const double*)in;
+    double       *a = (double*)inout;
+    
+    for(int i = 0; i < *len; i += NUM_TIMER_STATS)
     {
-        double count  = node["count"].as_uint32()  / numRanks;
-        node["value"] = node["value"].as_float64() / count;
-        node["min"]   = node["min"].as_float64()   / count;
-        node["avg"]   = node["avg"].as_float64()   / count;
-        node["count"] = uint32(count);
+        combine_timer_stats(b + i, a + i);
     }
-  
-  
-    NodeIterator itr = node.children();
+}
+
+//-----------------------------------------------------------------------------
+// merges the timer paths of all ranks up a binomial tree to rank 0, and
+// broadcasts the result, so every rank agrees on the timer ids.
+//-----------------------------------------------------------------------------
+void
+agree_on_timer_paths(std::set<std::string> &paths, MPI_Comm comm)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
 
-    while(itr.has_next()) 
+    const int tag = 4244;
+    
+    for(int mask = 1; mask < size; mask <<= 1)
     {
-        Node &curr_node = itr.next();
-        std::string curr_path = itr.name();
+        if((rank & mask) != 0)
+        {
+            std::string paths_str;
+            std::set<std::string>::const_iterator itr;
+            for(itr = paths.begin(); itr != paths.end(); ++itr)
+            {
+                paths_str += *itr + "\n";
+            }
+            int len = (int)paths_str.size();
+            MPI_Send(&len, 1, MPI_INT, rank - mask, tag, comm);
+            MPI_Send((void*)paths_str.data(), len, MPI_CHAR, 
+                     rank - mask, tag, comm);
+            break;
+        }
+        else if(rank + mask < size)
+        {
+            int len = 0;
+            MPI_Recv(&len, 1, MPI_INT, rank + mask, tag, comm,
+                     MPI_STATUS_IGNORE);
+            std::string paths_str(len, ' ');
+            MPI_Recv(&paths_str[0], len, MPI_CHAR, rank + mask, tag, comm,
+                     MPI_STATUS_IGNORE);
+
+            std::istringstream iss(paths_str);
+            std::string line;
+            while(std::getline(iss, line))
+            {
+                paths.insert(line);
+            }
+        }
+    }
 
-        if(CheckForKnownPath(curr_path))
+    std::string paths_str;
+    if(rank == 0)
+    {
+        std::set<std::string>::const_iterator itr;
+        for(itr = paths.begin(); itr != paths.end(); ++itr)
         {
-            continue;
+            paths_str += *itr + "\n";
         }
-        
-        AverageByCount(curr_node, numRanks);
     }
 
-    return;
+    int len = (int)paths_str.size();
+    MPI_Bcast(&len, 1, MPI_INT, 0, comm);
+    paths_str.resize(len);
+    if(len > 0)
+    {
+        MPI_Bcast(&paths_str[0], len, MPI_CHAR, 0, comm);
+    }
+
+    paths.clear();
+    std::istringstream iss(paths_str);
+    std::string line;
+    while(std::getline(iss, line))
+    {
+        paths.insert(line);
+    }
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// name of a rank's trace file, the rank is inserted before the extension
+// (strawman_trace.json -> strawman_trace_000003.json)
+//-----------------------------------------------------------------------------
+std::string
+rank_trace_file_name(const std::string &file_name, int rank)
+{
+    char rank_buff[32];
+    snprintf(rank_buff, sizeof(rank_buff), "_%06d", rank);
+
+    std::string::size_type dot   = file_name.rfind('.');
+    std::string::size_type slash = file_name.rfind('/');
+    if(dot == std::string::npos ||
+       (slash != std::string::npos && dot < slash))
+    {
+        return file_name + rank_buff;
+    }
+
+    return file_name.substr(0, dot) + rank_buff + file_name.substr(dot);
 }
 
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void 
-BlockTimer::ReduceAll(Node &thisRanksNode)
+BlockTimer::ReduceAll(const Node &local, Node &reduced)
 {
+    int rank = 0;
+    
+    std::set<std::string> path_set;
+    detail::collect_timer_paths(local, "", path_set);
+
 #ifdef PARALLEL
-    int temp;
-    MPI_Comm_size(MPI_COMM_WORLD, &temp);
-    const unsigned int numProcesses = temp;
-    MPI_Comm_rank(MPI_COMM_WORLD, &temp);
-    const unsigned int rank = temp;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    detail::agree_on_timer_paths(path_set, MPI_COMM_WORLD);
+#endif
 
-    std::vector<Node> recvNodes(numProcesses+1);
+    // the sorted path set is the timer id table
+    std::vector<std::string> paths(path_set.begin(), path_set.end());
+    const int num_stats = detail::NUM_TIMER_STATS;
+    
+    std::vector<double> stats(paths.size() * num_stats, 0.0);
 
-    if (rank == 0)
+    for(size_t i = 0; i < paths.size(); i++)
     {
-        for (unsigned int i = 1; i < numProcesses; ++i)
+        if(!local.has_path(paths[i] + "/value"))
+        {
+            continue;
+        }
+
+        const Node &timer = local[paths[i]];
+        double count = (double) timer["count"].to_uint64();
+        if(count == 0.0)
+        {
+            continue;
+        }
+        
+        // average time per call on this rank
+        double per_call = timer["value"].to_float64() / count;
+        
+        double *timer_stats = &stats[i * num_stats];
+        timer_stats[detail::STAT_NUM_RANKS] = 1.0;
+        timer_stats[detail::STAT_SUM]       = per_call;
+        timer_stats[detail::STAT_SUM_SQ]    = per_call * per_call;
+        timer_stats[detail::STAT_MIN]       = per_call;
+        timer_stats[detail::STAT_MIN_RANK]  = rank;
+        timer_stats[detail::STAT_MAX]       = per_call;
+        timer_stats[detail::STAT_MAX_RANK]  = rank;
+        timer_stats[detail::STAT_CALLS]     = count;
+        timer_stats[detail::STAT_SYS_MEM]   = timer["sysMemUsed"].to_float64();
+        timer_stats[detail::STAT_PROC_MEM]  = timer["procMemMB"].to_float64();
+
+        if(s_counters_enabled)
         {
-          recv(recvNodes[i], // node
-               i, // source
-               42, // tag
-               MPI_COMM_WORLD // comm
-               );
-           }
-     }
-     else 
-     { 
-         send(thisRanksNode, // node
-              0, // dest
-              42, // tag
-              MPI_COMM_WORLD // comm
-              );
-    }
-
-    if (rank == 0)
-    {
-        for (unsigned int i = 1; i < numProcesses; ++i)
+            timer_stats[detail::STAT_COUNTERS_REQ] = 1.0;
+        }
+
+        if(timer.has_child("counters"))
         {
-            Reduce(thisRanksNode.fetch("children"),
-                   recvNodes[i].fetch("children"));
+            for(int c = 0; c < PerfCounters::NUM_COUNTERS; c++)
+            {
+                const char *counter_name = PerfCounters::Name(c);
+                if(timer["counters"].has_child(counter_name))
+                {
+                    double *counter_stats = timer_stats + detail::STAT_COUNTERS + 2 * c;
+                    counter_stats[0] = timer["counters"][counter_name].to_float64();
+                    counter_stats[1] = count;
+                }
+            }
         }
     }
-  
-    // Get the average time per iteration
-    if(rank == 0)
+
+#ifdef PARALLEL
+    std::vector<double> reduced_stats(stats.size(), 0.0);
+    
+    if(!stats.empty())
     {
-        AverageByCount(s_global_root, numProcesses);
+        MPI_Op stats_op;
+        MPI_Op_create(&detail::timer_stats_op, 1, &stats_op);
+        MPI_Reduce(&stats[0], &reduced_stats[0], (int)stats.size(),
+                   MPI_DOUBLE, stats_op, 0, MPI_COMM_WORLD);
+        MPI_Op_free(&stats_op);
     }
-
-#else
-    AverageByCount(BlockTimer::GlobalRoot(),1);
+    
+    stats.swap(reduced_stats);
 #endif
+
+    reduced.reset();
+    
+    if(rank != 0)
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        const double *timer_stats = &stats[i * num_stats];
+        double n = timer_stats[detail::STAT_NUM_RANKS];
+        if(n == 0.0)
+        {
+            continue;
+        }
+        
+        double mean     = timer_stats[detail::STAT_SUM] / n;
+        double variance = timer_stats[detail::STAT_SUM_SQ] / n - mean * mean;
+
+        Node &timer = reduced[paths[i]];
+        // value and id are the slowest rank, as before
+        timer["value"]      = timer_stats[detail::STAT_MAX];
+        timer["id"]         = (int) timer_stats[detail::STAT_MAX_RANK];
+        timer["max"]        = timer_stats[detail::STAT_MAX];
+        timer["maxid"]      = (int) timer_stats[detail::STAT_MAX_RANK];
+        timer["min"]        = timer_stats[detail::STAT_MIN];
+        timer["minid"]      = (int) timer_stats[detail::STAT_MIN_RANK];
+        timer["avg"]        = mean;
+        timer["stddev"]     = sqrt(std::max(variance, 0.0));
+        timer["ranks"]      = (int) n;
+        // calls per rank
+        timer["count"]      = (uint32) (timer_stats[detail::STAT_CALLS] / n);
+        timer["sysMemUsed"] = (uint64) (timer_stats[detail::STAT_SYS_MEM] / n);
+        timer["procMemMB"]  = (int) (timer_stats[detail::STAT_PROC_MEM] / n);
+
+        if(timer_stats[detail::STAT_COUNTERS_REQ] > 0.0)
+        {
+            // mean counts per call
+            Node &counters = timer["counters"];
+            for(int c = 0; c < PerfCounters::NUM_COUNTERS; c++)
+            {
+                const double *counter_stats = timer_stats + detail::STAT_COUNTERS + 2 * c;
+                if(counter_stats[1] > 0.0)
+                {
+                    counters[PerfCounters::Name(c)] = counter_stats[0] / counter_stats[1];
+                }
+                else
+                {
+                    counters[PerfCounters::Name(c)] = "unavailable";
+                }
+            }
+
+            if(counters["cycles"].dtype().is_number() &&
+               counters["instructions"].dtype().is_number() &&
+               counters["cycles"].to_float64() > 0.0)
+            {
+                counters["ipc"] = counters["instructions"].to_float64() /
+                                  counters["cycles"].to_float64();
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void BlockTimer::MergeThreadStates()
+{
+    std::lock_guard<std::mutex> lock(s_thread_states_mutex);
+    
+    s_global_root.reset();
+    for(size_t i = 0; i < s_thread_states.size(); i++)
+    {
+        detail::merge_timer_trees(s_thread_states[i]->m_root, s_global_root);
+    }
 }
 
 //-----------------------------------------------------------------------------
 void BlockTimer::ReduceGlobalRoot()
 {
-    ReduceAll(GlobalRoot());
+    MergeThreadStates();
+    ReduceAll(GlobalRoot(), s_reduced_root);
 }
 
 //-----------------------------------------------------------------------------
@@ -486,9 +899,241 @@ void BlockTimer::WriteLogFile()
     
     if(s_rank == 0 )
     {   
-        GlobalRoot().print();
-        GlobalRoot().to_json_stream(logfile.c_str(), "json", 2, 5);
+        s_reduced_root.print();
+        s_reduced_root.to_json_stream(logfile.c_str(), "json", 2, 5);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BlockTimer::EnableCounters()
+{
+    if(!s_counters_enabled)
+    {
+        // each thread opens its own counters on first use, check here that
+        // they can be opened at all
+        ThreadState &state = LocalState();
+        state.m_counters.Open();
+        state.m_counters_open = true;
+        s_counters_enabled    = true;
+        
+        if(!state.m_counters.Available())
+        {
+            CONDUIT_INFO("Hardware counters are unavailable "
+                         "(see /proc/sys/kernel/perf_event_paranoid)");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+BlockTimer::CountersAvailable()
+{
+    ThreadState &state = LocalState();
+    return s_counters_enabled && state.m_counters.Available();
+}
+
+//-----------------------------------------------------------------------------
+void
+BlockTimer::EnableTracing(int max_events)
+{
+    if(max_events < 1)
+    {
+        max_events = 1;
     }
+
+#ifdef PARALLEL
+    MPI_Comm_rank(MPI_COMM_WORLD, &s_rank);
+#endif
+
+    {
+        // restart the existing buffers
+        std::lock_guard<std::mutex> lock(s_thread_states_mutex);
+        for(size_t i = 0; i < s_thread_states.size(); i++)
+        {
+            ThreadState &state = *s_thread_states[i];
+            state.m_trace_events.clear();
+            state.m_trace_head    = 0;
+            state.m_trace_wrapped = false;
+        }
+    }
+
+    s_trace_max_events = max_events;
+    s_tracing          = true;
+}
+
+//-----------------------------------------------------------------------------
+bool
+BlockTimer::TracingEnabled()
+{
+    return s_tracing;
+}
+
+//-----------------------------------------------------------------------------
+void
+BlockTimer::SetCycle(uint64 cycle)
+{
+    s_cycle = cycle;
+}
+
+//-----------------------------------------------------------------------------
+void
+BlockTimer::RecordEvent(ThreadState &state,
+                        const std::string &name,
+                        const timeval &start,
+                        const timeval &end)
+{
+    TraceEvent event;
+    event.m_start    = (double)start.tv_sec * 1000000.0 + (double)start.tv_usec;
+    event.m_duration = (double)(end.tv_sec - start.tv_sec) * 1000000.0 +
+                       (double)(end.tv_usec - start.tv_usec);
+    event.m_rank     = s_rank;
+    event.m_thread   = state.m_thread_index;
+    event.m_cycle    = s_cycle;
+
+    std::map<std::string, int>::iterator itr = state.m_trace_name_ids.find(name);
+    if(itr == state.m_trace_name_ids.end())
+    {
+        event.m_name_id = (int)state.m_trace_names.size();
+        state.m_trace_name_ids[name] = event.m_name_id;
+        state.m_trace_names.push_back(name);
+    }
+    else
+    {
+        event.m_name_id = itr->second;
+    }
+
+    if(state.m_trace_events.empty())
+    {
+        state.m_trace_events.resize(s_trace_max_events);
+        state.m_trace_head    = 0;
+        state.m_trace_wrapped = false;
+    }
+
+    state.m_trace_events[state.m_trace_head] = event;
+    state.m_trace_head++;
+    if(state.m_trace_head == state.m_trace_events.size())
+    {
+        state.m_trace_head    = 0;
+        state.m_trace_wrapped = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BlockTimer::WriteTraceFile(const std::string &file_name)
+{
+    // oldest to newest per thread, with the thread name ids mapped to one
+    // name table for this rank
+    std::vector<TraceEvent>  events;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(s_thread_states_mutex);
+        
+        std::map<std::string, int> name_ids;
+        
+        for(size_t t = 0; t < s_thread_states.size(); t++)
+        {
+            const ThreadState &state = *s_thread_states[t];
+            size_t first_event = events.size();
+            
+            if(state.m_trace_wrapped)
+            {
+                events.insert(events.end(),
+                              state.m_trace_events.begin() + state.m_trace_head,
+                              state.m_trace_events.end());
+            }
+            events.insert(events.end(),
+                          state.m_trace_events.begin(),
+                          state.m_trace_events.begin() + state.m_trace_head);
+
+            for(size_t i = first_event; i < events.size(); i++)
+            {
+                const std::string &name = state.m_trace_names[events[i].m_name_id];
+                std::map<std::string, int>::iterator itr = name_ids.find(name);
+                if(itr == name_ids.end())
+                {
+                    int name_id = (int)names.size();
+                    name_ids[name] = name_id;
+                    names.push_back(name);
+                    events[i].m_name_id = name_id;
+                }
+                else
+                {
+                    events[i].m_name_id = itr->second;
+                }
+            }
+        }
+    }
+
+    // find the earliest event, so timestamps start near zero
+    double t0 = -1.0;
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        if(t0 < 0.0 || events[i].m_start < t0)
+        {
+            t0 = events[i].m_start;
+        }
+    }
+
+    std::string rank_file_name = file_name;
+
+#ifdef PARALLEL
+    //
+    // Each rank writes its own file, so no rank has to hold the events of
+    // all the others. The ranks only agree on the time origin, which
+    // lines up their timelines when the files are loaded together.
+    //
+    int rank = 0;
+    int num_ranks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+
+    double local_t0 = events.empty() ? std::numeric_limits<double>::max() : t0;
+    MPI_Allreduce(&local_t0, &t0, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+
+    if(num_ranks > 1)
+    {
+        rank_file_name = detail::rank_trace_file_name(file_name, rank);
+    }
+#endif
+
+    std::ofstream ofs(rank_file_name.c_str());
+    if(!ofs.is_open())
+    {
+        CONDUIT_INFO("Failed to open trace file " << rank_file_name);
+        return;
+    }
+
+    // timestamps are in micro seconds
+    ofs << std::fixed << std::setprecision(1);
+    ofs << "{\"traceEvents\":[\n";
+
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent &e = events[i];
+        std::string name = "unknown";
+        if(e.m_name_id >= 0 && e.m_name_id < (int)names.size())
+        {
+            name = names[e.m_name_id];
+        }
+        
+        if(i > 0)
+        {
+            ofs << ",\n";
+        }
+
+        ofs << "{\"name\":\"" << name << "\","
+            << "\"cat\":\"strawman\","
+            << "\"ph\":\"X\","
+            << "\"ts\":"  << (e.m_start - t0) << ","
+            << "\"dur\":" << e.m_duration << ","
+            << "\"pid\":" << e.m_rank << ","
+            << "\"tid\":" << e.m_thread << ","
+            << "\"args\":{\"cycle\":" << e.m_cycle << "}}";
+    }
+
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
 }
 
 //-----------------------------------------------------------------------------
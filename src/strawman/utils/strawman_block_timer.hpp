@@ -56,12 +56,17 @@
 
 #include<sys/time.h>
 #include <string>
+#include <vector>
 #include <map>
 #include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include <cstdlib>
     
 #include <conduit.hpp>
 #include <strawman_config.h>
+#include <strawman_perf_counters.hpp>
 
 //-----------------------------------------------------------------------------
 // -- begin strawman:: --
@@ -69,6 +74,13 @@
 namespace strawman
 {
 
+//-----------------------------------------------------------------------------
+//
+// BlockTimer times nested blocks of code. Each thread keeps its own timer
+// stack and tree, so timers can run concurrently without locks. The trees
+// of all threads are merged by Finalize (and WriteLogFile), which must be
+// called when no timers are running on other threads.
+//
 //-----------------------------------------------------------------------------
 class BlockTimer
 {
@@ -81,6 +93,28 @@ public:
     static conduit::Node &Finalize();
     static void           WriteLogFile();
 
+    // seconds the last finished block with this name took on the calling
+    // thread (also past MAX_DEPTH), 0 if none finished yet
+    static double         LastElapsed(const std::string &name);
+
+    // Counts hardware events (cycles, instructions, llc misses and branch
+    // misses) per timer via perf_event_open. Reduced results report
+    // "unavailable" for counters that could not be opened.
+    static void EnableCounters();
+    static bool CountersAvailable();
+
+    // Tracing records every timed block as an event (with rank, thread and
+    // cycle) in a per thread ring buffer that keeps the newest max_events 
+    // events.
+    static void EnableTracing(int max_events = 65536);
+    static bool TracingEnabled();
+    // cycle attached to the events that follow
+    static void SetCycle(conduit::uint64 cycle);
+    // writes this rank's events in the chrome trace event format
+    // (chrome://tracing or perfetto). with more than one rank, each rank
+    // writes its own file with the rank inserted before the extension.
+    static void WriteTraceFile(const std::string &file_name = "strawman_trace.json");
+
 private:
     
     static void Start(const std::string &name);
@@ -89,42 +123,66 @@ private:
         {return s_global_root;}
 
     static void ReduceGlobalRoot();
-    
-    // non-static methods
+
+    struct TraceEvent
+    {
+        double          m_start;    // micro seconds since the epoch
+        double          m_duration; // micro seconds
+        int             m_name_id;  // index into the trace names
+        int             m_rank;
+        int             m_thread;
+        conduit::uint64 m_cycle;
+    };
+
+    // timer state of one thread (defined in the source file)
+    struct ThreadState;
+
+    // the calling thread's state, registered on first use
+    static ThreadState &LocalState();
+
+    // merges the timer trees of all threads into the global root
+    static void MergeThreadStates();
+
+    static void RecordEvent(ThreadState &state,
+                            const std::string &name,
+                            const timeval &start,
+                            const timeval &end);
     
     // Initializes values if the current location hasn't been visited yet,
     // and updates the set of visited locations.
-    static void Precheck();
+    static void Precheck(ThreadState &state);
 
     // Goes up one function in the current location path.
-    static void GoUp();
+    static void GoUp(ThreadState &state);
+
+    static conduit::Node &CurrentNode(ThreadState &state);
 
     // non-static data members
     std::string m_name;
 
     // private static methods
-    static void ReduceAll(conduit::Node &);
-    static conduit::Node &CurrentNode();
-    
-    static void Reduce(conduit::Node &,
-                       conduit::Node &);
-
-    static bool CheckForKnownPath(std::string &);
-
-    static void AverageByCount(conduit::Node &,
-                               int);
-    static void FillDataArray(conduit::Node &,
-                              const int &,
-                              double &,
-                              double [][3],
-                              std::string);
+
+    // reduces the timers of all ranks to rank 0: for each timer the 
+    // min/max/mean/stddev of the per call time over the ranks, with
+    // the ranks of the min and max.
+    static void ReduceAll(const conduit::Node &local,
+                          conduit::Node &reduced);
+
     // static data members 
     static conduit::Node                  s_global_root;
+    static conduit::Node                  s_reduced_root;
     static int                            s_rank; // MPI rank
-    static int                            s_global_depth;
-    static std::string                    s_current_path;
-    static std::map<std::string, timeval> s_timers;
-    static std::set<std::string>          s_visited;
+    // only the main thread makes MPI calls
+    static std::thread::id                s_main_thread;
+
+    // per thread states, owned here so they outlive their threads
+    static std::vector<ThreadState*>      s_thread_states;
+    static std::mutex                     s_thread_states_mutex;
+
+    static std::atomic<bool>              s_counters_enabled;
+    static std::atomic<bool>              s_tracing;
+    static std::atomic<int>               s_trace_max_events;
+    static std::atomic<conduit::uint64>   s_cycle;
     
 };
 
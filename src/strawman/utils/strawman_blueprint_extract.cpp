@@ -0,0 +1,967 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_blueprint_extract.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_blueprint_extract.hpp"
+
+#include "strawman_logging.hpp"
+
+// standard includes
+#include <cmath>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+typedef std::map<std::string, std::vector<float64> > FieldMap;
+
+//-----------------------------------------------------------------------------
+// single shape unstructured mesh the filters operate on
+//-----------------------------------------------------------------------------
+struct ExtractMesh
+{
+    std::string           m_coordset_name;
+    std::string           m_topo_name;
+    // number of coordinate axes
+    int                   m_dims;
+    std::string           m_shape;
+    int                   m_shape_size;
+    std::vector<float64>  m_coords[3];
+    std::vector<int32>    m_conn;
+    FieldMap              m_point_fields;
+    FieldMap              m_cell_fields;
+
+    index_t NumPoints() const { return (index_t) m_coords[0].size(); }
+    index_t NumCells()  const { return (index_t) m_conn.size() / m_shape_size; }
+};
+
+//-----------------------------------------------------------------------------
+int
+shape_size(const std::string &shape)
+{
+    if(shape == "line")
+    {
+        return 2;
+    }
+    else if(shape == "tri")
+    {
+        return 3;
+    }
+    else if(shape == "quad" || shape == "tet")
+    {
+        return 4;
+    }
+    else if(shape == "hex")
+    {
+        return 8;
+    }
+
+    STRAWMAN_ERROR("extract: unsupported element shape " << shape);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+void
+read_float64_values(const Node &values, std::vector<float64> &res)
+{
+    Node n_f64;
+    values.to_float64_array(n_f64);
+    const float64 *vals = n_f64.as_float64_ptr();
+    res.assign(vals, vals + values.dtype().number_of_elements());
+}
+
+//-----------------------------------------------------------------------------
+// creates the points of a logically structured coordset
+//-----------------------------------------------------------------------------
+void
+make_structured_points(const std::vector<float64> axes[3],
+                       int dims,
+                       ExtractMesh &mesh)
+{
+    index_t npts[3] = {1, 1, 1};
+    for(int a = 0; a < dims; a++)
+    {
+        npts[a] = (index_t) axes[a].size();
+    }
+
+    index_t num_points = npts[0] * npts[1] * npts[2];
+    for(int a = 0; a < dims; a++)
+    {
+        mesh.m_coords[a].resize(num_points);
+    }
+
+    index_t idx = 0;
+    for(index_t k = 0; k < npts[2]; k++)
+    {
+        for(index_t j = 0; j < npts[1]; j++)
+        {
+            for(index_t i = 0; i < npts[0]; i++, idx++)
+            {
+                mesh.m_coords[0][idx] = axes[0][i];
+                mesh.m_coords[1][idx] = axes[1][j];
+                if(dims == 3)
+                {
+                    mesh.m_coords[2][idx] = axes[2][k];
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// reads the coordset, returns the number of points along each axis for
+// uniform and rectilinear coordsets
+//-----------------------------------------------------------------------------
+void
+load_coords(const Node &n_coords,
+            ExtractMesh &mesh,
+            index_t point_dims[3])
+{
+    static const char *axis_names[3] = {"x", "y", "z"};
+    static const char *dim_names[3]  = {"i", "j", "k"};
+    static const char *spacing_names[3] = {"dx", "dy", "dz"};
+
+    const std::string type = n_coords["type"].as_string();
+    point_dims[0] = point_dims[1] = point_dims[2] = 1;
+
+    if(type == "uniform")
+    {
+        const Node &n_dims = n_coords["dims"];
+        mesh.m_dims = n_dims.has_child("k") ? 3 : 2;
+
+        std::vector<float64> axes[3];
+        for(int a = 0; a < mesh.m_dims; a++)
+        {
+            point_dims[a] = n_dims[dim_names[a]].to_index_t();
+
+            float64 origin  = 0.0;
+            float64 spacing = 1.0;
+            if(n_coords.has_path(std::string("origin/") + axis_names[a]))
+            {
+                origin = n_coords["origin"][axis_names[a]].to_float64();
+            }
+            if(n_coords.has_path(std::string("spacing/") + spacing_names[a]))
+            {
+                spacing = n_coords["spacing"][spacing_names[a]].to_float64();
+            }
+
+            axes[a].resize(point_dims[a]);
+            for(index_t i = 0; i < point_dims[a]; i++)
+            {
+                axes[a][i] = origin + i * spacing;
+            }
+        }
+        make_structured_points(axes, mesh.m_dims, mesh);
+    }
+    else if(type == "rectilinear")
+    {
+        const Node &n_vals = n_coords["values"];
+        mesh.m_dims = n_vals.has_child("z") ? 3 : 2;
+
+        std::vector<float64> axes[3];
+        for(int a = 0; a < mesh.m_dims; a++)
+        {
+            read_float64_values(n_vals[axis_names[a]], axes[a]);
+            point_dims[a] = (index_t) axes[a].size();
+        }
+        make_structured_points(axes, mesh.m_dims, mesh);
+    }
+    else if(type == "explicit")
+    {
+        const Node &n_vals = n_coords["values"];
+        mesh.m_dims = n_vals.has_child("z") ? 3 : 2;
+
+        for(int a = 0; a < mesh.m_dims; a++)
+        {
+            read_float64_values(n_vals[axis_names[a]], mesh.m_coords[a]);
+        }
+    }
+    else
+    {
+        STRAWMAN_ERROR("extract: unsupported coordset type " << type);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// creates quads or hexes for a logically structured topology
+//-----------------------------------------------------------------------------
+void
+make_structured_cells(const index_t point_dims[3],
+                      int dims,
+                      ExtractMesh &mesh)
+{
+    const index_t nx = point_dims[0];
+    const index_t ny = point_dims[1];
+
+    if(dims == 2)
+    {
+        mesh.m_shape = "quad";
+        mesh.m_shape_size = 4;
+        mesh.m_conn.reserve((nx - 1) * (ny - 1) * 4);
+
+        for(index_t j = 0; j < ny - 1; j++)
+        {
+            for(index_t i = 0; i < nx - 1; i++)
+            {
+                int32 p = (int32) (j * nx + i);
+                mesh.m_conn.push_back(p);
+                mesh.m_conn.push_back(p + 1);
+                mesh.m_conn.push_back(p + 1 + nx);
+                mesh.m_conn.push_back(p + nx);
+            }
+        }
+        return;
+    }
+
+    const index_t nz = point_dims[2];
+    const index_t nxy = nx * ny;
+
+    mesh.m_shape = "hex";
+    mesh.m_shape_size = 8;
+    mesh.m_conn.reserve((nx - 1) * (ny - 1) * (nz - 1) * 8);
+
+    for(index_t k = 0; k < nz - 1; k++)
+    {
+        for(index_t j = 0; j < ny - 1; j++)
+        {
+            for(index_t i = 0; i < nx - 1; i++)
+            {
+                int32 p = (int32) (k * nxy + j * nx + i);
+                mesh.m_conn.push_back(p);
+                mesh.m_conn.push_back(p + 1);
+                mesh.m_conn.push_back(p + 1 + nx);
+                mesh.m_conn.push_back(p + nx);
+                mesh.m_conn.push_back(p + nxy);
+                mesh.m_conn.push_back(p + nxy + 1);
+                mesh.m_conn.push_back(p + nxy + 1 + nx);
+                mesh.m_conn.push_back(p + nxy + nx);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+load_mesh(const Node &data,
+          const std::string &topo_name,
+          ExtractMesh &mesh)
+{
+    if(!data.has_path("topologies/" + topo_name))
+    {
+        STRAWMAN_ERROR("extract: unknown topology " << topo_name);
+    }
+
+    const Node &n_topo = data["topologies"][topo_name];
+    const std::string topo_type = n_topo["type"].as_string();
+
+    mesh.m_topo_name     = topo_name;
+    mesh.m_coordset_name = n_topo["coordset"].as_string();
+
+    index_t point_dims[3];
+    load_coords(data["coordsets"][mesh.m_coordset_name], mesh, point_dims);
+
+    if(topo_type == "uniform" || topo_type == "rectilinear")
+    {
+        make_structured_cells(point_dims, mesh.m_dims, mesh);
+    }
+    else if(topo_type == "structured")
+    {
+        static const char *dim_names[3] = {"i", "j", "k"};
+        const Node &n_dims = n_topo["elements/dims"];
+        int dims = n_dims.has_child("k") ? 3 : 2;
+        for(int a = 0; a < dims; a++)
+        {
+            point_dims[a] = n_dims[dim_names[a]].to_index_t() + 1;
+        }
+        make_structured_cells(point_dims, dims, mesh);
+    }
+    else if(topo_type == "unstructured")
+    {
+        mesh.m_shape      = n_topo["elements/shape"].as_string();
+        mesh.m_shape_size = shape_size(mesh.m_shape);
+
+        Node n_conn;
+        n_topo["elements/connectivity"].to_int32_array(n_conn);
+        const int32 *conn = n_conn.as_int32_ptr();
+        mesh.m_conn.assign(conn, conn + n_conn.dtype().number_of_elements());
+    }
+    else
+    {
+        STRAWMAN_ERROR("extract: unsupported topology type " << topo_type);
+    }
+
+    //
+    // scalar fields of the topology
+    //
+    if(!data.has_child("fields"))
+    {
+        return;
+    }
+
+    NodeConstIterator itr = data["fields"].children();
+    while(itr.has_next())
+    {
+        const Node &n_field = itr.next();
+        const std::string field_name = itr.name();
+
+        if(!n_field.has_child("topology") ||
+           n_field["topology"].as_string() != topo_name ||
+           !n_field.has_child("values") ||
+           n_field["values"].number_of_children() > 0)
+        {
+            continue;
+        }
+
+        const std::string assoc = n_field["association"].as_string();
+        index_t num_vals = n_field["values"].dtype().number_of_elements();
+
+        if(assoc == "vertex" && num_vals == mesh.NumPoints())
+        {
+            read_float64_values(n_field["values"],
+                                mesh.m_point_fields[field_name]);
+        }
+        else if(assoc == "element" && num_vals == mesh.NumCells())
+        {
+            read_float64_values(n_field["values"],
+                                mesh.m_cell_fields[field_name]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// copies the points used by the elements of conn from in to out, and
+// renumbers conn
+//-----------------------------------------------------------------------------
+void
+compact_points(const ExtractMesh &in,
+               ExtractMesh &out)
+{
+    std::vector<int32> point_map(in.NumPoints(), -1);
+    int32 num_points = 0;
+
+    for(size_t i = 0; i < out.m_conn.size(); i++)
+    {
+        int32 &p = out.m_conn[i];
+        if(point_map[p] < 0)
+        {
+            point_map[p] = num_points++;
+        }
+        p = point_map[p];
+    }
+
+    std::vector<int32> old_ids(num_points);
+    for(size_t i = 0; i < point_map.size(); i++)
+    {
+        if(point_map[i] >= 0)
+        {
+            old_ids[point_map[i]] = (int32) i;
+        }
+    }
+
+    for(int a = 0; a < in.m_dims; a++)
+    {
+        out.m_coords[a].resize(num_points);
+        for(int32 i = 0; i < num_points; i++)
+        {
+            out.m_coords[a][i] = in.m_coords[a][old_ids[i]];
+        }
+    }
+
+    FieldMap::const_iterator itr;
+    for(itr = in.m_point_fields.begin(); itr != in.m_point_fields.end(); ++itr)
+    {
+        std::vector<float64> &vals = out.m_point_fields[itr->first];
+        vals.resize(num_points);
+        for(int32 i = 0; i < num_points; i++)
+        {
+            vals[i] = itr->second[old_ids[i]];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+copy_mesh_info(const ExtractMesh &in, ExtractMesh &out)
+{
+    out.m_coordset_name = in.m_coordset_name;
+    out.m_topo_name     = in.m_topo_name;
+    out.m_dims          = in.m_dims;
+}
+
+//-----------------------------------------------------------------------------
+void
+threshold(const ExtractMesh &in,
+          const std::string &field_name,
+          float64 min_value,
+          float64 max_value,
+          ExtractMesh &out)
+{
+    copy_mesh_info(in, out);
+    out.m_shape      = in.m_shape;
+    out.m_shape_size = in.m_shape_size;
+
+    const std::vector<float64> *cell_vals  = NULL;
+    const std::vector<float64> *point_vals = NULL;
+
+    if(in.m_cell_fields.find(field_name) != in.m_cell_fields.end())
+    {
+        cell_vals = &in.m_cell_fields.find(field_name)->second;
+    }
+    else if(in.m_point_fields.find(field_name) != in.m_point_fields.end())
+    {
+        point_vals = &in.m_point_fields.find(field_name)->second;
+    }
+    else
+    {
+        STRAWMAN_ERROR("extract: threshold field " << field_name
+                       << " is not a scalar field of topology "
+                       << in.m_topo_name);
+    }
+
+    const int ss = in.m_shape_size;
+    const index_t num_cells = in.NumCells();
+    std::vector<index_t> kept;
+
+    for(index_t c = 0; c < num_cells; c++)
+    {
+        bool keep = true;
+        if(cell_vals != NULL)
+        {
+            float64 v = (*cell_vals)[c];
+            keep = v >= min_value && v <= max_value;
+        }
+        else
+        {
+            for(int i = 0; i < ss && keep; i++)
+            {
+                float64 v = (*point_vals)[in.m_conn[c * ss + i]];
+                keep = v >= min_value && v <= max_value;
+            }
+        }
+
+        if(keep)
+        {
+            kept.push_back(c);
+        }
+    }
+
+    out.m_conn.resize(kept.size() * ss);
+    for(size_t c = 0; c < kept.size(); c++)
+    {
+        for(int i = 0; i < ss; i++)
+        {
+            out.m_conn[c * ss + i] = in.m_conn[kept[c] * ss + i];
+        }
+    }
+
+    FieldMap::const_iterator itr;
+    for(itr = in.m_cell_fields.begin(); itr != in.m_cell_fields.end(); ++itr)
+    {
+        std::vector<float64> &vals = out.m_cell_fields[itr->first];
+        vals.resize(kept.size());
+        for(size_t c = 0; c < kept.size(); c++)
+        {
+            vals[c] = itr->second[kept[c]];
+        }
+    }
+
+    compact_points(in, out);
+}
+
+//-----------------------------------------------------------------------------
+// points of a contour are interpolated on edges of the input, edges are
+// shared so each point is only created once
+//-----------------------------------------------------------------------------
+class ContourPoints
+{
+public:
+    ContourPoints(const std::vector<float64> &values,
+                  float64 iso_value)
+    : m_values(values),
+      m_iso_value(iso_value)
+    {}
+
+    int32 EdgePoint(int32 a, int32 b)
+    {
+        if(a > b)
+        {
+            std::swap(a, b);
+        }
+
+        uint64 key = (((uint64) a) << 32) | (uint64) (uint32) b;
+        std::unordered_map<uint64, int32>::iterator itr = m_edges.find(key);
+        if(itr != m_edges.end())
+        {
+            return itr->second;
+        }
+
+        float64 t = (m_iso_value - m_values[a]) / (m_values[b] - m_values[a]);
+        int32 id = (int32) m_a.size();
+        m_a.push_back(a);
+        m_b.push_back(b);
+        m_t.push_back(t);
+        m_edges[key] = id;
+        return id;
+    }
+
+    void Interpolate(const std::vector<float64> &in,
+                     std::vector<float64> &out) const
+    {
+        out.resize(m_a.size());
+        for(size_t i = 0; i < m_a.size(); i++)
+        {
+            out[i] = in[m_a[i]] + m_t[i] * (in[m_b[i]] - in[m_a[i]]);
+        }
+    }
+
+private:
+    const std::vector<float64> &m_values;
+    float64                     m_iso_value;
+    std::unordered_map<uint64, int32> m_edges;
+    std::vector<int32>          m_a;
+    std::vector<int32>          m_b;
+    std::vector<float64>        m_t;
+};
+
+//-----------------------------------------------------------------------------
+void
+contour(const ExtractMesh &in,
+        const std::vector<float64> &values,
+        float64 iso_value,
+        ExtractMesh &out)
+{
+    // hexes are split into six tets around the 0-6 diagonal, which
+    // matches the face diagonals of neighboring hexes
+    static const int hex_tets[6][4] = { {0, 1, 2, 6},
+                                        {0, 2, 3, 6},
+                                        {0, 3, 7, 6},
+                                        {0, 7, 4, 6},
+                                        {0, 4, 5, 6},
+                                        {0, 5, 1, 6} };
+    static const int tet_tets[1][4] = { {0, 1, 2, 3} };
+    static const int quad_tris[2][3] = { {0, 1, 2}, {0, 2, 3} };
+    static const int tri_tris[1][3]  = { {0, 1, 2} };
+
+    const int *simplices = NULL;
+    int num_simplices = 0;
+    int simplex_size  = 0;
+
+    if(in.m_shape == "hex")
+    {
+        simplices = &hex_tets[0][0];
+        num_simplices = 6;
+        simplex_size  = 4;
+    }
+    else if(in.m_shape == "tet")
+    {
+        simplices = &tet_tets[0][0];
+        num_simplices = 1;
+        simplex_size  = 4;
+    }
+    else if(in.m_shape == "quad")
+    {
+        simplices = &quad_tris[0][0];
+        num_simplices = 2;
+        simplex_size  = 3;
+    }
+    else if(in.m_shape == "tri")
+    {
+        simplices = &tri_tris[0][0];
+        num_simplices = 1;
+        simplex_size  = 3;
+    }
+    else
+    {
+        STRAWMAN_ERROR("extract: can not contour " << in.m_shape
+                       << " elements");
+    }
+
+    copy_mesh_info(in, out);
+    out.m_shape      = simplex_size == 4 ? "tri" : "line";
+    out.m_shape_size = simplex_size - 1;
+
+    ContourPoints points(values, iso_value);
+    std::vector<index_t> parents;
+
+    const int ss = in.m_shape_size;
+    const index_t num_cells = in.NumCells();
+
+    for(index_t c = 0; c < num_cells; c++)
+    {
+        const int32 *cell = &in.m_conn[c * ss];
+
+        for(int s = 0; s < num_simplices; s++)
+        {
+            int32 ids[4];
+            int inside[4];
+            int num_inside = 0;
+
+            for(int i = 0; i < simplex_size; i++)
+            {
+                ids[i] = cell[simplices[s * simplex_size + i]];
+                inside[i] = values[ids[i]] > iso_value ? 1 : 0;
+                num_inside += inside[i];
+            }
+
+            if(num_inside == 0 || num_inside == simplex_size)
+            {
+                continue;
+            }
+
+            if(num_inside == 1 || num_inside == simplex_size - 1)
+            {
+                // one vertex is on its own side, the contour cuts the
+                // edges that connect it to the others
+                int lone = 0;
+                int lone_side = num_inside == 1 ? 1 : 0;
+                while(inside[lone] != lone_side)
+                {
+                    lone++;
+                }
+
+                for(int i = 0; i < simplex_size; i++)
+                {
+                    if(i != lone)
+                    {
+                        out.m_conn.push_back(points.EdgePoint(ids[lone], ids[i]));
+                    }
+                }
+                parents.push_back(c);
+            }
+            else
+            {
+                // two vertices on each side of a tet make a quad, which is
+                // split into two triangles
+                int a[2], b[2];
+                int na = 0, nb = 0;
+                for(int i = 0; i < 4; i++)
+                {
+                    if(inside[i])
+                    {
+                        a[na++] = ids[i];
+                    }
+                    else
+                    {
+                        b[nb++] = ids[i];
+                    }
+                }
+
+                int32 p0 = points.EdgePoint(a[0], b[0]);
+                int32 p1 = points.EdgePoint(a[0], b[1]);
+                int32 p2 = points.EdgePoint(a[1], b[1]);
+                int32 p3 = points.EdgePoint(a[1], b[0]);
+
+                out.m_conn.push_back(p0);
+                out.m_conn.push_back(p1);
+                out.m_conn.push_back(p2);
+                out.m_conn.push_back(p0);
+                out.m_conn.push_back(p2);
+                out.m_conn.push_back(p3);
+                parents.push_back(c);
+                parents.push_back(c);
+            }
+        }
+    }
+
+    for(int a = 0; a < in.m_dims; a++)
+    {
+        points.Interpolate(in.m_coords[a], out.m_coords[a]);
+    }
+
+    FieldMap::const_iterator itr;
+    for(itr = in.m_point_fields.begin(); itr != in.m_point_fields.end(); ++itr)
+    {
+        points.Interpolate(itr->second, out.m_point_fields[itr->first]);
+    }
+
+    for(itr = in.m_cell_fields.begin(); itr != in.m_cell_fields.end(); ++itr)
+    {
+        std::vector<float64> &vals = out.m_cell_fields[itr->first];
+        vals.resize(parents.size());
+        for(size_t c = 0; c < parents.size(); c++)
+        {
+            vals[c] = itr->second[parents[c]];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+isosurface(const ExtractMesh &in,
+           const std::string &field_name,
+           float64 iso_value,
+           ExtractMesh &out)
+{
+    FieldMap::const_iterator itr = in.m_point_fields.find(field_name);
+    if(itr == in.m_point_fields.end())
+    {
+        STRAWMAN_ERROR("extract: isosurface field " << field_name
+                       << " is not a vertex field of topology "
+                       << in.m_topo_name);
+    }
+
+    contour(in, itr->second, iso_value, out);
+}
+
+//-----------------------------------------------------------------------------
+void
+slice(const ExtractMesh &in,
+      const Node &n_origin,
+      const Node &n_normal,
+      ExtractMesh &out)
+{
+    std::vector<float64> origin, normal;
+    read_float64_values(n_origin, origin);
+    read_float64_values(n_normal, normal);
+
+    if(origin.size() < (size_t) in.m_dims || normal.size() < (size_t) in.m_dims)
+    {
+        STRAWMAN_ERROR("extract: slice origin and normal need "
+                       << in.m_dims << " components");
+    }
+
+    // signed distance to the plane
+    std::vector<float64> dist(in.NumPoints(), 0.0);
+    for(int a = 0; a < in.m_dims; a++)
+    {
+        for(index_t i = 0; i < in.NumPoints(); i++)
+        {
+            dist[i] += (in.m_coords[a][i] - origin[a]) * normal[a];
+        }
+    }
+
+    contour(in, dist, 0.0, out);
+}
+
+//-----------------------------------------------------------------------------
+void
+to_blueprint(const ExtractMesh &mesh, Node &out)
+{
+    static const char *axis_names[3] = {"x", "y", "z"};
+
+    Node &n_coords = out["coordsets"][mesh.m_coordset_name];
+    n_coords["type"] = "explicit";
+    for(int a = 0; a < mesh.m_dims; a++)
+    {
+        n_coords["values"][axis_names[a]].set(mesh.m_coords[a]);
+    }
+
+    Node &n_topo = out["topologies"][mesh.m_topo_name];
+    n_topo["type"]     = "unstructured";
+    n_topo["coordset"] = mesh.m_coordset_name;
+    n_topo["elements/shape"] = mesh.m_shape;
+    n_topo["elements/connectivity"].set(mesh.m_conn);
+
+    FieldMap::const_iterator itr;
+    for(itr = mesh.m_point_fields.begin(); itr != mesh.m_point_fields.end(); ++itr)
+    {
+        Node &n_field = out["fields"][itr->first];
+        n_field["association"] = "vertex";
+        n_field["topology"]    = mesh.m_topo_name;
+        n_field["values"].set(itr->second);
+    }
+
+    for(itr = mesh.m_cell_fields.begin(); itr != mesh.m_cell_fields.end(); ++itr)
+    {
+        Node &n_field = out["fields"][itr->first];
+        n_field["association"] = "element";
+        n_field["topology"]    = mesh.m_topo_name;
+        n_field["values"].set(itr->second);
+    }
+}
+
+//-----------------------------------------------------------------------------
+std::string
+extract_topology(const Node &mesh, const Node &options)
+{
+    if(options.has_child("topology"))
+    {
+        return options["topology"].as_string();
+    }
+
+    // the topology of the first field a filter uses
+    if(options.has_child("filters"))
+    {
+        NodeConstIterator itr = options["filters"].children();
+        while(itr.has_next())
+        {
+            const Node &filter = itr.next();
+            if(filter.has_child("field_name"))
+            {
+                const std::string field_name = filter["field_name"].as_string();
+                if(!mesh.has_path("fields/" + field_name))
+                {
+                    STRAWMAN_ERROR("extract: unknown field " << field_name);
+                }
+                return mesh["fields"][field_name]["topology"].as_string();
+            }
+        }
+    }
+
+    return mesh["topologies"].child(0).name();
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void
+extract_mesh(const Node &mesh,
+             const Node &options,
+             Node &extract)
+{
+    if(!options.has_child("filters"))
+    {
+        STRAWMAN_ERROR("extract: missing filters");
+    }
+
+    detail::ExtractMesh current;
+    detail::load_mesh(mesh,
+                      detail::extract_topology(mesh, options),
+                      current);
+
+    NodeConstIterator itr = options["filters"].children();
+    while(itr.has_next())
+    {
+        const Node &filter = itr.next();
+        const std::string type = filter["type"].as_string();
+
+        detail::ExtractMesh next;
+
+        if(type == "threshold_filter")
+        {
+            detail::threshold(current,
+                              filter["field_name"].as_string(),
+                              filter["min_value"].to_float64(),
+                              filter["max_value"].to_float64(),
+                              next);
+        }
+        else if(type == "isosurface_filter")
+        {
+            detail::isosurface(current,
+                               filter["field_name"].as_string(),
+                               filter["iso_value"].to_float64(),
+                               next);
+        }
+        else if(type == "slice_filter")
+        {
+            detail::slice(current,
+                          filter["origin"],
+                          filter["normal"],
+                          next);
+        }
+        else
+        {
+            STRAWMAN_ERROR("extract: unsupported filter type " << type);
+        }
+
+        std::swap(current, next);
+    }
+
+    //
+    // only keep the requested fields
+    //
+    if(options.has_child("fields"))
+    {
+        std::set<std::string> keep;
+        NodeConstIterator f_itr = options["fields"].children();
+        while(f_itr.has_next())
+        {
+            keep.insert(f_itr.next().as_string());
+        }
+
+        detail::FieldMap *maps[2] = {&current.m_point_fields,
+                                     &current.m_cell_fields};
+        for(int m = 0; m < 2; m++)
+        {
+            detail::FieldMap::iterator m_itr = maps[m]->begin();
+            while(m_itr != maps[m]->end())
+            {
+                if(keep.find(m_itr->first) == keep.end())
+                {
+                    maps[m]->erase(m_itr++);
+                }
+                else
+                {
+                    ++m_itr;
+                }
+            }
+        }
+    }
+
+    extract.reset();
+    detail::to_blueprint(current, extract);
+
+    if(mesh.has_child("state"))
+    {
+        extract["state"].set(mesh["state"]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
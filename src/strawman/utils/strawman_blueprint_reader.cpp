@@ -0,0 +1,464 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_blueprint_reader.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_blueprint_reader.hpp"
+
+#include "strawman_compression.hpp"
+#include "strawman_logging.hpp"
+
+// standard includes
+#include <stdio.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// thirdparty includes
+//-----------------------------------------------------------------------------
+
+// conduit includes
+#include <conduit_relay.hpp>
+
+// mpi related includes
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
+using namespace conduit;
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+BlueprintReader::BlueprintReader()
+: m_root_dir(""),
+  m_num_domains(0),
+  m_trees_per_file(1),
+  m_num_rounds(0),
+  m_rank(0),
+  m_size(1),
+  m_mpi_comm_id(-1)
+{
+#ifdef PARALLEL
+    m_mpi_comm_id = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+BlueprintReader::~BlueprintReader()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::SetOptions(const Node &options)
+{
+    if(options.has_child("mpi_comm"))
+    {
+        m_mpi_comm_id = options["mpi_comm"].to_int();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::Open(const std::string &root_file)
+{
+    m_root.reset();
+    m_local_domains.clear();
+
+#ifdef PARALLEL
+    MPI_Comm mpi_comm = MPI_Comm_f2c(m_mpi_comm_id);
+    MPI_Comm_rank(mpi_comm, &m_rank);
+    MPI_Comm_size(mpi_comm, &m_size);
+#endif
+
+    // only rank 0 touches the root file, the other ranks get a copy
+    if(m_rank == 0)
+    {
+        try
+        {
+            relay::io::load(root_file,"hdf5",m_root);
+        }
+        catch(conduit::Error &e)
+        {
+            STRAWMAN_INFO("Failed to load " << root_file << ": " 
+                          << e.message());
+            m_root.reset();
+        }
+    }
+
+#ifdef PARALLEL
+    std::string schema_json;
+    std::vector<uint8> root_data;
+    
+    if(m_rank == 0 && !m_root.dtype().is_empty())
+    {
+        Schema s_compact;
+        m_root.schema().compact_to(s_compact);
+        schema_json = s_compact.to_json();
+        m_root.serialize(root_data);
+    }
+    
+    int sizes[2] = { (int)schema_json.size(), (int)root_data.size() };
+    MPI_Bcast(sizes, 2, MPI_INT, 0, mpi_comm);
+
+    if(sizes[0] > 0)
+    {
+        schema_json.resize(sizes[0]);
+        root_data.resize(sizes[1]);
+        MPI_Bcast(&schema_json[0], sizes[0], MPI_CHAR, 0, mpi_comm);
+        MPI_Bcast(&root_data[0], sizes[1], MPI_BYTE, 0, mpi_comm);
+
+        if(m_rank != 0)
+        {
+            Node n_root(Schema(schema_json), &root_data[0], true);
+            m_root.set(n_root);
+        }
+    }
+#endif
+
+    if(m_root.dtype().is_empty())
+    {
+        STRAWMAN_ERROR("Failed to read blueprint root file: " << root_file);
+    }
+
+    if(!m_root.has_child("number_of_trees") ||
+       !m_root.has_child("file_pattern")    ||
+       !m_root.has_child("tree_pattern"))
+    {
+        STRAWMAN_ERROR(root_file << " is not a blueprint root file, it must"
+                       " provide number_of_trees, file_pattern and"
+                       " tree_pattern");
+    }
+
+    m_num_domains = m_root["number_of_trees"].to_int();
+
+    if(m_num_domains < 1)
+    {
+        STRAWMAN_ERROR(root_file << " does not contain any domains");
+    }
+
+    // the file pattern is relative to the root file
+    string root_base;
+    m_root_dir = "";
+    conduit::utils::rsplit_string(root_file,"/",root_base,m_root_dir);
+
+    m_trees_per_file = 1;
+    if(m_root["tree_pattern"].as_string() != "/")
+    {
+        // without a tree_files map, trees are divided evenly over files
+        if(m_root.has_child("number_of_files"))
+        {
+            int num_files = m_root["number_of_files"].to_int();
+            m_trees_per_file = (m_num_domains + num_files - 1) / num_files;
+        }
+        m_trees_per_file = std::max(m_trees_per_file,1);
+    }
+
+    // contiguous blocks keep each rank's domains in as few files as possible
+    int64 domain_begin = ((int64)m_rank * m_num_domains) / m_size;
+    int64 domain_end   = ((int64)(m_rank + 1) * m_num_domains) / m_size;
+
+    for(int64 i = domain_begin; i < domain_end; i++)
+    {
+        m_local_domains.push_back((int)i);
+    }
+
+    m_num_rounds = (m_num_domains + m_size - 1) / m_size;
+
+    STRAWMAN_INFO("rank: " << m_rank << " reading " 
+                  << m_local_domains.size() << " of " 
+                  << m_num_domains << " domains from " << root_file);
+}
+
+//-----------------------------------------------------------------------------
+const Node &
+BlueprintReader::Root() const
+{
+    return m_root;
+}
+
+//-----------------------------------------------------------------------------
+int
+BlueprintReader::NumDomains() const
+{
+    return m_num_domains;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<int> &
+BlueprintReader::LocalDomains() const
+{
+    return m_local_domains;
+}
+
+//-----------------------------------------------------------------------------
+int
+BlueprintReader::NumRounds() const
+{
+    return m_num_rounds;
+}
+
+//-----------------------------------------------------------------------------
+std::string
+BlueprintReader::DomainFile(int domain_id) const
+{
+    int file_id = domain_id;
+    if(m_root.has_child("tree_files"))
+    {
+        // aggregated file sets map each tree to its file
+        Node n_tree_files;
+        m_root["tree_files"].to_int32_array(n_tree_files);
+        const int32 *tree_files = n_tree_files.as_int32_ptr();
+        if(n_tree_files.dtype().number_of_elements() <= domain_id ||
+           tree_files[domain_id] < 0)
+        {
+            STRAWMAN_ERROR("The root file does not map domain " << domain_id
+                           << " to a file");
+        }
+        file_id = tree_files[domain_id];
+    }
+    else if(m_root["tree_pattern"].as_string() != "/")
+    {
+        file_id = domain_id / m_trees_per_file;
+    }
+
+    char fmt_buff[512];
+    snprintf(fmt_buff, sizeof(fmt_buff),
+             m_root["file_pattern"].as_string().c_str(),
+             file_id);
+
+    string file_path(fmt_buff);
+    if(m_root_dir.empty() || file_path[0] == '/')
+    {
+        return file_path;
+    }
+
+    return conduit::utils::join_file_path(m_root_dir,file_path);
+}
+
+//-----------------------------------------------------------------------------
+std::string
+BlueprintReader::DomainTree(int domain_id) const
+{
+    string tree_pattern = m_root["tree_pattern"].as_string();
+    if(tree_pattern == "/")
+    {
+        return tree_pattern;
+    }
+
+    char fmt_buff[256];
+    snprintf(fmt_buff, sizeof(fmt_buff), tree_pattern.c_str(), domain_id);
+    return string(fmt_buff);
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::ReadDomain(int domain_id, Node &domain)
+{
+    if(domain_id < 0 || domain_id >= m_num_domains)
+    {
+        STRAWMAN_ERROR("Invalid domain id " << domain_id 
+                       << " (number of domains: " << m_num_domains << ")");
+    }
+
+    string domain_path = DomainFile(domain_id);
+    string tree_path   = DomainTree(domain_id);
+
+    // relay reads a single tree using "file:path"
+    if(tree_path != "/")
+    {
+        domain_path += ":" + tree_path;
+    }
+
+    domain.reset();
+    relay::io::load(domain_path,"hdf5",domain);
+
+    decompress_fields(domain);
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::ReadLocalDomains(Node &domains)
+{
+    domains.reset();
+    for(size_t i = 0; i < m_local_domains.size(); i++)
+    {
+        ReadDomain(m_local_domains[i], domains.append());
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::ReadRound(int round, Node &data)
+{
+    // each domain is read by exactly one rank, so a rank never stands in
+    // for another with a copy of its domain
+    if(round < 0 || round >= (int)m_local_domains.size())
+    {
+        STRAWMAN_ERROR("rank " << m_rank << " owns " 
+                       << m_local_domains.size() << " domains,"
+                       " it has no domain for round " << round);
+    }
+
+    ReadDomain(m_local_domains[round],data);
+
+    // keep the domain id of the file set, which is unique
+    data["state/domain_id"] = (uint64) m_local_domains[round];
+}
+
+//-----------------------------------------------------------------------------
+// copies the actions, adding a round suffix to output names so rounds do
+// not overwrite each other's images and file sets
+//-----------------------------------------------------------------------------
+static void
+round_actions(const Node &actions,
+              const std::string &name,
+              int round,
+              Node &res)
+{
+    if(actions.number_of_children() > 0)
+    {
+        NodeConstIterator itr = actions.children();
+        while(itr.has_next())
+        {
+            const Node &child = itr.next();
+            std::string child_name = itr.name();
+            Node &res_child = actions.dtype().is_list() ? res.append() :
+                                                          res[child_name];
+            round_actions(child, child_name, round, res_child);
+        }
+        return;
+    }
+
+    res.set(actions);
+
+    if(actions.dtype().is_char8_str() &&
+       (name == "file_name" || name == "output_path"))
+    {
+        char fmt_buff[64];
+        snprintf(fmt_buff, sizeof(fmt_buff), "_round_%06d", round);
+        res.set(actions.as_string() + fmt_buff);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BlueprintReader::Replay(const Node &open_options, const Node &actions)
+{
+    //
+    // The pipelines expect one domain per rank. Each round publishes one
+    // domain on every rank that still has one, with a communicator that
+    // only holds those ranks. With fewer domains than ranks that is a
+    // single round on part of the ranks, with more each round renders
+    // or saves part of the data set under its own output names.
+    //
+    for(int round = 0; round < m_num_rounds; round++)
+    {
+        bool has_domain = round < (int)m_local_domains.size();
+        int  round_rank = 0;
+
+        Node round_options;
+        round_options.set(open_options);
+
+#ifdef PARALLEL
+        MPI_Comm mpi_comm   = MPI_Comm_f2c(m_mpi_comm_id);
+        MPI_Comm round_comm = MPI_COMM_NULL;
+        MPI_Comm_split(mpi_comm,
+                       has_domain ? 0 : MPI_UNDEFINED,
+                       m_rank,
+                       &round_comm);
+
+        if(has_domain)
+        {
+            MPI_Comm_rank(round_comm, &round_rank);
+            round_options["mpi_comm"] = MPI_Comm_c2f(round_comm);
+        }
+#endif
+
+        if(has_domain)
+        {
+            Node data;
+            ReadRound(round,data);
+            // each round is a data set of its own, numbered by rank
+            data["state/domain_id"] = (uint64) round_rank;
+
+            const Node *replay_actions = &actions;
+            Node renamed_actions;
+            if(m_num_rounds > 1)
+            {
+                round_actions(actions, "", round, renamed_actions);
+                replay_actions = &renamed_actions;
+            }
+
+            Strawman sman;
+            sman.Open(round_options);
+            sman.Publish(data);
+            sman.Execute(*replay_actions);
+            sman.Close();
+        }
+
+#ifdef PARALLEL
+        if(round_comm != MPI_COMM_NULL)
+        {
+            MPI_Comm_free(&round_comm);
+        }
+#endif
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_blueprint_reader.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_BLUEPRINT_READER_HPP
+#define STRAWMAN_BLUEPRINT_READER_HPP
+
+#include <string>
+#include <vector>
+
+#include <strawman.hpp>
+#include <strawman_exports.h>
+
+#include <conduit.hpp>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// BlueprintReader reads a file set written by the blueprint_hdf5 pipeline
+// (via its .root file) and distributes the domains over the current ranks,
+// which do not need to match the number of ranks that wrote the data.
+//
+// Rank i of N owns the contiguous block of domains 
+// [i*M/N, (i+1)*M/N), so ranks read from as few files as possible.
+//
+// Each domain is owned by exactly one rank. The pipelines expect one 
+// domain per rank, so Replay() publishes the domains in rounds: round r
+// publishes the r-th domain of every rank that has one, using a
+// communicator of just those ranks. With M < N that is a single round on
+// M ranks. With M > N each round holds part of the data set, and its
+// output names (file_name and output_path) get a _round_NNNNNN suffix.
+//
+// Supported options:
+//
+//    mpi_comm : fortran handle of the MPI communicator (MPI builds only)
+//
+//-----------------------------------------------------------------------------
+class STRAWMAN_API BlueprintReader
+{
+public:
+    
+     BlueprintReader();
+    ~BlueprintReader();
+
+    void                    SetOptions(const conduit::Node &options);
+
+    // reads the root file (on rank 0) and assigns domains to ranks
+    void                    Open(const std::string &root_file);
+
+    // contents of the root file
+    const conduit::Node    &Root() const;
+
+    int                     NumDomains() const;
+    // domain ids owned by this rank
+    const std::vector<int> &LocalDomains() const;
+    // largest number of domains owned by a rank
+    int                     NumRounds() const;
+
+    // reads any domain, decompressing compressed fields
+    void                    ReadDomain(int domain_id,
+                                       conduit::Node &domain);
+    // reads the domains owned by this rank into a list
+    void                    ReadLocalDomains(conduit::Node &domains);
+    // reads this rank's i-th domain, raises an error if there is none
+    void                    ReadRound(int round,
+                                      conduit::Node &data);
+
+    // opens strawman with the given options for each round, publishes
+    // the round's domains and executes the actions on them
+    void                    Replay(const conduit::Node &open_options,
+                                   const conduit::Node &actions);
+
+private:
+    std::string             DomainFile(int domain_id) const;
+    std::string             DomainTree(int domain_id) const;
+
+    conduit::Node           m_root;
+    std::string             m_root_dir;
+    int                     m_num_domains;
+    int                     m_trees_per_file;
+    std::vector<int>        m_local_domains;
+    int                     m_num_rounds;
+
+    int                     m_rank;
+    int                     m_size;
+    int                     m_mpi_comm_id;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
@@ -0,0 +1,362 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_capture.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_capture.hpp"
+
+#include "strawman_logging.hpp"
+
+// standard includes
+#include <stdio.h>
+#include <string.h>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+static const char CAPTURE_MAGIC[8] = {'S','M','C','A','P','T','0','1'};
+
+//-----------------------------------------------------------------------------
+float64
+elapsed_seconds(const timeval &start)
+{
+    timeval now;
+    gettimeofday(&now, NULL);
+    return (float64)(now.tv_sec  - start.tv_sec) +
+           (float64)(now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+std::string
+capture_file_name(const std::string &capture_path, int rank)
+{
+    char fmt_buff[64];
+    snprintf(fmt_buff, sizeof(fmt_buff), ".%06d.capture", rank);
+    return capture_path + std::string(fmt_buff);
+}
+
+//-----------------------------------------------------------------------------
+CaptureWriter::CaptureWriter()
+: m_data_stride(1),
+  m_publish_count(0)
+{
+    gettimeofday(&m_start, NULL);
+}
+
+//-----------------------------------------------------------------------------
+CaptureWriter::~CaptureWriter()
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::Open(const std::string &file_name,
+                    const Node &options)
+{
+    Close();
+
+    m_data_stride   = 1;
+    m_publish_count = 0;
+
+    if(options.has_path("capture/data_stride"))
+    {
+        m_data_stride = options["capture/data_stride"].to_int();
+    }
+    
+    if(m_data_stride < 1)
+    {
+        STRAWMAN_WARN("capture/data_stride must be at least 1, using 1");
+        m_data_stride = 1;
+    }
+    
+    m_file.open(file_name.c_str(), std::ios::out | std::ios::binary);
+    
+    if(!m_file.is_open())
+    {
+        STRAWMAN_ERROR("Failed to open capture log " << file_name);
+    }
+
+    m_file.write(detail::CAPTURE_MAGIC, sizeof(detail::CAPTURE_MAGIC));
+    gettimeofday(&m_start, NULL);
+}
+
+//-----------------------------------------------------------------------------
+bool
+CaptureWriter::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::Close()
+{
+    if(m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::RecordOpen(const Node &options)
+{
+    WriteRecord(CAPTURE_OPEN, options, true);
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::RecordPublish(const Node &data)
+{
+    if(m_publish_count % m_data_stride == 0)
+    {
+        WriteRecord(CAPTURE_PUBLISH, data, true);
+    }
+    else
+    {
+        WriteRecord(CAPTURE_PUBLISH_REPEAT, data, false);
+    }
+    m_publish_count++;
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::RecordExecute(const Node &actions)
+{
+    WriteRecord(CAPTURE_EXECUTE, actions, true);
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::RecordClose()
+{
+    WriteRecord(CAPTURE_CLOSE, Node(), false);
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureWriter::WriteRecord(int record_type,
+                           const Node &node,
+                           bool with_data)
+{
+    if(!m_file.is_open())
+    {
+        return;
+    }
+
+    std::string schema_json = "";
+    m_buffer.clear();
+    
+    if(!node.dtype().is_empty())
+    {
+        Schema s_compact;
+        node.schema().compact_to(s_compact);
+        schema_json = s_compact.to_json();
+        if(with_data)
+        {
+            node.serialize(m_buffer);
+        }
+    }
+
+    int32   rec_type    = record_type;
+    float64 timestamp   = detail::elapsed_seconds(m_start);
+    uint64  schema_size = schema_json.size();
+    uint64  data_size   = m_buffer.size();
+
+    m_file.write((const char*)&rec_type,    sizeof(rec_type));
+    m_file.write((const char*)&timestamp,   sizeof(timestamp));
+    m_file.write((const char*)&schema_size, sizeof(schema_size));
+    m_file.write((const char*)&data_size,   sizeof(data_size));
+    m_file.write(schema_json.c_str(), schema_size);
+    
+    if(data_size > 0)
+    {
+        m_file.write((const char*)&m_buffer[0], data_size);
+    }
+
+    if(!m_file.good())
+    {
+        STRAWMAN_WARN("Failed to write capture record, capture disabled");
+        m_file.close();
+    }
+}
+
+//-----------------------------------------------------------------------------
+CaptureReader::CaptureReader()
+: m_file_name("")
+{
+
+}
+
+//-----------------------------------------------------------------------------
+CaptureReader::~CaptureReader()
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureReader::Open(const std::string &file_name)
+{
+    Close();
+    
+    m_file_name = file_name;
+    m_file.open(file_name.c_str(), std::ios::in | std::ios::binary);
+    
+    if(!m_file.is_open())
+    {
+        STRAWMAN_ERROR("Failed to open capture log " << file_name);
+    }
+
+    char magic[sizeof(detail::CAPTURE_MAGIC)];
+    m_file.read(magic, sizeof(magic));
+
+    if(!m_file.good() || 
+       memcmp(magic, detail::CAPTURE_MAGIC, sizeof(magic)) != 0)
+    {
+        m_file.close();
+        STRAWMAN_ERROR(file_name << " is not a strawman capture log");
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+CaptureReader::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+//-----------------------------------------------------------------------------
+void
+CaptureReader::Close()
+{
+    if(m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+CaptureReader::Next(int &record_type,
+                    float64 &timestamp,
+                    Node &node)
+{
+    node.reset();
+
+    if(!m_file.is_open())
+    {
+        return false;
+    }
+
+    int32  rec_type    = 0;
+    uint64 schema_size = 0;
+    uint64 data_size   = 0;
+
+    m_file.read((char*)&rec_type, sizeof(rec_type));
+    
+    // a clean end of the log
+    if(m_file.eof())
+    {
+        return false;
+    }
+
+    m_file.read((char*)&timestamp,   sizeof(timestamp));
+    m_file.read((char*)&schema_size, sizeof(schema_size));
+    m_file.read((char*)&data_size,   sizeof(data_size));
+
+    std::string schema_json(schema_size, ' ');
+    if(schema_size > 0)
+    {
+        m_file.read(&schema_json[0], schema_size);
+    }
+    
+    m_buffer.resize(data_size);
+    if(data_size > 0)
+    {
+        m_file.read((char*)&m_buffer[0], data_size);
+    }
+
+    if(!m_file.good())
+    {
+        STRAWMAN_ERROR("Truncated record in capture log " << m_file_name);
+    }
+
+    record_type = rec_type;
+
+    if(data_size > 0)
+    {
+        Node n_rec(Schema(schema_json), &m_buffer[0], true);
+        node.set(n_rec);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
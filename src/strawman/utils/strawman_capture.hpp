@@ -0,0 +1,168 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_capture.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_CAPTURE_HPP
+#define STRAWMAN_CAPTURE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sys/time.h>
+
+#include <strawman_exports.h>
+
+#include <conduit.hpp>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// A capture log records the Open/Publish/Execute/Close calls of one rank,
+// so the same workload can be replayed against any pipeline without the
+// simulation (see strawman_replay).
+//
+// The log is a binary file that starts with an 8 byte magic string,
+// followed by one record per call:
+//
+//    int32   record type (see CaptureRecordType)
+//    float64 seconds since the log was opened
+//    uint64  size of the schema (json)
+//    uint64  size of the data
+//    schema json, then the compact data
+//
+// Publish records hold the full data. With capture/data_stride = N only
+// every N-th publish stores its data; the others are written as 
+// CAPTURE_PUBLISH_REPEAT records that only hold the schema, and are 
+// replayed with the last stored data.
+//
+//-----------------------------------------------------------------------------
+enum CaptureRecordType
+{
+    CAPTURE_OPEN           = 0,
+    CAPTURE_PUBLISH        = 1,
+    CAPTURE_PUBLISH_REPEAT = 2,
+    CAPTURE_EXECUTE        = 3,
+    CAPTURE_CLOSE          = 4
+};
+
+//-----------------------------------------------------------------------------
+class STRAWMAN_API CaptureWriter
+{
+public:
+     CaptureWriter();
+    ~CaptureWriter();
+
+    // supported options:
+    //   capture/data_stride : store the data of every N-th publish (def 1)
+    void Open(const std::string &file_name,
+              const conduit::Node &options);
+    bool IsOpen() const;
+    void Close();
+
+    void RecordOpen(const conduit::Node &options);
+    void RecordPublish(const conduit::Node &data);
+    void RecordExecute(const conduit::Node &actions);
+    void RecordClose();
+
+private:
+    void WriteRecord(int record_type,
+                     const conduit::Node &node,
+                     bool with_data);
+    
+    std::ofstream              m_file;
+    timeval                    m_start;
+    int                        m_data_stride;
+    conduit::uint64            m_publish_count;
+    // reused serialization buffer
+    std::vector<conduit::uint8> m_buffer;
+};
+
+//-----------------------------------------------------------------------------
+class STRAWMAN_API CaptureReader
+{
+public:
+     CaptureReader();
+    ~CaptureReader();
+
+    void Open(const std::string &file_name);
+    bool IsOpen() const;
+    void Close();
+
+    // reads the next record, returns false at the end of the log.
+    // node is empty for records without data.
+    bool Next(int &record_type,
+              conduit::float64 &timestamp,
+              conduit::Node &node);
+
+private:
+    std::ifstream               m_file;
+    std::string                 m_file_name;
+    std::vector<conduit::uint8> m_buffer;
+};
+
+//-----------------------------------------------------------------------------
+// name of the capture log for the given rank
+std::string STRAWMAN_API capture_file_name(const std::string &capture_path,
+                                           int rank);
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
@@ -0,0 +1,344 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_compression.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_compression.hpp"
+
+#include "strawman_logging.hpp"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+store_codes(const std::vector<int64> &codes, Node &res)
+{
+    std::vector<T> narrow_codes(codes.begin(), codes.end());
+    res.set(narrow_codes);
+}
+
+//-----------------------------------------------------------------------------
+void
+decompress_values(const Node &compression, Node &values)
+{
+    if(compression.has_child("codes"))
+    {
+        quantize_decode(compression, values);
+        return;
+    }
+
+    // multi-component fields store one encoding per component
+    NodeConstIterator itr = compression.children();
+    while(itr.has_next())
+    {
+        const Node &child = itr.next();
+        if(child.dtype().is_object() && child.has_child("codes"))
+        {
+            quantize_decode(child, values[itr.name()]);
+        }
+    }
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void
+quantize_encode(const Node &values,
+                float64 tolerance,
+                bool relative,
+                Node &encoded)
+{
+    if(!values.dtype().is_float32() && !values.dtype().is_float64())
+    {
+        STRAWMAN_ERROR("quantize_encode: unsupported dtype " 
+                       << values.dtype().name()
+                       << ", expected float32 or float64");
+    }
+
+    Node n_f64;
+    values.to_float64_array(n_f64);
+    const float64 *vals = n_f64.as_float64_ptr();
+    index_t num_vals = values.dtype().number_of_elements();
+
+    float64 error_bound = tolerance;
+    if(relative)
+    {
+        float64 vmin =  std::numeric_limits<float64>::max();
+        float64 vmax = -std::numeric_limits<float64>::max();
+        for(index_t i = 0; i < num_vals; i++)
+        {
+            if(std::isfinite(vals[i]))
+            {
+                vmin = std::min(vmin, vals[i]);
+                vmax = std::max(vmax, vals[i]);
+            }
+        }
+        error_bound = vmax > vmin ? tolerance * (vmax - vmin) : 0.0;
+    }
+
+    if(error_bound < 0.0)
+    {
+        STRAWMAN_ERROR("quantize_encode: tolerance must not be negative");
+    }
+
+    const float64 quantum    = 2.0 * error_bound;
+    // leaves room for the outlier marker in an int32
+    const float64 code_limit = 2147483646.0;
+
+    std::vector<int64>   codes(num_vals, 0);
+    std::vector<int64>   outlier_index;
+    std::vector<float64> outlier_values;
+    int64   max_code = 0;
+    float64 pred     = 0.0;
+
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        float64 val     = vals[i];
+        bool    outlier = !std::isfinite(val);
+        float64 recon   = pred;
+        int64   code    = 0;
+
+        if(!outlier)
+        {
+            float64 diff = val - pred;
+            if(quantum > 0.0 && std::fabs(diff / quantum) < code_limit)
+            {
+                code  = (int64) std::floor(diff / quantum + 0.5);
+                recon = pred + code * quantum;
+                // guard against rounding in the reconstruction
+                outlier = std::fabs(val - recon) > error_bound;
+            }
+            else
+            {
+                outlier = diff != 0.0;
+            }
+        }
+
+        if(outlier)
+        {
+            outlier_index.push_back(i);
+            outlier_values.push_back(val);
+            if(std::isfinite(val))
+            {
+                pred = val;
+            }
+        }
+        else
+        {
+            codes[i] = code;
+            max_code = std::max(max_code, code < 0 ? -code : code);
+            pred = recon;
+        }
+    }
+
+    // the most negative value of the code type marks outliers
+    int64 outlier_code = 0;
+    if(max_code < 127)
+    {
+        outlier_code = -128;
+    }
+    else if(max_code < 32767)
+    {
+        outlier_code = -32768;
+    }
+    else
+    {
+        outlier_code = -2147483647LL - 1;
+    }
+
+    for(size_t i = 0; i < outlier_index.size(); i++)
+    {
+        codes[outlier_index[i]] = outlier_code;
+    }
+
+    encoded.reset();
+
+    if(outlier_code == -128)
+    {
+        detail::store_codes<int8>(codes, encoded["codes"]);
+    }
+    else if(outlier_code == -32768)
+    {
+        detail::store_codes<int16>(codes, encoded["codes"]);
+    }
+    else
+    {
+        detail::store_codes<int32>(codes, encoded["codes"]);
+    }
+
+    encoded["outlier_code"] = outlier_code;
+
+    if(!outlier_index.empty())
+    {
+        encoded["outlier_index"].set(outlier_index);
+        encoded["outlier_values"].set(outlier_values);
+    }
+
+    encoded["error_bound"]  = error_bound;
+    encoded["dtype"]        = values.dtype().name();
+    encoded["num_elements"] = (int64) num_vals;
+}
+
+//-----------------------------------------------------------------------------
+void
+quantize_decode(const Node &encoded,
+                Node &values)
+{
+    index_t num_vals     = (index_t) encoded["num_elements"].to_int64();
+    float64 quantum      = 2.0 * encoded["error_bound"].to_float64();
+    int64   outlier_code = encoded["outlier_code"].to_int64();
+
+    Node n_codes;
+    encoded["codes"].to_int64_array(n_codes);
+    const int64 *codes = n_codes.as_int64_ptr();
+
+    Node n_outliers;
+    const float64 *outlier_values = NULL;
+    index_t num_outliers = 0;
+    if(encoded.has_child("outlier_values"))
+    {
+        encoded["outlier_values"].to_float64_array(n_outliers);
+        outlier_values = n_outliers.as_float64_ptr();
+        num_outliers   = n_outliers.dtype().number_of_elements();
+    }
+
+    Node n_res;
+    n_res.set(DataType::float64(num_vals));
+    float64 *res = n_res.as_float64_ptr();
+
+    // outliers are stored in index order
+    index_t outlier_idx = 0;
+    float64 pred = 0.0;
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        if(codes[i] == outlier_code)
+        {
+            if(outlier_idx >= num_outliers)
+            {
+                STRAWMAN_ERROR("quantize_decode: missing outlier values");
+            }
+            res[i] = outlier_values[outlier_idx++];
+            if(std::isfinite(res[i]))
+            {
+                pred = res[i];
+            }
+        }
+        else
+        {
+            res[i] = pred + codes[i] * quantum;
+            pred = res[i];
+        }
+    }
+
+    if(encoded["dtype"].as_string() == "float32")
+    {
+        n_res.to_float32_array(values);
+    }
+    else
+    {
+        values.set(n_res);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+decompress_fields(Node &mesh)
+{
+    if(!mesh.has_child("fields"))
+    {
+        return;
+    }
+
+    NodeIterator itr = mesh["fields"].children();
+    while(itr.has_next())
+    {
+        Node &field = itr.next();
+        if(!field.has_child("compression"))
+        {
+            continue;
+        }
+
+        // lossless compression is transparent, only quantized values
+        // need to be decoded
+        if(field["compression/codec"].as_string() == "quantize")
+        {
+            detail::decompress_values(field["compression"], field["values"]);
+        }
+
+        field.remove("compression");
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
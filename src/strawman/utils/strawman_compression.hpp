@@ -0,0 +1,109 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_compression.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_COMPRESSION_HPP
+#define STRAWMAN_COMPRESSION_HPP
+
+#include <conduit.hpp>
+
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// Error bounded lossy codec for floating point arrays.
+//
+// Each value is predicted by the decoded value before it, and the
+// prediction error is quantized to a multiple of 2 * error_bound, so every
+// decoded value is within error_bound of the original. Values that can not
+// be quantized (NaN, Inf, or errors past the code range) are stored exactly
+// as outliers. The integer codes are stored in the smallest of int8, int16
+// or int32 that fits, and compress well with a lossless coder such as
+// shuffle + deflate.
+//
+// The encoded node holds:
+//   codes          : quantization codes
+//   outlier_code   : code value that marks an outlier
+//   outlier_index  : index of each outlier (only if there are outliers)
+//   outlier_values : exact outlier values (only if there are outliers)
+//   error_bound    : absolute error bound
+//   dtype          : name of the original dtype
+//   num_elements   : number of values
+//-----------------------------------------------------------------------------
+
+// encodes a floating point leaf. if relative is true, tolerance is
+// scaled by the value range of the array.
+void quantize_encode(const conduit::Node &values,
+                     conduit::float64 tolerance,
+                     bool relative,
+                     conduit::Node &encoded);
+
+// decodes into values, using the original dtype
+void quantize_decode(const conduit::Node &encoded,
+                     conduit::Node &values);
+
+// restores the values of all compressed fields of a blueprint mesh written
+// by the blueprint hdf5 pipeline, and removes the compression info
+void decompress_fields(conduit::Node &mesh);
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
+
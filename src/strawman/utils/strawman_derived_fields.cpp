@@ -0,0 +1,994 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_derived_fields.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_derived_fields.hpp"
+
+#include "strawman_logging.hpp"
+#include "strawman_block_timer.hpp"
+
+// standard includes
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+// number of elements each instruction processes at a time
+const index_t BLOCK_SIZE = 512;
+
+enum ExpressionOp
+{
+    // leaves
+    OP_CONST,
+    OP_LOAD,
+    // unary
+    OP_NEG,
+    OP_SQRT,
+    OP_ABS,
+    OP_EXP,
+    OP_LOG,
+    OP_SIN,
+    OP_COS,
+    OP_TAN,
+    // binary
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_POW,
+    OP_MIN,
+    OP_MAX
+};
+
+//-----------------------------------------------------------------------------
+struct ExpressionNode
+{
+    int      m_op;
+    // constant value of OP_CONST
+    float64  m_value;
+    // operand index of OP_LOAD
+    int      m_operand;
+    int      m_lhs;
+    int      m_rhs;
+};
+
+//-----------------------------------------------------------------------------
+struct ExpressionTree
+{
+    std::vector<ExpressionNode> m_nodes;
+    // field or field.component names
+    std::vector<std::string>    m_operands;
+    int                         m_root;
+};
+
+//-----------------------------------------------------------------------------
+struct NegOp  { static float64 apply(float64 a) { return -a; } };
+struct SqrtOp { static float64 apply(float64 a) { return std::sqrt(a); } };
+struct AbsOp  { static float64 apply(float64 a) { return std::fabs(a); } };
+struct ExpOp  { static float64 apply(float64 a) { return std::exp(a); } };
+struct LogOp  { static float64 apply(float64 a) { return std::log(a); } };
+struct SinOp  { static float64 apply(float64 a) { return std::sin(a); } };
+struct CosOp  { static float64 apply(float64 a) { return std::cos(a); } };
+struct TanOp  { static float64 apply(float64 a) { return std::tan(a); } };
+
+struct AddOp  { static float64 apply(float64 a, float64 b) { return a + b; } };
+struct SubOp  { static float64 apply(float64 a, float64 b) { return a - b; } };
+struct MulOp  { static float64 apply(float64 a, float64 b) { return a * b; } };
+struct DivOp  { static float64 apply(float64 a, float64 b) { return a / b; } };
+struct PowOp  { static float64 apply(float64 a, float64 b) { return std::pow(a, b); } };
+struct MinOp  { static float64 apply(float64 a, float64 b) { return b < a ? b : a; } };
+struct MaxOp  { static float64 apply(float64 a, float64 b) { return b > a ? b : a; } };
+
+//-----------------------------------------------------------------------------
+float64
+apply_op(int op, float64 a, float64 b)
+{
+    switch(op)
+    {
+        case OP_NEG:  return NegOp::apply(a);
+        case OP_SQRT: return SqrtOp::apply(a);
+        case OP_ABS:  return AbsOp::apply(a);
+        case OP_EXP:  return ExpOp::apply(a);
+        case OP_LOG:  return LogOp::apply(a);
+        case OP_SIN:  return SinOp::apply(a);
+        case OP_COS:  return CosOp::apply(a);
+        case OP_TAN:  return TanOp::apply(a);
+        case OP_ADD:  return AddOp::apply(a, b);
+        case OP_SUB:  return SubOp::apply(a, b);
+        case OP_MUL:  return MulOp::apply(a, b);
+        case OP_DIV:  return DivOp::apply(a, b);
+        case OP_POW:  return PowOp::apply(a, b);
+        case OP_MIN:  return MinOp::apply(a, b);
+        case OP_MAX:  return MaxOp::apply(a, b);
+        default:      return 0.0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Op>
+void
+unary_block(float64 *dst, const float64 *a, index_t len)
+{
+    for(index_t i = 0; i < len; i++)
+    {
+        dst[i] = Op::apply(a[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// a or b are NULL when that side is the constant value
+//-----------------------------------------------------------------------------
+template<typename Op>
+void
+binary_block(float64 *dst,
+             const float64 *a,
+             const float64 *b,
+             float64 value,
+             index_t len)
+{
+    if(a == NULL)
+    {
+        for(index_t i = 0; i < len; i++)
+        {
+            dst[i] = Op::apply(value, b[i]);
+        }
+    }
+    else if(b == NULL)
+    {
+        for(index_t i = 0; i < len; i++)
+        {
+            dst[i] = Op::apply(a[i], value);
+        }
+    }
+    else
+    {
+        for(index_t i = 0; i < len; i++)
+        {
+            dst[i] = Op::apply(a[i], b[i]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+run_block_op(int op,
+             float64 *dst,
+             const float64 *a,
+             const float64 *b,
+             float64 value,
+             index_t len)
+{
+    switch(op)
+    {
+        case OP_CONST: std::fill(dst, dst + len, value);             break;
+        case OP_NEG:   unary_block<NegOp>(dst, a, len);              break;
+        case OP_SQRT:  unary_block<SqrtOp>(dst, a, len);             break;
+        case OP_ABS:   unary_block<AbsOp>(dst, a, len);              break;
+        case OP_EXP:   unary_block<ExpOp>(dst, a, len);              break;
+        case OP_LOG:   unary_block<LogOp>(dst, a, len);              break;
+        case OP_SIN:   unary_block<SinOp>(dst, a, len);              break;
+        case OP_COS:   unary_block<CosOp>(dst, a, len);              break;
+        case OP_TAN:   unary_block<TanOp>(dst, a, len);              break;
+        case OP_ADD:   binary_block<AddOp>(dst, a, b, value, len);   break;
+        case OP_SUB:   binary_block<SubOp>(dst, a, b, value, len);   break;
+        case OP_MUL:   binary_block<MulOp>(dst, a, b, value, len);   break;
+        case OP_DIV:   binary_block<DivOp>(dst, a, b, value, len);   break;
+        case OP_POW:   binary_block<PowOp>(dst, a, b, value, len);   break;
+        case OP_MIN:   binary_block<MinOp>(dst, a, b, value, len);   break;
+        case OP_MAX:   binary_block<MaxOp>(dst, a, b, value, len);   break;
+        default:                                                      break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// strided view of an operand's values
+//-----------------------------------------------------------------------------
+enum ValueType
+{
+    VALUES_FLOAT64,
+    VALUES_FLOAT32,
+    VALUES_INT32,
+    VALUES_INT64
+};
+
+struct OperandView
+{
+    ValueType    m_type;
+    const void  *m_values;
+    index_t      m_stride;
+    // float64 copy of values without a load kernel
+    Node         m_copy;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+bool
+strided_view(const Node &values, OperandView &view)
+{
+    index_t stride = values.dtype().stride();
+    if(stride % (index_t)sizeof(T) != 0)
+    {
+        return false;
+    }
+    view.m_values = values.element_ptr(0);
+    view.m_stride = stride / (index_t)sizeof(T);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+set_operand_view(const Node &values, OperandView &view)
+{
+    const DataType &dtype = values.dtype();
+    
+    if(dtype.is_float64() && strided_view<float64>(values, view))
+    {
+        view.m_type = VALUES_FLOAT64;
+    }
+    else if(dtype.is_float32() && strided_view<float32>(values, view))
+    {
+        view.m_type = VALUES_FLOAT32;
+    }
+    else if(dtype.is_int32() && strided_view<int32>(values, view))
+    {
+        view.m_type = VALUES_INT32;
+    }
+    else if(dtype.is_int64() && strided_view<int64>(values, view))
+    {
+        view.m_type = VALUES_INT64;
+    }
+    else
+    {
+        values.to_float64_array(view.m_copy);
+        view.m_type   = VALUES_FLOAT64;
+        view.m_values = view.m_copy.data_ptr();
+        view.m_stride = 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+load_block(const T *values,
+           index_t stride,
+           index_t start,
+           index_t len,
+           float64 *dst)
+{
+    values += start * stride;
+    for(index_t i = 0; i < len; i++)
+    {
+        dst[i] = (float64) values[i * stride];
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+load_operand(const OperandView &view,
+             index_t start,
+             index_t len,
+             float64 *dst)
+{
+    switch(view.m_type)
+    {
+        case VALUES_FLOAT64:
+            load_block((const float64*)view.m_values, view.m_stride,
+                       start, len, dst);
+            break;
+        case VALUES_FLOAT32:
+            load_block((const float32*)view.m_values, view.m_stride,
+                       start, len, dst);
+            break;
+        case VALUES_INT32:
+            load_block((const int32*)view.m_values, view.m_stride,
+                       start, len, dst);
+            break;
+        case VALUES_INT64:
+            load_block((const int64*)view.m_values, view.m_stride,
+                       start, len, dst);
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Recursive descent parser:
+//
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/') unary)*
+//   unary      := '-' unary | '+' unary | power
+//   power      := primary ('^' unary)?
+//   primary    := number | name | name '(' args ')' | '(' expression ')'
+//-----------------------------------------------------------------------------
+class ExpressionParser
+{
+public:
+    ExpressionParser(const std::string &expression,
+                     ExpressionTree &tree)
+    : m_expr(expression),
+      m_pos(0),
+      m_tree(tree)
+    {}
+
+    void Parse()
+    {
+        m_tree.m_nodes.clear();
+        m_tree.m_operands.clear();
+        m_tree.m_root = ParseExpression();
+        SkipSpace();
+        if(m_pos != m_expr.size())
+        {
+            Error("unexpected '" + m_expr.substr(m_pos, 1) + "'");
+        }
+    }
+
+private:
+    void Error(const std::string &msg)
+    {
+        STRAWMAN_ERROR("Derived field expression \"" << m_expr << "\": "
+                       << msg << " at position " << m_pos);
+    }
+
+    void SkipSpace()
+    {
+        while(m_pos < m_expr.size() && std::isspace(m_expr[m_pos]))
+        {
+            m_pos++;
+        }
+    }
+
+    bool Accept(char c)
+    {
+        SkipSpace();
+        if(m_pos < m_expr.size() && m_expr[m_pos] == c)
+        {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void Expect(char c)
+    {
+        if(!Accept(c))
+        {
+            Error(std::string("expected '") + c + "'");
+        }
+    }
+
+    int AddNode(int op, float64 value, int operand, int lhs, int rhs)
+    {
+        ExpressionNode node;
+        node.m_op      = op;
+        node.m_value   = value;
+        node.m_operand = operand;
+        node.m_lhs     = lhs;
+        node.m_rhs     = rhs;
+        m_tree.m_nodes.push_back(node);
+        return (int)m_tree.m_nodes.size() - 1;
+    }
+
+    bool IsConst(int node)
+    {
+        return m_tree.m_nodes[node].m_op == OP_CONST;
+    }
+
+    float64 Value(int node)
+    {
+        return m_tree.m_nodes[node].m_value;
+    }
+
+    // constant sub-expressions are folded
+    int AddUnary(int op, int a)
+    {
+        if(IsConst(a))
+        {
+            return AddNode(OP_CONST, apply_op(op, Value(a), 0.0), -1, -1, -1);
+        }
+        return AddNode(op, 0.0, -1, a, -1);
+    }
+
+    int AddBinary(int op, int a, int b)
+    {
+        if(IsConst(a) && IsConst(b))
+        {
+            return AddNode(OP_CONST, apply_op(op, Value(a), Value(b)), -1, -1, -1);
+        }
+        return AddNode(op, 0.0, -1, a, b);
+    }
+
+    int ParseExpression()
+    {
+        int node = ParseTerm();
+        while(true)
+        {
+            if(Accept('+'))
+            {
+                node = AddBinary(OP_ADD, node, ParseTerm());
+            }
+            else if(Accept('-'))
+            {
+                node = AddBinary(OP_SUB, node, ParseTerm());
+            }
+            else
+            {
+                return node;
+            }
+        }
+    }
+
+    int ParseTerm()
+    {
+        int node = ParseUnary();
+        while(true)
+        {
+            if(Accept('*'))
+            {
+                node = AddBinary(OP_MUL, node, ParseUnary());
+            }
+            else if(Accept('/'))
+            {
+                node = AddBinary(OP_DIV, node, ParseUnary());
+            }
+            else
+            {
+                return node;
+            }
+        }
+    }
+
+    int ParseUnary()
+    {
+        if(Accept('-'))
+        {
+            return AddUnary(OP_NEG, ParseUnary());
+        }
+        if(Accept('+'))
+        {
+            return ParseUnary();
+        }
+        return ParsePower();
+    }
+
+    int ParsePower()
+    {
+        int node = ParsePrimary();
+        if(Accept('^'))
+        {
+            // right associative, binds tighter than unary minus on the left
+            node = AddBinary(OP_POW, node, ParseUnary());
+        }
+        return node;
+    }
+
+    int ParsePrimary()
+    {
+        SkipSpace();
+        if(m_pos >= m_expr.size())
+        {
+            Error("unexpected end of expression");
+        }
+
+        char c = m_expr[m_pos];
+        if(Accept('('))
+        {
+            int node = ParseExpression();
+            Expect(')');
+            return node;
+        }
+        
+        if(std::isdigit(c) || c == '.')
+        {
+            const char *start = m_expr.c_str() + m_pos;
+            char *end = NULL;
+            float64 value = std::strtod(start, &end);
+            if(end == start)
+            {
+                Error("invalid number");
+            }
+            m_pos += end - start;
+            return AddNode(OP_CONST, value, -1, -1, -1);
+        }
+
+        if(std::isalpha(c) || c == '_')
+        {
+            size_t start = m_pos;
+            while(m_pos < m_expr.size() &&
+                  (std::isalnum(m_expr[m_pos]) || 
+                   m_expr[m_pos] == '_' ||
+                   m_expr[m_pos] == '.'))
+            {
+                m_pos++;
+            }
+            std::string name = m_expr.substr(start, m_pos - start);
+
+            if(Accept('('))
+            {
+                return ParseCall(name);
+            }
+            return AddNode(OP_LOAD, 0.0, Operand(name), -1, -1);
+        }
+
+        Error(std::string("unexpected '") + c + "'");
+        return -1;
+    }
+
+    int ParseCall(const std::string &name)
+    {
+        int op    = -1;
+        int arity = 1;
+
+        if(name == "sqrt")      op = OP_SQRT;
+        else if(name == "abs")  op = OP_ABS;
+        else if(name == "exp")  op = OP_EXP;
+        else if(name == "log")  op = OP_LOG;
+        else if(name == "sin")  op = OP_SIN;
+        else if(name == "cos")  op = OP_COS;
+        else if(name == "tan")  op = OP_TAN;
+        else if(name == "min")  { op = OP_MIN; arity = 2; }
+        else if(name == "max")  { op = OP_MAX; arity = 2; }
+        else if(name == "pow")  { op = OP_POW; arity = 2; }
+        else
+        {
+            Error("unknown function " + name);
+        }
+
+        int a = ParseExpression();
+        if(arity == 1)
+        {
+            Expect(')');
+            return AddUnary(op, a);
+        }
+        
+        Expect(',');
+        int b = ParseExpression();
+        Expect(')');
+        return AddBinary(op, a, b);
+    }
+
+    int Operand(const std::string &name)
+    {
+        std::vector<std::string> &operands = m_tree.m_operands;
+        for(size_t i = 0; i < operands.size(); i++)
+        {
+            if(operands[i] == name)
+            {
+                return (int) i;
+            }
+        }
+        operands.push_back(name);
+        return (int) operands.size() - 1;
+    }
+
+    const std::string  &m_expr;
+    size_t              m_pos;
+    ExpressionTree     &m_tree;
+};
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+FieldExpression::FieldExpression()
+: m_num_registers(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+FieldExpression::~FieldExpression()
+{
+}
+
+//-----------------------------------------------------------------------------
+void
+FieldExpression::Compile(const std::string &expression)
+{
+    detail::ExpressionTree tree;
+    detail::ExpressionParser parser(expression, tree);
+    parser.Parse();
+
+    if(tree.m_operands.empty())
+    {
+        STRAWMAN_ERROR("Derived field expression \"" << expression << "\""
+                       << " does not read any fields");
+    }
+
+    m_expression = expression;
+    m_fields.clear();
+    m_operands.clear();
+    m_program.clear();
+    m_num_registers = 0;
+
+    for(size_t i = 0; i < tree.m_operands.size(); i++)
+    {
+        Operand operand;
+        std::string::size_type dot = tree.m_operands[i].find('.');
+        operand.m_field = tree.m_operands[i].substr(0, dot);
+        if(dot != std::string::npos)
+        {
+            operand.m_component = tree.m_operands[i].substr(dot + 1);
+        }
+        m_operands.push_back(operand);
+
+        if(std::find(m_fields.begin(), m_fields.end(), operand.m_field) ==
+           m_fields.end())
+        {
+            m_fields.push_back(operand.m_field);
+        }
+    }
+
+    // the result ends up in register 0
+    Emit(tree, tree.m_root, 0);
+}
+
+//-----------------------------------------------------------------------------
+void
+FieldExpression::Emit(const detail::ExpressionTree &tree,
+                      int node_id,
+                      int reg)
+{
+    const detail::ExpressionNode &node = tree.m_nodes[node_id];
+    m_num_registers = std::max(m_num_registers, reg + 1);
+
+    Instruction ins;
+    ins.m_op    = node.m_op;
+    ins.m_dst   = reg;
+    ins.m_a     = reg;
+    ins.m_b     = -1;
+    ins.m_value = 0.0;
+    
+    if(node.m_op == detail::OP_CONST)
+    {
+        ins.m_a     = -1;
+        ins.m_value = node.m_value;
+    }
+    else if(node.m_op == detail::OP_LOAD)
+    {
+        // m_a is the operand index
+        ins.m_a = node.m_operand;
+    }
+    else if(node.m_rhs < 0)
+    {
+        Emit(tree, node.m_lhs, reg);
+    }
+    else
+    {
+        const detail::ExpressionNode &lhs = tree.m_nodes[node.m_lhs];
+        const detail::ExpressionNode &rhs = tree.m_nodes[node.m_rhs];
+        
+        // constants are instruction immediates rather than registers
+        if(lhs.m_op == detail::OP_CONST)
+        {
+            Emit(tree, node.m_rhs, reg);
+            ins.m_a     = -1;
+            ins.m_b     = reg;
+            ins.m_value = lhs.m_value;
+        }
+        else if(rhs.m_op == detail::OP_CONST)
+        {
+            Emit(tree, node.m_lhs, reg);
+            ins.m_value = rhs.m_value;
+        }
+        else
+        {
+            Emit(tree, node.m_lhs, reg);
+            Emit(tree, node.m_rhs, reg + 1);
+            ins.m_b = reg + 1;
+        }
+    }
+
+    m_program.push_back(ins);
+}
+
+//-----------------------------------------------------------------------------
+const std::string &
+FieldExpression::Expression() const
+{
+    return m_expression;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<std::string> &
+FieldExpression::Fields() const
+{
+    return m_fields;
+}
+
+//-----------------------------------------------------------------------------
+void
+FieldExpression::Evaluate(const conduit::Node &data,
+                          conduit::Node &field) const
+{
+    if(m_program.empty())
+    {
+        STRAWMAN_ERROR("Derived field expression was not compiled");
+    }
+
+    std::vector<detail::OperandView> views(m_operands.size());
+    index_t size = 0;
+    std::string topology;
+    std::string association;
+
+    for(size_t i = 0; i < m_operands.size(); i++)
+    {
+        const Operand &operand = m_operands[i];
+        if(!data.has_path("fields/" + operand.m_field))
+        {
+            STRAWMAN_ERROR("Derived field expression \"" << m_expression 
+                           << "\" reads unknown field " << operand.m_field);
+        }
+
+        const Node &n_field = data["fields"][operand.m_field];
+        const Node *values = &n_field["values"];
+        
+        if(operand.m_component.empty())
+        {
+            if(values->number_of_children() > 0)
+            {
+                STRAWMAN_ERROR("Derived field expression \"" << m_expression 
+                               << "\": field " << operand.m_field 
+                               << " has components, select one with " 
+                               << operand.m_field << ".<component>");
+            }
+        }
+        else
+        {
+            if(!values->has_child(operand.m_component))
+            {
+                STRAWMAN_ERROR("Derived field expression \"" << m_expression 
+                               << "\": field " << operand.m_field 
+                               << " has no component "
+                               << operand.m_component);
+            }
+            values = &(*values)[operand.m_component];
+        }
+
+        index_t num_values = values->dtype().number_of_elements();
+        if(i == 0)
+        {
+            size = num_values;
+            topology = n_field["topology"].as_string();
+            association = n_field["association"].as_string();
+        }
+        else if(num_values != size)
+        {
+            STRAWMAN_ERROR("Derived field expression \"" << m_expression 
+                           << "\" reads fields with different numbers of"
+                           << " values (" << size << " and " << num_values 
+                           << ")");
+        }
+
+        detail::set_operand_view(*values, views[i]);
+    }
+
+    field.reset();
+    field["type"]        = "scalar";
+    field["topology"]    = topology;
+    field["association"] = association;
+    field["values"].set(DataType::float64(size));
+    float64 *out = field["values"].as_float64_ptr();
+
+    const index_t block_size = detail::BLOCK_SIZE;
+    std::vector<float64> registers(m_num_registers * block_size);
+    float64 *regs = &registers[0];
+    
+    for(index_t start = 0; start < size; start += block_size)
+    {
+        index_t len = std::min(block_size, size - start);
+        for(size_t p = 0; p < m_program.size(); p++)
+        {
+            const Instruction &ins = m_program[p];
+            float64 *dst = regs + ins.m_dst * block_size;
+            
+            if(ins.m_op == detail::OP_LOAD)
+            {
+                detail::load_operand(views[ins.m_a], start, len, dst);
+                continue;
+            }
+
+            const float64 *a = ins.m_a < 0 ? NULL : regs + ins.m_a * block_size;
+            const float64 *b = ins.m_b < 0 ? NULL : regs + ins.m_b * block_size;
+            detail::run_block_op(ins.m_op, dst, a, b, ins.m_value, len);
+        }
+        std::copy(regs, regs + len, out + start);
+    }
+}
+
+//-----------------------------------------------------------------------------
+DerivedFields::DerivedFields()
+{
+}
+
+//-----------------------------------------------------------------------------
+DerivedFields::~DerivedFields()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool
+DerivedFields::Add(const std::string &name,
+                   const std::string &expression)
+{
+    std::map<std::string, FieldExpression>::iterator itr = m_fields.find(name);
+    if(itr != m_fields.end() && itr->second.Expression() == expression)
+    {
+        return false;
+    }
+    
+    FieldExpression field;
+    field.Compile(expression);
+    m_fields[name] = field;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool
+DerivedFields::Has(const std::string &name) const
+{
+    return m_fields.find(name) != m_fields.end();
+}
+
+//-----------------------------------------------------------------------------
+void
+DerivedFields::Dependents(const std::string &name,
+                          std::set<std::string> &names) const
+{
+    names.insert(name);
+
+    // repeat until no field reads one that was added
+    bool added = true;
+    while(added)
+    {
+        added = false;
+        std::map<std::string, FieldExpression>::const_iterator itr;
+        for(itr = m_fields.begin(); itr != m_fields.end(); ++itr)
+        {
+            if(names.count(itr->first) > 0)
+            {
+                continue;
+            }
+
+            const std::vector<std::string> &fields = itr->second.Fields();
+            for(size_t i = 0; i < fields.size(); i++)
+            {
+                if(names.count(fields[i]) > 0)
+                {
+                    names.insert(itr->first);
+                    added = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+DerivedFields::Empty() const
+{
+    return m_fields.empty();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<std::string>
+DerivedFields::Names() const
+{
+    std::vector<std::string> names;
+    std::map<std::string, FieldExpression>::const_iterator itr;
+    for(itr = m_fields.begin(); itr != m_fields.end(); ++itr)
+    {
+        names.push_back(itr->first);
+    }
+    return names;
+}
+
+//-----------------------------------------------------------------------------
+void
+DerivedFields::Evaluate(const std::set<std::string> &names,
+                        conduit::Node &data) const
+{
+    STRAWMAN_BLOCK_TIMER(DERIVED_FIELDS);
+    
+    std::set<std::string> visiting;
+    std::set<std::string>::const_iterator itr;
+    for(itr = names.begin(); itr != names.end(); ++itr)
+    {
+        EvaluateField(*itr, data, visiting);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+DerivedFields::EvaluateField(const std::string &name,
+                             conduit::Node &data,
+                             std::set<std::string> &visiting) const
+{
+    std::map<std::string, FieldExpression>::const_iterator itr = m_fields.find(name);
+    if(itr == m_fields.end() || data.has_path("fields/" + name))
+    {
+        return;
+    }
+
+    if(visiting.count(name) > 0)
+    {
+        STRAWMAN_ERROR("Derived field " << name << " depends on itself");
+    }
+    visiting.insert(name);
+
+    const FieldExpression &expr = itr->second;
+    for(size_t i = 0; i < expr.Fields().size(); i++)
+    {
+        EvaluateField(expr.Fields()[i], data, visiting);
+    }
+
+    expr.Evaluate(data, data["fields"][name]);
+    visiting.erase(name);
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
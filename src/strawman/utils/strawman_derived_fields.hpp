@@ -0,0 +1,189 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_derived_fields.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_DERIVED_FIELDS_HPP
+#define STRAWMAN_DERIVED_FIELDS_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <strawman_exports.h>
+
+#include <conduit.hpp>
+
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+namespace detail
+{
+    // parsed expression
+    struct ExpressionTree;
+};
+
+//-----------------------------------------------------------------------------
+//
+// FieldExpression compiles an arithmetic expression over the fields of a 
+// blueprint mesh domain into a register program. The program runs over 
+// cache sized blocks of elements, so each instruction is a tight loop the
+// compiler can vectorise and intermediate results never leave the cache.
+//
+// Syntax:
+//   numbers, field names (vel.u reads component u of the field vel),
+//   + - * / ^ (power), unary minus, parentheses and the functions 
+//   sqrt, abs, exp, log, sin, cos, tan, min(a,b), max(a,b) and pow(a,b)
+//
+// All fields read by an expression must have the same number of values.
+// Constant sub-expressions are folded when compiling.
+//
+//-----------------------------------------------------------------------------
+class STRAWMAN_API FieldExpression
+{
+public:
+    
+     FieldExpression();
+    ~FieldExpression();
+
+    // parses the expression, errors on syntax errors
+    void                            Compile(const std::string &expression);
+
+    const std::string              &Expression() const;
+    // names of the fields the expression reads
+    const std::vector<std::string> &Fields() const;
+    
+    // evaluates the expression into a float64 scalar blueprint field with
+    // the topology and association of the fields it reads
+    void                            Evaluate(const conduit::Node &data,
+                                             conduit::Node &field) const;
+
+private:
+    void                            Emit(const detail::ExpressionTree &tree,
+                                         int node,
+                                         int reg);
+
+    struct Instruction
+    {
+        int               m_op;
+        int               m_dst;
+        // source registers, -1 selects m_value
+        int               m_a;
+        int               m_b;
+        conduit::float64  m_value;
+    };
+
+    struct Operand
+    {
+        std::string       m_field;
+        // empty for scalar fields
+        std::string       m_component;
+    };
+
+    std::string                  m_expression;
+    std::vector<std::string>     m_fields;
+    std::vector<Operand>         m_operands;
+    std::vector<Instruction>     m_program;
+    int                          m_num_registers;
+};
+
+//-----------------------------------------------------------------------------
+//
+// DerivedFields holds the fields defined by add_derived_field actions. 
+// Fields are only evaluated when requested, and may read other derived 
+// fields.
+//
+//-----------------------------------------------------------------------------
+class STRAWMAN_API DerivedFields
+{
+public:
+    
+     DerivedFields();
+    ~DerivedFields();
+
+    // adds or replaces a derived field, returns true if the field is new
+    // or its expression changed
+    bool                      Add(const std::string &name,
+                                  const std::string &expression);
+    bool                      Has(const std::string &name) const;
+    // adds name and the derived fields that read it, directly or through
+    // other derived fields, to names
+    void                      Dependents(const std::string &name,
+                                         std::set<std::string> &names) const;
+    bool                      Empty() const;
+    std::vector<std::string>  Names() const;
+
+    // evaluates the named derived fields (and the derived fields they 
+    // read) that are not in data["fields"] yet, and adds them there
+    void                      Evaluate(const std::set<std::string> &names,
+                                       conduit::Node &data) const;
+
+private:
+    void                      EvaluateField(const std::string &name,
+                                            conduit::Node &data,
+                                            std::set<std::string> &visiting) const;
+
+    std::map<std::string, FieldExpression> m_fields;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
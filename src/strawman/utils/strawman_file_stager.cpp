@@ -0,0 +1,285 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_file_stager.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_file_stager.hpp"
+
+#include "strawman_file_system.hpp"
+#include "strawman_logging.hpp"
+
+// standard includes
+#include <sstream>
+// unix only
+#include <unistd.h>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+FileStager::FileStager()
+: m_staging_path(""),
+  m_max_concurrent(2),
+  m_stage_count(0),
+  m_shutdown(false),
+  m_in_flight(0),
+  m_files_submitted(0),
+  m_files_drained(0),
+  m_files_failed(0)
+{
+    
+}
+
+//-----------------------------------------------------------------------------
+FileStager::~FileStager()
+{
+    Shutdown();
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::SetOptions(const Node &options)
+{
+    if(!options.has_path("staging/path") || !m_drainers.empty())
+    {
+        return;
+    }
+    
+    m_staging_path = options["staging/path"].as_string();
+
+    if(options.has_path("staging/max_concurrent"))
+    {
+        m_max_concurrent = options["staging/max_concurrent"].to_int();
+    }
+
+    if(m_max_concurrent < 1)
+    {
+        STRAWMAN_WARN("staging/max_concurrent must be at least 1, using 1");
+        m_max_concurrent = 1;
+    }
+
+    // several ranks on a node may race to create the directory
+    if(!directory_exists(m_staging_path) &&
+       !create_directory(m_staging_path) &&
+       !directory_exists(m_staging_path))
+    {
+        STRAWMAN_WARN("Failed to create staging directory " << m_staging_path
+                      << ", writing output directly");
+        m_staging_path = "";
+        return;
+    }
+
+    for(int i = 0; i < m_max_concurrent; i++)
+    {
+        m_drainers.push_back(std::thread(&FileStager::DrainLoop, this));
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+FileStager::Enabled() const
+{
+    return !m_staging_path.empty();
+}
+
+//-----------------------------------------------------------------------------
+std::string
+FileStager::StagePath(const std::string &final_path)
+{
+    if(!Enabled())
+    {
+        return final_path;
+    }
+
+    std::string file_name, final_dir;
+    conduit::utils::rsplit_string(final_path,
+                                  "/",
+                                  file_name,
+                                  final_dir);
+    
+    // ranks that share the staging directory are told apart by pid, and
+    // the file name keeps its extension
+    std::ostringstream oss;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        oss << "stage_" << getpid() << "_" << m_stage_count++ << "_" << file_name;
+    }
+
+    return conduit::utils::join_file_path(m_staging_path, oss.str());
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::Submit(const std::string &staged_path,
+                   const std::string &final_path)
+{
+    if(!Enabled() || staged_path == final_path)
+    {
+        return;
+    }
+
+    StagedFile staged_file;
+    staged_file.m_staged_path = staged_path;
+    staged_file.m_final_path  = final_path;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(staged_file);
+        m_files_submitted++;
+    }
+    m_cond.notify_all();
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::Drain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(!m_queue.empty() || m_in_flight > 0)
+    {
+        m_cond.wait(lock);
+    }
+
+    if(!m_drain_error.empty())
+    {
+        std::string msg = m_drain_error;
+        m_drain_error = "";
+        lock.unlock();
+        STRAWMAN_WARN(msg);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::Info(Node &info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    info["staging_path"]    = m_staging_path;
+    info["files_submitted"] = m_files_submitted;
+    info["files_drained"]   = m_files_drained;
+    info["files_failed"]    = m_files_failed;
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::DrainLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    while(true)
+    {
+        while(m_queue.empty() && !m_shutdown)
+        {
+            m_cond.wait(lock);
+        }
+
+        if(m_queue.empty())
+        {
+            break;
+        }
+        
+        StagedFile staged_file = m_queue.front();
+        m_queue.pop_front();
+        m_in_flight++;
+        lock.unlock();
+
+        bool ok = move_file(staged_file.m_staged_path,
+                            staged_file.m_final_path);
+
+        lock.lock();
+        m_in_flight--;
+        if(ok)
+        {
+            m_files_drained++;
+        }
+        else
+        {
+            // reported by Drain on the calling thread
+            m_files_failed++;
+            m_drain_error = "Failed to move staged file " +
+                            staged_file.m_staged_path + " to " +
+                            staged_file.m_final_path;
+        }
+        m_cond.notify_all();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+FileStager::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_cond.notify_all();
+
+    // drainers empty the queue before they exit
+    for(size_t i = 0; i < m_drainers.size(); i++)
+    {
+        m_drainers[i].join();
+    }
+    m_drainers.clear();
+
+    if(!m_drain_error.empty())
+    {
+        STRAWMAN_INFO(m_drain_error);
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
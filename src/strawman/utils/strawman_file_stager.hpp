@@ -0,0 +1,147 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_file_stager.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_FILE_STAGER_HPP
+#define STRAWMAN_FILE_STAGER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+
+// std lib thread support
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <conduit.hpp>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// FileStager supports a staging tier (e.g. node local NVMe) for output files.
+// Writers ask for a staging path, write the file there, and submit it. 
+// Background drainer threads then move submitted files to their final path.
+// When staging is not enabled, the staging path is the final path and
+// Submit does nothing.
+//
+// Supported options (usually passed via Strawman::Open):
+//
+//    staging/path           : directory to stage files in
+//    staging/max_concurrent : max number of files moved at once (default 2)
+//
+//-----------------------------------------------------------------------------
+class FileStager
+{
+public:
+    
+     FileStager();
+    ~FileStager();
+
+    void                            SetOptions(const conduit::Node &options);
+
+    bool                            Enabled() const;
+
+    // path to write a file to, which will later be moved to final_path
+    std::string                     StagePath(const std::string &final_path);
+
+    // queues a staged file to be moved to its final path
+    void                            Submit(const std::string &staged_path,
+                                           const std::string &final_path);
+
+    // blocks until all submitted files have been moved
+    void                            Drain();
+
+    // stats (submitted, drained and failed files)
+    void                            Info(conduit::Node &info);
+
+private:
+    void                            DrainLoop();
+    void                            Shutdown();
+
+    struct StagedFile
+    {
+        std::string m_staged_path;
+        std::string m_final_path;
+    };
+
+    std::string                     m_staging_path;
+    int                             m_max_concurrent;
+    conduit::uint64                 m_stage_count;
+
+    // drainer threads and work queue
+    std::vector<std::thread>        m_drainers;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_cond;
+    bool                            m_shutdown;
+    std::deque<StagedFile>          m_queue;
+    int                             m_in_flight;
+    std::string                     m_drain_error;
+
+    // stats
+    conduit::uint64                 m_files_submitted;
+    conduit::uint64                 m_files_drained;
+    conduit::uint64                 m_files_failed;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
+
@@ -54,6 +54,8 @@
 
 // standard includes
 #include <stdlib.h>
+#include <stdio.h>
+#include <fstream>
 // unix only
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -80,6 +82,53 @@ create_directory(const std::string &path)
     return (mkdir(path.c_str(),S_IRWXU | S_IRWXG) == 0);
 }
 
+//-----------------------------------------------------------------------------
+bool
+copy_file(const std::string &src_path,
+          const std::string &dest_path)
+{
+    std::ifstream ifs(src_path.c_str(), std::ios::binary);
+    if(!ifs.is_open())
+    {
+        return false;
+    }
+
+    std::ofstream ofs(dest_path.c_str(), std::ios::binary | std::ios::trunc);
+    if(!ofs.is_open())
+    {
+        return false;
+    }
+
+    // streaming an empty buffer sets failbit, so empty files are only
+    // created
+    if(ifs.peek() != std::ifstream::traits_type::eof())
+    {
+        ofs << ifs.rdbuf();
+    }
+    ofs.close();
+    return !ofs.fail();
+}
+
+//-----------------------------------------------------------------------------
+bool
+move_file(const std::string &src_path,
+          const std::string &dest_path)
+{
+    if(rename(src_path.c_str(), dest_path.c_str()) == 0)
+    {
+        return true;
+    }
+
+    // rename fails across file systems (e.g. node local storage to a
+    // parallel file system)
+    if(!copy_file(src_path, dest_path))
+    {
+        return false;
+    }
+
+    return remove(src_path.c_str()) == 0;
+}
+
 
 //-----------------------------------------------------------------------------
 };
@@ -64,6 +64,13 @@ namespace strawman
 bool directory_exists(const std::string &path);
 // helper to create a directory
 bool create_directory(const std::string &path);
+// helper to copy a file
+bool copy_file(const std::string &src_path,
+               const std::string &dest_path);
+// helper to move a file, copies if src and dest are on different
+// file systems
+bool move_file(const std::string &src_path,
+               const std::string &dest_path);
 
 //-----------------------------------------------------------------------------
 };
@@ -0,0 +1,332 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_fingerprint.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_fingerprint.hpp"
+
+// standard includes
+#include <string>
+#include <string.h>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+static const uint64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64 FNV_PRIME        = 1099511628211ULL;
+
+//-----------------------------------------------------------------------------
+void
+hash_bytes(const void *data, size_t num_bytes, uint64 &hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < num_bytes; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+hash_schema(const Node &node, uint64 &hash)
+{
+    index_t dtype_id  = node.dtype().id();
+    index_t num_elems = node.dtype().number_of_elements();
+    hash_bytes(&dtype_id, sizeof(dtype_id), hash);
+    hash_bytes(&num_elems, sizeof(num_elems), hash);
+
+    if(node.dtype().is_object())
+    {
+        NodeConstIterator itr = node.children();
+        while(itr.has_next())
+        {
+            const Node &child = itr.next();
+            std::string name = itr.name();
+            hash_bytes(name.c_str(), name.size() + 1, hash);
+            hash_schema(child, hash);
+        }
+    }
+    else if(node.dtype().is_list())
+    {
+        for(index_t i = 0; i < node.number_of_children(); i++)
+        {
+            hash_schema(node.child(i), hash);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+hash_data(const Node &node, uint64 &hash)
+{
+    if(node.dtype().is_object() || node.dtype().is_list())
+    {
+        for(index_t i = 0; i < node.number_of_children(); i++)
+        {
+            hash_data(node.child(i), hash);
+        }
+    }
+    else if(!node.dtype().is_empty())
+    {
+        if(node.is_compact())
+        {
+            hash_bytes(node.element_ptr(0),
+                       node.total_bytes_compact(),
+                       hash);
+        }
+        else
+        {
+            // strided or interleaved data, hash element by element
+            index_t num_elems  = node.dtype().number_of_elements();
+            index_t elem_bytes = node.dtype().element_bytes();
+            for(index_t i = 0; i < num_elems; i++)
+            {
+                hash_bytes(node.element_ptr(i), elem_bytes, hash);
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// content fingerprint helpers
+//-----------------------------------------------------------------------------
+static const uint64 LANE_PRIME_1 = 11400714785074694791ULL;
+static const uint64 LANE_PRIME_2 = 14029467366897019727ULL;
+static const uint64 LANE_PRIME_3 = 1609587929392839161ULL;
+static const index_t NUM_LANES   = 4;
+
+//-----------------------------------------------------------------------------
+inline uint64
+rotate_left(uint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+//-----------------------------------------------------------------------------
+inline uint64
+lane_round(uint64 lane, uint64 word)
+{
+    lane += word * LANE_PRIME_2;
+    lane  = rotate_left(lane, 31);
+    return lane * LANE_PRIME_1;
+}
+
+//-----------------------------------------------------------------------------
+inline uint64
+avalanche(uint64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= LANE_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= LANE_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+inline uint64
+load_word(const unsigned char *bytes)
+{
+    // leaves are not guaranteed to be 8 byte aligned
+    uint64 word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+//-----------------------------------------------------------------------------
+// hashes every stride-th 8 byte word of a contiguous buffer. Consecutive
+// words go to independent lanes, so the multiplies of the four lanes can
+// be in flight at the same time.
+//-----------------------------------------------------------------------------
+void
+hash_words(const void *data,
+           size_t num_bytes,
+           index_t stride,
+           uint64 &hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    const index_t num_words    = num_bytes / sizeof(uint64);
+    const index_t num_samples  = (num_words + stride - 1) / stride;
+    const index_t num_blocks   = num_samples / NUM_LANES;
+    const size_t  step         = stride * sizeof(uint64);
+
+    uint64 lanes[NUM_LANES] = { hash + LANE_PRIME_1 + LANE_PRIME_2,
+                                hash + LANE_PRIME_2,
+                                hash,
+                                hash - LANE_PRIME_1 };
+
+    const unsigned char *ptr = bytes;
+    for(index_t b = 0; b < num_blocks; b++)
+    {
+        lanes[0] = lane_round(lanes[0], load_word(ptr));
+        lanes[1] = lane_round(lanes[1], load_word(ptr + step));
+        lanes[2] = lane_round(lanes[2], load_word(ptr + 2 * step));
+        lanes[3] = lane_round(lanes[3], load_word(ptr + 3 * step));
+        ptr += NUM_LANES * step;
+    }
+
+    hash = rotate_left(lanes[0], 1)  + rotate_left(lanes[1], 7) +
+           rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+    hash ^= (uint64)num_bytes * LANE_PRIME_3;
+
+    // remaining sampled words
+    for(index_t i = num_blocks * NUM_LANES; i < num_samples; i++)
+    {
+        hash = lane_round(hash, load_word(bytes + i * step));
+    }
+
+    // bytes that do not fill a word are always hashed
+    size_t tail = num_words * sizeof(uint64);
+    if(tail < num_bytes)
+    {
+        hash_bytes(bytes + tail, num_bytes - tail, hash);
+    }
+
+    hash = avalanche(hash);
+}
+
+//-----------------------------------------------------------------------------
+void
+hash_content(const Node &node, index_t stride, uint64 &hash)
+{
+    if(node.dtype().is_object() || node.dtype().is_list())
+    {
+        for(index_t i = 0; i < node.number_of_children(); i++)
+        {
+            hash_content(node.child(i), stride, hash);
+        }
+    }
+    else if(!node.dtype().is_empty())
+    {
+        if(node.is_compact())
+        {
+            hash_words(node.element_ptr(0),
+                       node.total_bytes_compact(),
+                       stride,
+                       hash);
+        }
+        else
+        {
+            // strided or interleaved data, sample element by element
+            index_t num_elems  = node.dtype().number_of_elements();
+            index_t elem_bytes = node.dtype().element_bytes();
+            for(index_t i = 0; i < num_elems; i += stride)
+            {
+                hash_bytes(node.element_ptr(i), elem_bytes, hash);
+            }
+        }
+    }
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+uint64
+schema_fingerprint(const Node &node)
+{
+    uint64 hash = detail::FNV_OFFSET_BASIS;
+    detail::hash_schema(node, hash);
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+uint64
+data_fingerprint(const Node &node)
+{
+    uint64 hash = detail::FNV_OFFSET_BASIS;
+    detail::hash_schema(node, hash);
+    detail::hash_data(node, hash);
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+uint64
+content_fingerprint(const Node &node,
+                    index_t sample_stride)
+{
+    if(sample_stride < 1)
+    {
+        sample_stride = 1;
+    }
+
+    uint64 hash = detail::FNV_OFFSET_BASIS;
+    detail::hash_schema(node, hash);
+    detail::hash_bytes(&sample_stride, sizeof(sample_stride), hash);
+    detail::hash_content(node, sample_stride, hash);
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+uint64
+combine_fingerprints(uint64 hash,
+                     uint64 value)
+{
+    return detail::avalanche(detail::lane_round(hash, value));
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
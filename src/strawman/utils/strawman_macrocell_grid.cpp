@@ -0,0 +1,359 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_macrocell_grid.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_macrocell_grid.hpp"
+
+#include "strawman_logging.hpp"
+#include "strawman_block_timer.hpp"
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// min and max of each macrocell, the values are a (strided) array of T
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+macrocell_ranges(const uint8 *data,
+                 index_t stride,
+                 const index_t dims[3],
+                 index_t cell_size,
+                 const index_t num_macrocells[3],
+                 std::vector<float64> &mins,
+                 std::vector<float64> &maxs)
+{
+    const index_t slab = dims[0] * dims[1];
+    index_t m = 0;
+
+    for(index_t mk = 0; mk < num_macrocells[2]; mk++)
+    {
+        index_t k0 = mk * cell_size;
+        index_t k1 = std::min(dims[2] - 1, k0 + cell_size);
+        for(index_t mj = 0; mj < num_macrocells[1]; mj++)
+        {
+            index_t j0 = mj * cell_size;
+            index_t j1 = std::min(dims[1] - 1, j0 + cell_size);
+            for(index_t mi = 0; mi < num_macrocells[0]; mi++, m++)
+            {
+                index_t i0 = mi * cell_size;
+                index_t i1 = std::min(dims[0] - 1, i0 + cell_size);
+
+                T vmin = *(const T*)(data + (k0 * slab + j0 * dims[0] + i0) * stride);
+                T vmax = vmin;
+                for(index_t k = k0; k <= k1; k++)
+                {
+                    for(index_t j = j0; j <= j1; j++)
+                    {
+                        const uint8 *row = data + (k * slab + j * dims[0]) * stride;
+                        for(index_t i = i0; i <= i1; i++)
+                        {
+                            T v = *(const T*)(row + i * stride);
+                            vmin = v < vmin ? v : vmin;
+                            vmax = v > vmax ? v : vmax;
+                        }
+                    }
+                }
+
+                mins[m] = (float64) vmin;
+                maxs[m] = (float64) vmax;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// index of a value in an opacity table over [range_min, range_max]
+//-----------------------------------------------------------------------------
+index_t
+opacity_index(float64 value,
+              float64 range_min,
+              float64 range_max,
+              index_t table_size)
+{
+    if(!(range_max > range_min))
+    {
+        return 0;
+    }
+
+    float64 t = (value - range_min) / (range_max - range_min);
+    t = std::min(1.0, std::max(0.0, t));
+    return std::min(table_size - 1, (index_t)(t * (table_size - 1)));
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+MacrocellGrid::MacrocellGrid()
+: m_cell_size(0),
+  m_key(0)
+{
+    for(int a = 0; a < 3; a++)
+    {
+        m_dims[a] = 0;
+        m_num_macrocells[a] = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MacrocellGrid::Build(const Node &values,
+                     const index_t dims[3],
+                     index_t cell_size,
+                     uint64 key)
+{
+    STRAWMAN_BLOCK_TIMER(MACROCELL_GRID_BUILD);
+
+    if(cell_size < 1)
+    {
+        STRAWMAN_ERROR("MacrocellGrid: cell size must be at least 1, got "
+                       << cell_size);
+    }
+
+    index_t num_points = dims[0] * dims[1] * dims[2];
+    if(values.dtype().number_of_elements() != num_points)
+    {
+        STRAWMAN_ERROR("MacrocellGrid: field has " 
+                       << values.dtype().number_of_elements()
+                       << " values, expected " << num_points);
+    }
+
+    index_t num_macrocells = 1;
+    for(int a = 0; a < 3; a++)
+    {
+        m_dims[a] = dims[a];
+        // an axis with a single point still has one (flat) macrocell
+        m_num_macrocells[a] = std::max((index_t)1, 
+                                       (dims[a] - 2 + cell_size) / cell_size);
+        num_macrocells *= m_num_macrocells[a];
+    }
+
+    m_cell_size = cell_size;
+    m_key = key;
+    m_min.resize(num_macrocells);
+    m_max.resize(num_macrocells);
+
+    const uint8 *data = (const uint8*) values.element_ptr(0);
+    index_t stride = values.dtype().stride();
+    const DataType &dtype = values.dtype();
+
+    if(dtype.is_float64())
+    {
+        detail::macrocell_ranges<float64>(data, stride, m_dims, cell_size,
+                                          m_num_macrocells, m_min, m_max);
+    }
+    else if(dtype.is_float32())
+    {
+        detail::macrocell_ranges<float32>(data, stride, m_dims, cell_size,
+                                          m_num_macrocells, m_min, m_max);
+    }
+    else if(dtype.is_int32())
+    {
+        detail::macrocell_ranges<int32>(data, stride, m_dims, cell_size,
+                                        m_num_macrocells, m_min, m_max);
+    }
+    else if(dtype.is_int64())
+    {
+        detail::macrocell_ranges<int64>(data, stride, m_dims, cell_size,
+                                        m_num_macrocells, m_min, m_max);
+    }
+    else
+    {
+        // less common types go through a float64 copy
+        Node n_values;
+        values.to_float64_array(n_values);
+        detail::macrocell_ranges<float64>((const uint8*) n_values.data_ptr(),
+                                          sizeof(float64), m_dims, cell_size,
+                                          m_num_macrocells, m_min, m_max);
+    }
+}
+
+//-----------------------------------------------------------------------------
+uint64
+MacrocellGrid::Key() const
+{
+    return m_key;
+}
+
+//-----------------------------------------------------------------------------
+bool
+MacrocellGrid::Empty() const
+{
+    return m_min.empty();
+}
+
+//-----------------------------------------------------------------------------
+index_t
+MacrocellGrid::NumberOfMacrocells() const
+{
+    return (index_t) m_min.size();
+}
+
+//-----------------------------------------------------------------------------
+float64
+MacrocellGrid::Min() const
+{
+    if(m_min.empty())
+    {
+        return 0.0;
+    }
+    return *std::min_element(m_min.begin(), m_min.end());
+}
+
+//-----------------------------------------------------------------------------
+float64
+MacrocellGrid::Max() const
+{
+    if(m_max.empty())
+    {
+        return 0.0;
+    }
+    return *std::max_element(m_max.begin(), m_max.end());
+}
+
+//-----------------------------------------------------------------------------
+index_t
+MacrocellGrid::VisibleExtent(const std::vector<float> &opacity,
+                             float64 range_min,
+                             float64 range_max,
+                             index_t start[3],
+                             index_t end[3]) const
+{
+    if(opacity.empty())
+    {
+        return 0;
+    }
+
+    //
+    // Number of opaque table entries before each entry, so a macrocell 
+    // is checked in constant time no matter how wide its range is
+    //
+    const index_t table_size = (index_t) opacity.size();
+    std::vector<index_t> num_opaque(table_size + 1, 0);
+    for(index_t i = 0; i < table_size; i++)
+    {
+        num_opaque[i + 1] = num_opaque[i] + (opacity[i] > 0.0f ? 1 : 0);
+    }
+
+    index_t lo[3] = {std::numeric_limits<index_t>::max(),
+                     std::numeric_limits<index_t>::max(),
+                     std::numeric_limits<index_t>::max()};
+    index_t hi[3] = {-1, -1, -1};
+    index_t num_visible = 0;
+    index_t m = 0;
+
+    for(index_t mk = 0; mk < m_num_macrocells[2]; mk++)
+    {
+        for(index_t mj = 0; mj < m_num_macrocells[1]; mj++)
+        {
+            for(index_t mi = 0; mi < m_num_macrocells[0]; mi++, m++)
+            {
+                index_t first = detail::opacity_index(m_min[m], range_min,
+                                                      range_max, table_size);
+                index_t last  = detail::opacity_index(m_max[m], range_min,
+                                                      range_max, table_size);
+                // the table is sampled, so include the entry past the max
+                last = std::min(table_size - 1, last + 1);
+
+                if(num_opaque[last + 1] - num_opaque[first] == 0)
+                {
+                    continue;
+                }
+
+                num_visible++;
+                index_t idx[3] = {mi, mj, mk};
+                for(int a = 0; a < 3; a++)
+                {
+                    lo[a] = std::min(lo[a], idx[a]);
+                    hi[a] = std::max(hi[a], idx[a]);
+                }
+            }
+        }
+    }
+
+    if(num_visible == 0)
+    {
+        return 0;
+    }
+
+    for(int a = 0; a < 3; a++)
+    {
+        start[a] = lo[a] * m_cell_size;
+        end[a]   = std::min(m_dims[a], (hi[a] + 1) * m_cell_size + 1);
+    }
+
+    return num_visible;
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
@@ -0,0 +1,128 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_macrocell_grid.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_MACROCELL_GRID_HPP
+#define STRAWMAN_MACROCELL_GRID_HPP
+
+#include <conduit.hpp>
+
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// MacrocellGrid holds the min and max value of each block of cell_size^3 
+// cells of a vertex field on a structured grid. Neighboring macrocells 
+// share their boundary points, so interpolated values inside a macrocell
+// are always within its range.
+//
+// Combined with an opacity lookup table, the grid tells which parts of a 
+// volume are transparent and can be skipped.
+//
+//-----------------------------------------------------------------------------
+class MacrocellGrid
+{
+public:
+    MacrocellGrid();
+
+    // builds the grid from the values of a vertex field with dims points
+    // along each axis (1 for missing axes). The key identifies the field 
+    // contents, see Key.
+    void              Build(const conduit::Node &values,
+                            const conduit::index_t dims[3],
+                            conduit::index_t cell_size,
+                            conduit::uint64 key);
+
+    // key passed to the last Build, so callers only rebuild when the 
+    // field changes
+    conduit::uint64   Key() const;
+    bool              Empty() const;
+
+    conduit::index_t  NumberOfMacrocells() const;
+    conduit::float64  Min() const;
+    conduit::float64  Max() const;
+
+    // Finds the points [start, end) bounding all macrocells that contain
+    // a value with a non-zero opacity. The opacity table samples the 
+    // transfer function evenly over [range_min, range_max], values 
+    // outside the range are clamped. Returns the number of visible 
+    // macrocells, when it is 0 start and end are not set.
+    conduit::index_t  VisibleExtent(const std::vector<float> &opacity,
+                                    conduit::float64 range_min,
+                                    conduit::float64 range_max,
+                                    conduit::index_t start[3],
+                                    conduit::index_t end[3]) const;
+
+private:
+    conduit::index_t                m_dims[3];
+    conduit::index_t                m_cell_size;
+    conduit::index_t                m_num_macrocells[3];
+    conduit::uint64                 m_key;
+    std::vector<conduit::float64>   m_min;
+    std::vector<conduit::float64>   m_max;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
+
@@ -0,0 +1,276 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_perf_counters.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_perf_counters.hpp"
+
+// standard includes
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+#if defined(__linux__)
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+int
+open_perf_counter(uint64 config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config;
+    attr.disabled       = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP |
+                          PERF_FORMAT_TOTAL_TIME_ENABLED |
+                          PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // this thread, any cpu
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+#endif
+
+//-----------------------------------------------------------------------------
+PerfCounters::PerfCounters()
+: m_group_fd(-1),
+  m_num_open(0)
+{
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        m_fds[i]   = -1;
+        m_index[i] = -1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+PerfCounters::~PerfCounters()
+{
+    Close();
+}
+
+//-----------------------------------------------------------------------------
+void
+PerfCounters::Open()
+{
+    Close();
+#if defined(__linux__)
+    const uint64 configs[NUM_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES,
+                                           PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_MISSES,
+                                           PERF_COUNT_HW_BRANCH_MISSES };
+
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        int fd = detail::open_perf_counter(configs[i], m_group_fd);
+        if(fd < 0)
+        {
+            continue;
+        }
+
+        m_fds[i]   = fd;
+        m_index[i] = m_num_open;
+        m_num_open++;
+
+        if(m_group_fd == -1)
+        {
+            m_group_fd = fd;
+        }
+    }
+
+    if(m_group_fd != -1)
+    {
+        ioctl(m_group_fd, PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+        ioctl(m_group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void
+PerfCounters::Close()
+{
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        if(m_fds[i] != -1)
+        {
+            close(m_fds[i]);
+        }
+        m_fds[i]   = -1;
+        m_index[i] = -1;
+    }
+    m_group_fd = -1;
+    m_num_open = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool
+PerfCounters::Available() const
+{
+    return m_num_open > 0;
+}
+
+//-----------------------------------------------------------------------------
+bool
+PerfCounters::Available(int counter) const
+{
+    return counter >= 0 && counter < NUM_COUNTERS && m_index[counter] != -1;
+}
+
+//-----------------------------------------------------------------------------
+bool
+PerfCounters::Read(Sample &sample)
+{
+    sample.m_time_enabled = 0;
+    sample.m_time_running = 0;
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        sample.m_values[i] = 0;
+    }
+
+    if(m_group_fd == -1)
+    {
+        return false;
+    }
+
+    // nr, time enabled, time running, then one value per counter
+    uint64 buffer[3 + NUM_COUNTERS];
+    ssize_t bytes = read(m_group_fd, buffer, sizeof(buffer));
+    
+    if(bytes < (ssize_t)((3 + m_num_open) * sizeof(uint64)))
+    {
+        return false;
+    }
+
+    sample.m_time_enabled = buffer[1];
+    sample.m_time_running = buffer[2];
+
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        if(m_index[i] != -1)
+        {
+            sample.m_values[i] = buffer[3 + m_index[i]];
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+PerfCounters::Difference(const Sample &start,
+                         const Sample &end,
+                         uint64 values[NUM_COUNTERS])
+{
+    // the raw counts and times only grow, the scale has to be taken from
+    // the interval itself. scaling each running total by its own ratio
+    // can make the end lower than the start when the ratio changes.
+    uint64 enabled = end.m_time_enabled > start.m_time_enabled ?
+                     end.m_time_enabled - start.m_time_enabled : 0;
+    uint64 running = end.m_time_running > start.m_time_running ?
+                     end.m_time_running - start.m_time_running : 0;
+
+    double scale = 1.0;
+    if(running > 0 && running < enabled)
+    {
+        // the group was multiplexed with other events
+        scale = (double)enabled / (double)running;
+    }
+
+    for(int i = 0; i < NUM_COUNTERS; i++)
+    {
+        uint64 count = end.m_values[i] > start.m_values[i] ?
+                       end.m_values[i] - start.m_values[i] : 0;
+        values[i] = (uint64)(count * scale);
+    }
+}
+
+//-----------------------------------------------------------------------------
+const char *
+PerfCounters::Name(int counter)
+{
+    switch(counter)
+    {
+        case CYCLES:        return "cycles";
+        case INSTRUCTIONS:  return "instructions";
+        case LLC_MISSES:    return "llc_misses";
+        case BRANCH_MISSES: return "branch_misses";
+        default:            return "unknown";
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
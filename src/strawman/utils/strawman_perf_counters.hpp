@@ -0,0 +1,132 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_perf_counters.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_PERF_COUNTERS_HPP
+#define STRAWMAN_PERF_COUNTERS_HPP
+
+#include <conduit.hpp>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// PerfCounters reads a group of hardware counters for the calling thread
+// via the linux perf_event_open system call. The counters are read 
+// together, so their values are consistent with each other.
+//
+// Counters that can't be opened (no linux, perf_event_paranoid settings,
+// no PMU in a VM, ...) are reported as unavailable.
+//
+//-----------------------------------------------------------------------------
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NUM_COUNTERS
+    };
+
+     PerfCounters();
+    ~PerfCounters();
+
+    // opens the counters for the calling thread
+    void        Open();
+    void        Close();
+
+    // true if any of the counters is available
+    bool        Available() const;
+    bool        Available(int counter) const;
+
+    // raw group read, unavailable counters read as 0
+    struct Sample
+    {
+        conduit::uint64 m_time_enabled;
+        conduit::uint64 m_time_running;
+        conduit::uint64 m_values[NUM_COUNTERS];
+    };
+
+    // reads the current raw counts. returns false on failure.
+    bool        Read(Sample &sample);
+
+    // counts between two samples, scaled by the share of that interval the
+    // group was running if the counters were multiplexed
+    static void Difference(const Sample &start,
+                           const Sample &end,
+                           conduit::uint64 values[NUM_COUNTERS]);
+
+    static const char *Name(int counter);
+
+private:
+    // file descriptors, the first open counter leads the group
+    int         m_fds[NUM_COUNTERS];
+    // position of each counter in the group read, -1 if unavailable
+    int         m_index[NUM_COUNTERS];
+    int         m_group_fd;
+    int         m_num_open;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
@@ -54,6 +54,7 @@
 
 // standard includes
 #include <stdlib.h>
+#include <string.h>
 
 // thirdparty includes
 #include <lodepng.h>
@@ -91,7 +92,7 @@ PNGEncoder::Encode(const unsigned char *rgba_in,
 
     for (int y=0; y<height; ++y)
     {
-        memcpy(&(rgba_flip[y*height*4]),
+        memcpy(&(rgba_flip[y*width*4]),
                &(rgba_in[(height-y-1)*width*4]),
                width*4);
     }
@@ -175,6 +176,24 @@ PNGEncoder::Save(const std::string &filename)
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+PNGEncoder::SetPngBuffer(const void *png_data,
+                         size_t png_size)
+{
+    Cleanup();
+
+    if(png_data == NULL || png_size == 0)
+    {
+        return;
+    }
+
+    // malloc so Cleanup can treat this like a lodepng buffer
+    m_buffer = (unsigned char*)malloc(png_size);
+    memcpy(m_buffer, png_data, png_size);
+    m_buffer_size = png_size;
+}
+
 //-----------------------------------------------------------------------------
 void *
 PNGEncoder::PngBuffer()
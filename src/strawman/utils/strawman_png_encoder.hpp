@@ -73,6 +73,10 @@ public:
                           const int height);
     void           Save(const std::string &filename);
 
+    // replaces the buffer with a copy of previously encoded png bytes
+    void           SetPngBuffer(const void *png_data,
+                                size_t png_size);
+
     void          *PngBuffer();
     size_t         PngBufferSize();
 
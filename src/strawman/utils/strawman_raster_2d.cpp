@@ -0,0 +1,379 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_raster_2d.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_raster_2d.hpp"
+
+#include <strawman_config.h>
+#include "strawman_logging.hpp"
+#include "strawman_block_timer.hpp"
+
+// standard includes
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+Raster2D::Raster2D()
+: m_vertex(true)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool
+Raster2D::SetField(const Node &mesh,
+                   const std::string &field_name)
+{
+    m_coords[0].clear();
+    m_coords[1].clear();
+    m_values.reset();
+
+    if(!mesh.has_path("fields/" + field_name))
+    {
+        return false;
+    }
+
+    const Node &n_field = mesh["fields"][field_name];
+    const std::string association = n_field["association"].as_string();
+    const Node &n_values = n_field["values"];
+
+    if((association != "vertex" && association != "element") ||
+       n_values.number_of_children() > 0)
+    {
+        return false;
+    }
+
+    const Node &n_topo = mesh["topologies"][n_field["topology"].as_string()];
+    const std::string topo_type = n_topo["type"].as_string();
+    const Node &n_coords = mesh["coordsets"][n_topo["coordset"].as_string()];
+
+    const char *dim_names[2]     = {"i", "j"};
+    const char *axis_names[2]    = {"x", "y"};
+    const char *spacing_names[2] = {"dx", "dy"};
+
+    if(topo_type == "uniform")
+    {
+        if(n_coords.has_path("dims/k") && n_coords["dims/k"].to_index_t() > 1)
+        {
+            return false;
+        }
+
+        for(int a = 0; a < 2; a++)
+        {
+            if(!n_coords.has_path(std::string("dims/") + dim_names[a]))
+            {
+                return false;
+            }
+
+            index_t dims = n_coords["dims"][dim_names[a]].to_index_t();
+            float64 origin  = 0.0;
+            float64 spacing = 1.0;
+            if(n_coords.has_path(std::string("origin/") + axis_names[a]))
+            {
+                origin = n_coords["origin"][axis_names[a]].to_float64();
+            }
+            if(n_coords.has_path(std::string("spacing/") + spacing_names[a]))
+            {
+                spacing = n_coords["spacing"][spacing_names[a]].to_float64();
+            }
+
+            m_coords[a].resize(dims);
+            for(index_t i = 0; i < dims; i++)
+            {
+                m_coords[a][i] = origin + i * spacing;
+            }
+        }
+    }
+    else if(topo_type == "rectilinear")
+    {
+        if(n_coords.has_path("values/z") && 
+           n_coords["values/z"].dtype().number_of_elements() > 1)
+        {
+            return false;
+        }
+
+        for(int a = 0; a < 2; a++)
+        {
+            if(!n_coords.has_path(std::string("values/") + axis_names[a]))
+            {
+                return false;
+            }
+
+            Node n_axis;
+            n_coords["values"][axis_names[a]].to_float64_array(n_axis);
+            const float64 *axis = n_axis.as_float64_ptr();
+            m_coords[a].assign(axis, axis + n_axis.dtype().number_of_elements());
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    for(int a = 0; a < 2; a++)
+    {
+        const std::vector<float64> &coords = m_coords[a];
+        if(coords.size() < 2)
+        {
+            return false;
+        }
+        for(size_t i = 1; i < coords.size(); i++)
+        {
+            if(!(coords[i] > coords[i - 1]))
+            {
+                return false;
+            }
+        }
+    }
+
+    m_vertex = association == "vertex";
+    index_t expected = m_vertex ? 
+                       m_coords[0].size() * m_coords[1].size() :
+                       (m_coords[0].size() - 1) * (m_coords[1].size() - 1);
+
+    if(n_values.dtype().number_of_elements() != expected)
+    {
+        return false;
+    }
+
+    // float64 values are used in place
+    if(n_values.dtype().is_float64() && n_values.is_compact())
+    {
+        m_values.set_external(n_values);
+    }
+    else
+    {
+        n_values.to_float64_array(m_values);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+Raster2D::Bounds(float64 bounds[4]) const
+{
+    for(int a = 0; a < 2; a++)
+    {
+        bounds[2 * a]     = m_coords[a].empty() ? 0.0 : m_coords[a].front();
+        bounds[2 * a + 1] = m_coords[a].empty() ? 0.0 : m_coords[a].back();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+Raster2D::Range(float64 &range_min,
+                float64 &range_max) const
+{
+    range_min = 0.0;
+    range_max = 0.0;
+
+    index_t num_values = m_values.dtype().number_of_elements();
+    if(m_values.dtype().is_empty() || num_values == 0)
+    {
+        return;
+    }
+
+    const float64 *values = (const float64*) m_values.data_ptr();
+    range_min = values[0];
+    range_max = values[0];
+    for(index_t i = 1; i < num_values; i++)
+    {
+        range_min = values[i] < range_min ? values[i] : range_min;
+        range_max = values[i] > range_max ? values[i] : range_max;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+Raster2D::MapPixels(int axis,
+                    float64 origin,
+                    float64 pixel_size,
+                    int num_pixels,
+                    std::vector<index_t> &cells,
+                    std::vector<float64> &fractions) const
+{
+    const std::vector<float64> &coords = m_coords[axis];
+    const index_t num_cells = coords.size() - 1;
+
+    cells.resize(num_pixels);
+    fractions.resize(num_pixels);
+
+    // pixel centers increase, so the cell search only moves forward
+    index_t cell = 0;
+    for(int p = 0; p < num_pixels; p++)
+    {
+        float64 pos = origin + (p + 0.5) * pixel_size;
+        if(pos < coords.front() || pos >= coords.back())
+        {
+            cells[p]     = -1;
+            fractions[p] = 0.0;
+            continue;
+        }
+
+        while(cell < num_cells - 1 && pos >= coords[cell + 1])
+        {
+            cell++;
+        }
+
+        cells[p]     = cell;
+        fractions[p] = (pos - coords[cell]) / (coords[cell + 1] - coords[cell]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+Raster2D::Rasterize(const float64 origin[2],
+                    float64 pixel_size,
+                    int width,
+                    int height,
+                    const std::vector<unsigned char> &lut,
+                    float64 range_min,
+                    float64 range_max,
+                    unsigned char *rgba) const
+{
+    STRAWMAN_BLOCK_TIMER(RASTER_2D);
+
+    if(m_values.dtype().is_empty() || lut.size() < 4)
+    {
+        return;
+    }
+
+    std::vector<index_t> col_cells, row_cells;
+    std::vector<float64> col_fracs, row_fracs;
+    MapPixels(0, origin[0], pixel_size, width,  col_cells, col_fracs);
+    MapPixels(1, origin[1], pixel_size, height, row_cells, row_fracs);
+
+    //
+    // Covered pixels form one span per axis, so the inner loop has no
+    // coverage tests
+    //
+    int col_begin = 0;
+    while(col_begin < width && col_cells[col_begin] < 0) col_begin++;
+    int col_end = col_begin;
+    while(col_end < width && col_cells[col_end] >= 0) col_end++;
+
+    int row_begin = 0;
+    while(row_begin < height && row_cells[row_begin] < 0) row_begin++;
+    int row_end = row_begin;
+    while(row_end < height && row_cells[row_end] >= 0) row_end++;
+
+    if(col_begin == col_end || row_begin == row_end)
+    {
+        return;
+    }
+
+    // colors as 32-bit words, so each pixel is a single store
+    const int num_colors = (int)(lut.size() / 4);
+    std::vector<uint32> colors(num_colors);
+    memcpy(&colors[0], &lut[0], num_colors * sizeof(uint32));
+
+    const float64 scale = range_max > range_min ? 
+                          (num_colors - 1) / (range_max - range_min) : 0.0;
+    const float64 max_index = num_colors - 1;
+
+    const float64 *values = (const float64*) m_values.data_ptr();
+    const index_t row_size = m_vertex ? m_coords[0].size() : 
+                                        m_coords[0].size() - 1;
+    const index_t *cols  = &col_cells[0];
+    const float64 *fracs = &col_fracs[0];
+    const bool vertex = m_vertex;
+
+#ifdef STRAWMAN_USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for(int y = row_begin; y < row_end; y++)
+    {
+        const index_t cell_y = row_cells[y];
+        const float64 fy     = row_fracs[y];
+        const float64 *row0  = values + cell_y * row_size;
+        const float64 *row1  = row0 + row_size;
+        uint32 *pixels = (uint32*)(rgba + 4 * (size_t)y * width);
+
+        for(int x = col_begin; x < col_end; x++)
+        {
+            const index_t cell_x = cols[x];
+            float64 value;
+            if(vertex)
+            {
+                // bilinear interpolation of the cell's vertex values
+                const float64 fx = fracs[x];
+                float64 bottom = row0[cell_x] + fx * (row0[cell_x + 1] - row0[cell_x]);
+                float64 top    = row1[cell_x] + fx * (row1[cell_x + 1] - row1[cell_x]);
+                value = bottom + fy * (top - bottom);
+            }
+            else
+            {
+                value = row0[cell_x];
+            }
+
+            float64 index = (value - range_min) * scale + 0.5;
+            // written so NaN values fail the first test and map to 0
+            index = index > 0.0 ? (index < max_index ? index : max_index) : 0.0;
+            uint32 color = colors[(int)index];
+            memcpy(pixels + x, &color, sizeof(uint32));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
@@ -0,0 +1,129 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_raster_2d.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_RASTER_2D_HPP
+#define STRAWMAN_RASTER_2D_HPP
+
+#include <conduit.hpp>
+
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+//
+// Raster2D renders a pseudocolor plot of a field on a 2D uniform or 
+// rectilinear topology by mapping cells straight to pixels, without a 
+// camera, geometry or depth buffer. World x and y are the image axes.
+//
+// Only pixels whose centers are inside the mesh are written. Cells are
+// half open, so the images of domains that share an edge do not overlap
+// and can be combined without depth.
+//
+//-----------------------------------------------------------------------------
+class Raster2D
+{
+public:
+    Raster2D();
+
+    // returns false if the field is not a scalar vertex or element field
+    // on a 2D uniform or rectilinear topology with increasing coordinates
+    bool  SetField(const conduit::Node &mesh,
+                   const std::string &field_name);
+
+    // x min, x max, y min, y max
+    void  Bounds(conduit::float64 bounds[4]) const;
+    void  Range(conduit::float64 &range_min,
+                conduit::float64 &range_max) const;
+
+    // Writes the lut color of each covered pixel into rgba (4 bytes per
+    // pixel, rows from bottom to top). The lut holds rgba8 colors evenly
+    // spaced over [range_min, range_max]. The lower left corner of the
+    // image is at origin and pixels are pixel_size wide and high.
+    void  Rasterize(const conduit::float64 origin[2],
+                    conduit::float64 pixel_size,
+                    int width,
+                    int height,
+                    const std::vector<unsigned char> &lut,
+                    conduit::float64 range_min,
+                    conduit::float64 range_max,
+                    unsigned char *rgba) const;
+
+private:
+    // for each pixel along an axis the cell its center is in (or -1), 
+    // and the position inside the cell
+    void  MapPixels(int axis,
+                    conduit::float64 origin,
+                    conduit::float64 pixel_size,
+                    int num_pixels,
+                    std::vector<conduit::index_t> &cells,
+                    std::vector<conduit::float64> &fractions) const;
+
+    std::vector<conduit::float64>  m_coords[2];
+    conduit::Node                  m_values;
+    bool                           m_vertex;
+};
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
+
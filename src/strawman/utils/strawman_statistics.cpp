@@ -0,0 +1,768 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_statistics.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_statistics.hpp"
+
+#include "strawman_logging.hpp"
+#include "strawman_block_timer.hpp"
+
+// standard includes
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+enum ValueType
+{
+    VALUES_NONE,
+    VALUES_FLOAT64,
+    VALUES_FLOAT32,
+    VALUES_INT32,
+    VALUES_INT64
+};
+
+//-----------------------------------------------------------------------------
+// one field (or field component) and its local results
+//-----------------------------------------------------------------------------
+struct StatsChannel
+{
+    std::string  m_name;
+    std::string  m_association;
+    // values, NULL when this rank does not have the field
+    const Node  *m_node;
+    
+    // strided view of the values
+    ValueType    m_type;
+    const void  *m_values;
+    index_t      m_stride;
+    index_t      m_size;
+    // float64 copy of values without a kernel
+    Node         m_copy;
+
+    float64      m_count;
+    float64      m_min;
+    float64      m_max;
+    float64      m_sum;
+    float64      m_m2;
+
+    StatsChannel()
+    : m_node(NULL),
+      m_type(VALUES_NONE),
+      m_values(NULL),
+      m_stride(1),
+      m_size(0),
+      m_count(0.0),
+      m_min(std::numeric_limits<float64>::infinity()),
+      m_max(-std::numeric_limits<float64>::infinity()),
+      m_sum(0.0),
+      m_m2(0.0)
+    {}
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+bool
+strided_view(const Node &values, StatsChannel &channel)
+{
+    index_t stride = values.dtype().stride();
+    if(stride % (index_t)sizeof(T) != 0)
+    {
+        return false;
+    }
+    channel.m_values = values.element_ptr(0);
+    channel.m_stride = stride / (index_t)sizeof(T);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+set_channel_values(const Node &values, StatsChannel &channel)
+{
+    const DataType &dtype = values.dtype();
+    channel.m_size = dtype.number_of_elements();
+    
+    if(dtype.is_float64() && strided_view<float64>(values, channel))
+    {
+        channel.m_type = VALUES_FLOAT64;
+    }
+    else if(dtype.is_float32() && strided_view<float32>(values, channel))
+    {
+        channel.m_type = VALUES_FLOAT32;
+    }
+    else if(dtype.is_int32() && strided_view<int32>(values, channel))
+    {
+        channel.m_type = VALUES_INT32;
+    }
+    else if(dtype.is_int64() && strided_view<int64>(values, channel))
+    {
+        channel.m_type = VALUES_INT64;
+    }
+    else
+    {
+        values.to_float64_array(channel.m_copy);
+        channel.m_type   = VALUES_FLOAT64;
+        channel.m_values = channel.m_copy.data_ptr();
+        channel.m_stride = 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+add_field_channels(const Node &data,
+                   const std::string &field_name,
+                   std::vector<StatsChannel> &channels)
+{
+    if(!data.has_path("fields/" + field_name))
+    {
+        // keep the channel so all ranks reduce the same records
+        StatsChannel channel;
+        channel.m_name = field_name;
+        channels.push_back(channel);
+        return;
+    }
+
+    const Node &field  = data["fields"][field_name];
+    const Node &values = field["values"];
+    
+    std::string association = "";
+    if(field.has_child("association"))
+    {
+        association = field["association"].as_string();
+    }
+
+    if(values.number_of_children() == 0)
+    {
+        StatsChannel channel;
+        channel.m_name = field_name;
+        channel.m_association = association;
+        channel.m_node = &values;
+        channels.push_back(channel);
+        return;
+    }
+
+    for(index_t i = 0; i < values.number_of_children(); i++)
+    {
+        StatsChannel channel;
+        channel.m_name = field_name + "/" + values.child(i).name();
+        channel.m_association = association;
+        channel.m_node = &values.child(i);
+        channels.push_back(channel);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+collect_channels(const Node &data,
+                 const Node &options,
+                 std::vector<StatsChannel> &channels)
+{
+    if(options.has_child("fields"))
+    {
+        const Node &fields = options["fields"];
+        if(fields.dtype().is_string())
+        {
+            add_field_channels(data, fields.as_string(), channels);
+        }
+        else
+        {
+            for(index_t i = 0; i < fields.number_of_children(); i++)
+            {
+                add_field_channels(data, fields.child(i).as_string(), channels);
+            }
+        }
+        return;
+    }
+
+    if(!data.has_child("fields"))
+    {
+        return;
+    }
+
+    const Node &fields = data["fields"];
+    for(index_t i = 0; i < fields.number_of_children(); i++)
+    {
+        const Node &values = fields.child(i)["values"];
+        bool numeric = values.dtype().is_number() ||
+                       values.number_of_children() > 0;
+        for(index_t c = 0; c < values.number_of_children(); c++)
+        {
+            numeric = numeric && values.child(c).dtype().is_number();
+        }
+
+        if(numeric)
+        {
+            add_field_channels(data, fields.child(i).name(), channels);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// First pass: count, min, max and sum. The loop bodies are branch free 
+// (NaN fails every comparison) so the compiler can vectorise them.
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+first_pass(const T *values,
+           index_t size,
+           index_t stride,
+           StatsChannel &channel)
+{
+    float64 count = 0.0;
+    float64 vmin  = channel.m_min;
+    float64 vmax  = channel.m_max;
+    float64 sum   = 0.0;
+
+    for(index_t i = 0; i < size; i++)
+    {
+        float64 v = (float64) values[i * stride];
+        bool valid = (v == v);
+        count += valid ? 1.0 : 0.0;
+        sum   += valid ? v : 0.0;
+        vmin   = v < vmin ? v : vmin;
+        vmax   = v > vmax ? v : vmax;
+    }
+
+    channel.m_count = count;
+    channel.m_min   = vmin;
+    channel.m_max   = vmax;
+    channel.m_sum   = sum;
+}
+
+//-----------------------------------------------------------------------------
+// Second pass: squared deviations from the local mean and the histogram
+// over [lo, lo + bins / inv_width].
+//-----------------------------------------------------------------------------
+template<typename T>
+void
+second_pass(const T *values,
+            index_t size,
+            index_t stride,
+            float64 lo,
+            float64 inv_width,
+            int bins,
+            StatsChannel &channel,
+            float64 *hist)
+{
+    float64 mean = channel.m_count > 0.0 ? channel.m_sum / channel.m_count : 0.0;
+    float64 m2   = 0.0;
+    float64 last = (float64)(bins - 1);
+
+    for(index_t i = 0; i < size; i++)
+    {
+        float64 v = (float64) values[i * stride];
+        if(v != v)
+        {
+            continue;
+        }
+        float64 d = v - mean;
+        m2 += d * d;
+        
+        float64 b = (v - lo) * inv_width;
+        b = b < 0.0  ? 0.0  : b;
+        b = b > last ? last : b;
+        hist[(int)b] += 1.0;
+    }
+
+    channel.m_m2 = m2;
+}
+
+//-----------------------------------------------------------------------------
+void
+run_first_pass(StatsChannel &channel)
+{
+    switch(channel.m_type)
+    {
+        case VALUES_FLOAT64:
+            first_pass((const float64*)channel.m_values, channel.m_size,
+                       channel.m_stride, channel);
+            break;
+        case VALUES_FLOAT32:
+            first_pass((const float32*)channel.m_values, channel.m_size,
+                       channel.m_stride, channel);
+            break;
+        case VALUES_INT32:
+            first_pass((const int32*)channel.m_values, channel.m_size,
+                       channel.m_stride, channel);
+            break;
+        case VALUES_INT64:
+            first_pass((const int64*)channel.m_values, channel.m_size,
+                       channel.m_stride, channel);
+            break;
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+run_second_pass(StatsChannel &channel,
+                float64 lo,
+                float64 inv_width,
+                int bins,
+                float64 *hist)
+{
+    switch(channel.m_type)
+    {
+        case VALUES_FLOAT64:
+            second_pass((const float64*)channel.m_values, channel.m_size,
+                        channel.m_stride, lo, inv_width, bins, channel, hist);
+            break;
+        case VALUES_FLOAT32:
+            second_pass((const float32*)channel.m_values, channel.m_size,
+                        channel.m_stride, lo, inv_width, bins, channel, hist);
+            break;
+        case VALUES_INT32:
+            second_pass((const int32*)channel.m_values, channel.m_size,
+                        channel.m_stride, lo, inv_width, bins, channel, hist);
+            break;
+        case VALUES_INT64:
+            second_pass((const int64*)channel.m_values, channel.m_size,
+                        channel.m_stride, lo, inv_width, bins, channel, hist);
+            break;
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Reduction buffer layout: 
+//   [0]                    number of channels C
+//   [1, C]                 minimums
+//   [C+1, 2C]              maximums
+//   [2C+1, ...]            per channel: count, sum of (mean_i - shift)
+//                          weighted by count, sum of squared deviations 
+//                          from shift, histogram counts
+//-----------------------------------------------------------------------------
+const int RECORD_COUNT   = 0;
+const int RECORD_DELTA   = 1;
+const int RECORD_SQUARES = 2;
+const int RECORD_HIST    = 3;
+
+#ifdef PARALLEL
+//-----------------------------------------------------------------------------
+void
+statistics_op(void *in_ptr, void *inout_ptr, int *len, MPI_Datatype *)
+{
+    const double *in = static_cast<const double*>(in_ptr);
+    double *inout    = static_cast<double*>(inout_ptr);
+    
+    int num_channels = (int) inout[0];
+    
+    for(int i = 1; i <= num_channels; i++)
+    {
+        inout[i] = in[i] < inout[i] ? in[i] : inout[i];
+    }
+
+    for(int i = num_channels + 1; i <= 2 * num_channels; i++)
+    {
+        inout[i] = in[i] > inout[i] ? in[i] : inout[i];
+    }
+
+    for(int i = 2 * num_channels + 1; i < *len; i++)
+    {
+        inout[i] += in[i];
+    }
+}
+#endif
+
+//-----------------------------------------------------------------------------
+float64
+percentile_from_histogram(const float64 *hist,
+                          int bins,
+                          float64 lo,
+                          float64 hi,
+                          float64 count,
+                          float64 percentile)
+{
+    float64 target = percentile / 100.0 * count;
+    float64 width  = (hi - lo) / bins;
+    float64 cum    = 0.0;
+
+    for(int b = 0; b < bins; b++)
+    {
+        if(hist[b] > 0.0 && cum + hist[b] >= target)
+        {
+            return lo + (b + (target - cum) / hist[b]) * width;
+        }
+        cum += hist[b];
+    }
+
+    return hi;
+}
+
+//-----------------------------------------------------------------------------
+// paths of the results in stats, components are nested under their field
+//-----------------------------------------------------------------------------
+void
+collect_result_names(const Node &stats,
+                     const std::string &prefix,
+                     std::vector<std::string> &names)
+{
+    for(index_t i = 0; i < stats.number_of_children(); i++)
+    {
+        const Node &child = stats.child(i);
+        std::string name = prefix + child.name();
+        if(child.has_child("count"))
+        {
+            names.push_back(name);
+        }
+        else
+        {
+            collect_result_names(child, name + "/", names);
+        }
+    }
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void
+compute_statistics(const conduit::Node &data,
+                   const conduit::Node &options,
+                   conduit::Node &stats)
+{
+    STRAWMAN_BLOCK_TIMER(STATISTICS);
+
+    int bins = 32;
+    if(options.has_child("bins"))
+    {
+        bins = options["bins"].to_int();
+        if(bins < 1)
+        {
+            STRAWMAN_ERROR("statistics: bins must be at least 1, got " << bins);
+        }
+    }
+
+    std::vector<float64> percentiles;
+    if(options.has_child("percentiles"))
+    {
+        Node n_percentiles;
+        options["percentiles"].to_float64_array(n_percentiles);
+        const float64 *p_ptr = n_percentiles.as_float64_ptr();
+        percentiles.assign(p_ptr, p_ptr + n_percentiles.dtype().number_of_elements());
+    }
+    else
+    {
+        percentiles.push_back(25.0);
+        percentiles.push_back(50.0);
+        percentiles.push_back(75.0);
+    }
+
+    for(size_t i = 0; i < percentiles.size(); i++)
+    {
+        if(percentiles[i] < 0.0 || percentiles[i] > 100.0)
+        {
+            STRAWMAN_ERROR("statistics: percentile " << percentiles[i] 
+                           << " is outside of [0, 100]");
+        }
+    }
+
+    bool fixed_range = options.has_path("range/min") && 
+                       options.has_path("range/max");
+
+#ifdef PARALLEL
+    MPI_Comm mpi_comm = MPI_COMM_WORLD;
+    if(options.has_child("mpi_comm"))
+    {
+        mpi_comm = MPI_Comm_f2c(options["mpi_comm"].to_int());
+    }
+#endif
+
+    std::vector<detail::StatsChannel> channels;
+    detail::collect_channels(data, options, channels);
+
+    // views are set once the channels no longer move, as they may point 
+    // into a channel's own copy of the values
+    for(size_t c = 0; c < channels.size(); c++)
+    {
+        if(channels[c].m_node != NULL)
+        {
+            detail::set_channel_values(*channels[c].m_node, channels[c]);
+        }
+    }
+    
+    const int num_channels = (int) channels.size();
+    const int record_size  = detail::RECORD_HIST + bins;
+    
+    for(int c = 0; c < num_channels; c++)
+    {
+        detail::run_first_pass(channels[c]);
+    }
+
+    // histogram range of each channel
+    std::vector<float64> lo(num_channels, 0.0);
+    std::vector<float64> hi(num_channels, 0.0);
+
+    if(fixed_range)
+    {
+        float64 range_min = options["range/min"].to_float64();
+        float64 range_max = options["range/max"].to_float64();
+        if(!(range_max >= range_min))
+        {
+            STRAWMAN_ERROR("statistics: range/max must not be less than"
+                           " range/min");
+        }
+        lo.assign(num_channels, range_min);
+        hi.assign(num_channels, range_max);
+    }
+    else
+    {
+        // max is negated so one min reduction covers both
+        std::vector<float64> extents(2 * num_channels);
+        for(int c = 0; c < num_channels; c++)
+        {
+            extents[c] = channels[c].m_min;
+            extents[num_channels + c] = -channels[c].m_max;
+        }
+
+#ifdef PARALLEL
+        if(num_channels > 0)
+        {
+            std::vector<float64> local_extents(extents);
+            MPI_Allreduce(&local_extents[0], &extents[0], 2 * num_channels,
+                          MPI_DOUBLE, MPI_MIN, mpi_comm);
+        }
+#endif
+        for(int c = 0; c < num_channels; c++)
+        {
+            // no values anywhere
+            if(extents[c] > -extents[num_channels + c])
+            {
+                continue;
+            }
+            lo[c] = extents[c];
+            hi[c] = -extents[num_channels + c];
+        }
+    }
+
+    std::vector<float64> buffer(1 + 2 * num_channels + 
+                                num_channels * record_size, 0.0);
+    buffer[0] = num_channels;
+
+    for(int c = 0; c < num_channels; c++)
+    {
+        detail::StatsChannel &channel = channels[c];
+        float64 *record = &buffer[1 + 2 * num_channels + c * record_size];
+        float64 inv_width = hi[c] > lo[c] ? bins / (hi[c] - lo[c]) : 0.0;
+
+        detail::run_second_pass(channel, lo[c], inv_width, bins,
+                                record + detail::RECORD_HIST);
+
+        buffer[1 + c] = channel.m_min;
+        buffer[1 + num_channels + c] = channel.m_max;
+
+        if(channel.m_count > 0.0)
+        {
+            // deviations are taken from a shift shared by all ranks, so
+            // they can be summed
+            float64 shift = 0.5 * (lo[c] + hi[c]);
+            float64 delta = channel.m_sum / channel.m_count - shift;
+            record[detail::RECORD_COUNT]   = channel.m_count;
+            record[detail::RECORD_DELTA]   = channel.m_count * delta;
+            record[detail::RECORD_SQUARES] = channel.m_m2 + 
+                                             channel.m_count * delta * delta;
+        }
+    }
+
+#ifdef PARALLEL
+    if(num_channels > 0)
+    {
+        std::vector<float64> local_buffer(buffer);
+        MPI_Op stats_op;
+        MPI_Op_create(&detail::statistics_op, 1, &stats_op);
+        MPI_Allreduce(&local_buffer[0], &buffer[0], (int)buffer.size(),
+                      MPI_DOUBLE, stats_op, mpi_comm);
+        MPI_Op_free(&stats_op);
+    }
+#endif
+
+    stats.reset();
+    
+    for(int c = 0; c < num_channels; c++)
+    {
+        const detail::StatsChannel &channel = channels[c];
+        const float64 *record = &buffer[1 + 2 * num_channels + c * record_size];
+        float64 count = record[detail::RECORD_COUNT];
+        
+        float64 vmin = 0.0;
+        float64 vmax = 0.0;
+        float64 mean = 0.0;
+        float64 variance = 0.0;
+        
+        if(count > 0.0)
+        {
+            float64 shift = 0.5 * (lo[c] + hi[c]);
+            float64 delta = record[detail::RECORD_DELTA];
+            vmin = buffer[1 + c];
+            vmax = buffer[1 + num_channels + c];
+            mean = shift + delta / count;
+            variance = (record[detail::RECORD_SQUARES] - delta * delta / count)
+                       / count;
+            variance = variance < 0.0 ? 0.0 : variance;
+        }
+
+        Node &res = stats[channel.m_name];
+        res["association"] = channel.m_association;
+        res["count"]       = (int64) count;
+        res["min"]         = vmin;
+        res["max"]         = vmax;
+        res["mean"]        = mean;
+        res["variance"]    = variance;
+        res["std_dev"]     = std::sqrt(variance);
+
+        for(size_t p = 0; p < percentiles.size(); p++)
+        {
+            float64 value = 0.0;
+            if(count > 0.0)
+            {
+                value = detail::percentile_from_histogram(record + detail::RECORD_HIST,
+                                                          bins, lo[c], hi[c],
+                                                          count, percentiles[p]);
+                value = value < vmin ? vmin : value;
+                value = value > vmax ? vmax : value;
+            }
+            std::ostringstream oss;
+            oss << "p" << percentiles[p];
+            res["percentiles"][oss.str()] = value;
+        }
+
+        res["histogram/min"] = lo[c];
+        res["histogram/max"] = hi[c];
+        res["histogram/counts"].set(DataType::int64(bins));
+        int64 *counts = res["histogram/counts"].as_int64_ptr();
+        for(int b = 0; b < bins; b++)
+        {
+            counts[b] = (int64) record[detail::RECORD_HIST + b];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+append_statistics_log(const std::string &file_name,
+                      int cycle,
+                      const conduit::Node &stats)
+{
+    std::vector<std::string> names;
+    detail::collect_result_names(stats, "", names);
+    if(names.empty())
+    {
+        return;
+    }
+
+    bool new_file = !conduit::utils::is_file(file_name);
+    
+    std::ofstream ofs(file_name.c_str(), std::ios::app);
+    if(!ofs.is_open())
+    {
+        STRAWMAN_ERROR("statistics: failed to open log file " << file_name);
+    }
+
+    if(new_file)
+    {
+        ofs << "cycle,field,count,min,max,mean,variance";
+        const Node &percentiles = stats[names[0]]["percentiles"];
+        for(index_t p = 0; p < percentiles.number_of_children(); p++)
+        {
+            ofs << "," << percentiles.child(p).name();
+        }
+        ofs << std::endl;
+    }
+
+    ofs.precision(10);
+
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        const Node &res = stats[names[i]];
+        ofs << cycle                      << ","
+            << names[i]                   << ","
+            << res["count"].to_int64()    << ","
+            << res["min"].to_float64()    << ","
+            << res["max"].to_float64()    << ","
+            << res["mean"].to_float64()   << ","
+            << res["variance"].to_float64();
+
+        const Node &percentiles = res["percentiles"];
+        for(index_t p = 0; p < percentiles.number_of_children(); p++)
+        {
+            ofs << "," << percentiles.child(p).to_float64();
+        }
+        ofs << std::endl;
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_statistics.hpp
+///
+//-----------------------------------------------------------------------------
+#ifndef STRAWMAN_STATISTICS_HPP
+#define STRAWMAN_STATISTICS_HPP
+
+#include <string>
+
+#include <conduit.hpp>
+
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// Computes global statistics and a histogram of the fields of a blueprint 
+// mesh domain. Each rank makes two passes over its values and the results
+// are combined with one MPI reduction (plus a small min/max reduction when
+// the histogram range is not given), so every rank gets the global result.
+//
+// options:
+//   fields      : (optional) field name or list of field names, by default
+//                 all numeric fields. Every rank must publish the same 
+//                 fields.
+//   bins        : (optional) number of histogram bins, default 32
+//   percentiles : (optional) list of percentiles in [0,100], default 
+//                 [25, 50, 75]
+//   range       : (optional) fixed histogram range, range/min and 
+//                 range/max. Values outside of it are counted in the end
+//                 bins and the min/max reduction is skipped.
+//   mpi_comm    : fortran handle of the MPI communicator (MPI builds only)
+//
+// For each field stats holds (components of multi-component fields are 
+// nested under the field name):
+//   association, count, min, max, mean, variance, std_dev,
+//   percentiles/p<value>, histogram/min, histogram/max, histogram/counts
+//
+// NaN values are skipped. Percentiles are interpolated within the 
+// histogram bins, so they are accurate to one bin width.
+//-----------------------------------------------------------------------------
+void compute_statistics(const conduit::Node &data,
+                        const conduit::Node &options,
+                        conduit::Node &stats);
+
+//-----------------------------------------------------------------------------
+// Appends one line per field of compute_statistics() results to a CSV
+// file, writing a header when the file is new.
+//-----------------------------------------------------------------------------
+void append_statistics_log(const std::string &file_name,
+                           int cycle,
+                           const conduit::Node &stats);
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
+
+
+#endif
+//-----------------------------------------------------------------------------
+// -- end header ifdef guard
+//-----------------------------------------------------------------------------
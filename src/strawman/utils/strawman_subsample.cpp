@@ -0,0 +1,635 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_subsample.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "strawman_subsample.hpp"
+
+#include "strawman_logging.hpp"
+#include "strawman_block_timer.hpp"
+
+// standard includes
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace conduit;
+
+//-----------------------------------------------------------------------------
+// -- begin strawman:: --
+//-----------------------------------------------------------------------------
+namespace strawman
+{
+
+//-----------------------------------------------------------------------------
+// -- begin strawman::detail --
+//-----------------------------------------------------------------------------
+namespace detail
+{
+
+const char *AXIS_NAMES[3]    = {"x", "y", "z"};
+const char *DIM_NAMES[3]     = {"i", "j", "k"};
+const char *SPACING_NAMES[3] = {"dx", "dy", "dz"};
+
+//-----------------------------------------------------------------------------
+// Point and element extents of the input and output. Missing axes have 
+// one point and one element, so 2D meshes use the same loops.
+//
+// m_index holds the input point kept for each output point. The last point
+// of the window is always kept, so neighboring domains meet; when the
+// stride does not divide the window the last output element is shorter
+// and the grid is not regular. Output element i covers the input elements
+// [m_index[i], m_index[i + 1]), missing axes have the index {0, 1}.
+//-----------------------------------------------------------------------------
+struct SubsampleGrid
+{
+    int      m_num_axes;
+    index_t  m_stride[3];
+    index_t  m_start[3];
+    index_t  m_in_points[3];
+    index_t  m_in_cells[3];
+    index_t  m_out_points[3];
+    index_t  m_out_cells[3];
+    bool     m_regular;
+    std::vector<index_t> m_index[3];
+
+    index_t NumOutPoints() const 
+    {
+        return m_out_points[0] * m_out_points[1] * m_out_points[2];
+    }
+
+    index_t NumOutCells() const 
+    {
+        return m_out_cells[0] * m_out_cells[1] * m_out_cells[2];
+    }
+};
+
+//-----------------------------------------------------------------------------
+void
+init_grid(const index_t dims[3],
+          int num_axes,
+          const Node &options,
+          SubsampleGrid &grid)
+{
+    grid.m_num_axes = num_axes;
+    grid.m_regular  = true;
+
+    index_t stride[3] = {2, 2, 2};
+    if(options.has_child("stride"))
+    {
+        Node n_stride;
+        options["stride"].to_int64_array(n_stride);
+        const int64 *vals = n_stride.as_int64_ptr();
+        index_t num_vals = n_stride.dtype().number_of_elements();
+        for(int a = 0; a < 3; a++)
+        {
+            stride[a] = vals[a < num_vals ? a : num_vals - 1];
+        }
+    }
+
+    // optional window of points, by default the whole axis
+    index_t start[3] = {0, 0, 0};
+    index_t end[3]   = {dims[0], dims[1], dims[2]};
+    if(options.has_path("extent/start"))
+    {
+        Node n_start;
+        options["extent/start"].to_int64_array(n_start);
+        const int64 *vals = n_start.as_int64_ptr();
+        index_t num_vals = n_start.dtype().number_of_elements();
+        for(int a = 0; a < num_axes && a < num_vals; a++)
+        {
+            start[a] = vals[a];
+        }
+    }
+    if(options.has_path("extent/end"))
+    {
+        Node n_end;
+        options["extent/end"].to_int64_array(n_end);
+        const int64 *vals = n_end.as_int64_ptr();
+        index_t num_vals = n_end.dtype().number_of_elements();
+        for(int a = 0; a < num_axes && a < num_vals; a++)
+        {
+            end[a] = vals[a];
+        }
+    }
+
+    for(int a = 0; a < 3; a++)
+    {
+        if(a >= num_axes)
+        {
+            grid.m_stride[a]     = 1;
+            grid.m_start[a]      = 0;
+            grid.m_in_points[a]  = 1;
+            grid.m_in_cells[a]   = 1;
+            grid.m_out_points[a] = 1;
+            grid.m_out_cells[a]  = 1;
+            grid.m_index[a].resize(2);
+            grid.m_index[a][0] = 0;
+            grid.m_index[a][1] = 1;
+            continue;
+        }
+
+        if(stride[a] < 1)
+        {
+            STRAWMAN_ERROR("subsample: stride must be at least 1, got "
+                           << stride[a]);
+        }
+
+        if(dims[a] < 2)
+        {
+            STRAWMAN_ERROR("subsample: axis " << AXIS_NAMES[a] 
+                           << " needs at least two points");
+        }
+
+        if(start[a] < 0 || end[a] > dims[a] || end[a] - start[a] < 2)
+        {
+            STRAWMAN_ERROR("subsample: extent [" << start[a] << ", " 
+                           << end[a] << ") along axis " << AXIS_NAMES[a]
+                           << " must hold at least two of the " << dims[a]
+                           << " points");
+        }
+
+        // ceil((points - 1) / stride) elements, the last one may be short
+        index_t num_points = end[a] - start[a];
+        grid.m_stride[a]     = stride[a];
+        grid.m_start[a]      = start[a];
+        grid.m_in_points[a]  = dims[a];
+        grid.m_in_cells[a]   = dims[a] - 1;
+        grid.m_out_cells[a]  = (num_points - 2 + stride[a]) / stride[a];
+        grid.m_out_points[a] = grid.m_out_cells[a] + 1;
+
+        if((num_points - 1) % stride[a] != 0)
+        {
+            grid.m_regular = false;
+        }
+
+        grid.m_index[a].resize(grid.m_out_points[a]);
+        for(index_t i = 0; i < grid.m_out_points[a]; i++)
+        {
+            grid.m_index[a][i] = std::min(start[a] + i * stride[a], end[a] - 1);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Copies the values of a structured array at the given indices along each
+// axis into a compact array of the same type.
+//-----------------------------------------------------------------------------
+void
+gather_values(const Node &values,
+              const index_t in_dims[3],
+              const std::vector<index_t> index[3],
+              const index_t out_dims[3],
+              Node &out)
+{
+    const DataType &dtype = values.dtype();
+    index_t element_bytes = dtype.element_bytes();
+    index_t num_out = out_dims[0] * out_dims[1] * out_dims[2];
+
+    if(dtype.number_of_elements() != in_dims[0] * in_dims[1] * in_dims[2])
+    {
+        STRAWMAN_ERROR("subsample: field has " << dtype.number_of_elements()
+                       << " values, expected " 
+                       << in_dims[0] * in_dims[1] * in_dims[2]);
+    }
+
+    out.set(DataType(dtype.id(),
+                     num_out,
+                     0,
+                     element_bytes,
+                     element_bytes,
+                     dtype.endianness()));
+
+    const uint8 *src = (const uint8*) values.element_ptr(0);
+    uint8 *dst = (uint8*) out.data_ptr();
+    index_t src_stride = dtype.stride();
+    const index_t *cols = &index[0][0];
+
+    for(index_t k = 0; k < out_dims[2]; k++)
+    {
+        for(index_t j = 0; j < out_dims[1]; j++)
+        {
+            index_t row = (index[2][k] * in_dims[1] + index[1][j]) * in_dims[0];
+            const uint8 *src_row = src + row * src_stride;
+            for(index_t i = 0; i < out_dims[0]; i++)
+            {
+                memcpy(dst, src_row + cols[i] * src_stride, element_bytes);
+                dst += element_bytes;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Stores the mean of the input elements covered by each output element,
+// stride[0] x stride[1] x stride[2] of them except along the last layers
+// of an irregular grid.
+//-----------------------------------------------------------------------------
+void
+average_values(const Node &values,
+               const SubsampleGrid &grid,
+               Node &out)
+{
+    const index_t *in_dims  = grid.m_in_cells;
+    const index_t *out_dims = grid.m_out_cells;
+    const std::vector<index_t> *index = grid.m_index;
+
+    if(values.dtype().number_of_elements() != 
+       in_dims[0] * in_dims[1] * in_dims[2])
+    {
+        STRAWMAN_ERROR("subsample: field has " 
+                       << values.dtype().number_of_elements()
+                       << " values, expected " 
+                       << in_dims[0] * in_dims[1] * in_dims[2]);
+    }
+
+    Node n_src;
+    const float64 *src = NULL;
+    if(values.dtype().is_float64() && values.is_contiguous())
+    {
+        src = (const float64*) values.element_ptr(0);
+    }
+    else
+    {
+        values.to_float64_array(n_src);
+        src = n_src.as_float64_ptr();
+    }
+
+    out.set(DataType::float64(grid.NumOutCells()));
+    float64 *dst = out.as_float64_ptr();
+    
+    const index_t slab = in_dims[0] * in_dims[1];
+
+    for(index_t k = 0; k < out_dims[2]; k++)
+    {
+        const index_t k_end = index[2][k + 1];
+        for(index_t j = 0; j < out_dims[1]; j++)
+        {
+            const index_t j_end = index[1][j + 1];
+            for(index_t i = 0; i < out_dims[0]; i++)
+            {
+                const index_t i_end = index[0][i + 1];
+                float64 sum = 0.0;
+                for(index_t kk = index[2][k]; kk < k_end; kk++)
+                {
+                    for(index_t jj = index[1][j]; jj < j_end; jj++)
+                    {
+                        const float64 *row = src + kk * slab + jj * in_dims[0];
+                        for(index_t ii = index[0][i]; ii < i_end; ii++)
+                        {
+                            sum += row[ii];
+                        }
+                    }
+                }
+                index_t count = (k_end - index[2][k]) * 
+                                (j_end - index[1][j]) *
+                                (i_end - index[0][i]);
+                *dst++ = sum / (float64)count;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// fields option: a field name or a list of field names
+//-----------------------------------------------------------------------------
+bool
+has_field(const Node &fields, const std::string &name)
+{
+    if(fields.dtype().is_string())
+    {
+        return fields.as_string() == name;
+    }
+
+    for(index_t i = 0; i < fields.number_of_children(); i++)
+    {
+        if(fields.child(i).as_string() == name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+void
+subsample_field(const Node &field,
+                const SubsampleGrid &grid,
+                bool average,
+                Node &out)
+{
+    const std::string association = field["association"].as_string();
+    
+    NodeConstIterator itr = field.children();
+    while(itr.has_next())
+    {
+        const Node &child = itr.next();
+        if(itr.name() != "values")
+        {
+            out[itr.name()].set(child);
+        }
+    }
+
+    const Node &values = field["values"];
+    const index_t num_comps = values.number_of_children();
+    
+    for(index_t c = 0; c < (num_comps == 0 ? 1 : num_comps); c++)
+    {
+        const Node &in_vals = num_comps == 0 ? values : values.child(c);
+        Node &out_vals = num_comps == 0 ? out["values"] : 
+                                          out["values"][values.child(c).name()];
+
+        if(association == "vertex")
+        {
+            gather_values(in_vals, grid.m_in_points, grid.m_index,
+                          grid.m_out_points, out_vals);
+        }
+        else if(association == "element" && average)
+        {
+            average_values(in_vals, grid, out_vals);
+        }
+        else if(association == "element")
+        {
+            // the first input element of each output element
+            gather_values(in_vals, grid.m_in_cells, grid.m_index,
+                          grid.m_out_cells, out_vals);
+        }
+        else
+        {
+            STRAWMAN_ERROR("subsample: unsupported field association " 
+                           << association);
+        }
+    }
+}
+
+};
+//-----------------------------------------------------------------------------
+// -- end strawman::detail --
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void
+subsample_mesh(const conduit::Node &mesh,
+               const conduit::Node &options,
+               conduit::Node &out)
+{
+    STRAWMAN_BLOCK_TIMER(SUBSAMPLE);
+
+    if(!mesh.has_child("topologies") || 
+       mesh["topologies"].number_of_children() == 0)
+    {
+        STRAWMAN_ERROR("subsample: mesh has no topologies");
+    }
+
+    std::string topo_name = mesh["topologies"].child(0).name();
+    if(options.has_child("topology"))
+    {
+        topo_name = options["topology"].as_string();
+        if(!mesh["topologies"].has_child(topo_name))
+        {
+            STRAWMAN_ERROR("subsample: unknown topology " << topo_name);
+        }
+    }
+
+    bool average = false;
+    if(options.has_child("resample"))
+    {
+        std::string resample = options["resample"].as_string();
+        if(resample == "average")
+        {
+            average = true;
+        }
+        else if(resample != "sample")
+        {
+            STRAWMAN_ERROR("subsample: unknown resample mode " << resample
+                           << " (expected sample or average)");
+        }
+    }
+
+    const Node &topo = mesh["topologies"][topo_name];
+    const std::string topo_type   = topo["type"].as_string();
+    const std::string coords_name = topo["coordset"].as_string();
+    const Node &coords = mesh["coordsets"][coords_name];
+
+    if(topo_type != "uniform" && topo_type != "rectilinear")
+    {
+        STRAWMAN_ERROR("subsample: only uniform and rectilinear topologies"
+                       " are supported, topology " << topo_name 
+                       << " is " << topo_type);
+    }
+
+    // number of points along each axis
+    index_t dims[3] = {1, 1, 1};
+    int num_axes = 0;
+    for(int a = 0; a < 3; a++)
+    {
+        if(topo_type == "uniform" && coords.has_path(std::string("dims/") + 
+                                                     detail::DIM_NAMES[a]))
+        {
+            dims[a] = coords["dims"][detail::DIM_NAMES[a]].to_index_t();
+            num_axes = a + 1;
+        }
+        else if(topo_type == "rectilinear" && 
+                coords.has_path(std::string("values/") + detail::AXIS_NAMES[a]))
+        {
+            dims[a] = coords["values"][detail::AXIS_NAMES[a]].dtype().number_of_elements();
+            num_axes = a + 1;
+        }
+    }
+
+    detail::SubsampleGrid grid;
+    detail::init_grid(dims, num_axes, options, grid);
+
+    out.reset();
+
+    if(mesh.has_child("state"))
+    {
+        out["state"].set_external(mesh["state"]);
+    }
+
+    //
+    // A short last element can not be described by uniform spacing, so
+    // irregular grids of uniform topologies become rectilinear
+    //
+    std::string out_topo_type = topo_type;
+    if(topo_type == "uniform" && !grid.m_regular)
+    {
+        out_topo_type = "rectilinear";
+    }
+
+    Node &out_coords = out["coordsets"][coords_name];
+    out_coords["type"] = out_topo_type;
+
+    if(topo_type == "uniform" && grid.m_regular)
+    {
+        for(int a = 0; a < num_axes; a++)
+        {
+            const char *dim_name     = detail::DIM_NAMES[a];
+            const char *axis_name    = detail::AXIS_NAMES[a];
+            const char *spacing_name = detail::SPACING_NAMES[a];
+            
+            out_coords["dims"][dim_name] = (int64) grid.m_out_points[a];
+            
+            float64 spacing = 1.0;
+            if(coords.has_path(std::string("spacing/") + spacing_name))
+            {
+                spacing = coords["spacing"][spacing_name].to_float64();
+            }
+            out_coords["spacing"][spacing_name] = spacing * grid.m_stride[a];
+
+            float64 origin = 0.0;
+            if(coords.has_path(std::string("origin/") + axis_name))
+            {
+                origin = coords["origin"][axis_name].to_float64();
+            }
+
+            if(coords.has_child("origin") || grid.m_start[a] > 0)
+            {
+                out_coords["origin"][axis_name] = origin + 
+                                                  spacing * grid.m_start[a];
+            }
+        }
+    }
+    else if(topo_type == "uniform")
+    {
+        for(int a = 0; a < num_axes; a++)
+        {
+            float64 spacing = 1.0;
+            if(coords.has_path(std::string("spacing/") + detail::SPACING_NAMES[a]))
+            {
+                spacing = coords["spacing"][detail::SPACING_NAMES[a]].to_float64();
+            }
+
+            float64 origin = 0.0;
+            if(coords.has_path(std::string("origin/") + detail::AXIS_NAMES[a]))
+            {
+                origin = coords["origin"][detail::AXIS_NAMES[a]].to_float64();
+            }
+
+            Node &axis = out_coords["values"][detail::AXIS_NAMES[a]];
+            axis.set(DataType::float64(grid.m_out_points[a]));
+            float64 *axis_vals = axis.as_float64_ptr();
+            for(index_t i = 0; i < grid.m_out_points[a]; i++)
+            {
+                axis_vals[i] = origin + spacing * grid.m_index[a][i];
+            }
+        }
+    }
+    else if(!grid.m_regular)
+    {
+        // copies of the kept coordinates
+        const std::vector<index_t> first(1, 0);
+        for(int a = 0; a < num_axes; a++)
+        {
+            const std::vector<index_t> axis_index[3] = {grid.m_index[a],
+                                                        first,
+                                                        first};
+            index_t in_dims[3]  = {dims[a], 1, 1};
+            index_t out_dims[3] = {grid.m_out_points[a], 1, 1};
+            detail::gather_values(coords["values"][detail::AXIS_NAMES[a]],
+                                  in_dims,
+                                  axis_index,
+                                  out_dims,
+                                  out_coords["values"][detail::AXIS_NAMES[a]]);
+        }
+    }
+    else
+    {
+        // strided views of the input coordinate arrays
+        for(int a = 0; a < num_axes; a++)
+        {
+            const Node &axis = coords["values"][detail::AXIS_NAMES[a]];
+            const DataType &dtype = axis.dtype();
+            out_coords["values"][detail::AXIS_NAMES[a]].set_external(
+                                        DataType(dtype.id(),
+                                                 grid.m_out_points[a],
+                                                 dtype.offset() + 
+                                                 dtype.stride() * grid.m_start[a],
+                                                 dtype.stride() * grid.m_stride[a],
+                                                 dtype.element_bytes(),
+                                                 dtype.endianness()),
+                                        axis.data_ptr());
+        }
+    }
+
+    Node &out_topo = out["topologies"][topo_name];
+    out_topo["type"]     = out_topo_type;
+    out_topo["coordset"] = coords_name;
+
+    if(!mesh.has_child("fields"))
+    {
+        return;
+    }
+
+    NodeConstIterator itr = mesh["fields"].children();
+    while(itr.has_next())
+    {
+        const Node &field = itr.next();
+        if(field["topology"].as_string() != topo_name)
+        {
+            continue;
+        }
+
+        if(options.has_child("fields") && 
+           !detail::has_field(options["fields"], itr.name()))
+        {
+            continue;
+        }
+        detail::subsample_field(field, grid, average,
+                                out["fields"][itr.name()]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+};
+//-----------------------------------------------------------------------------
+// -- end strawman:: --
+//-----------------------------------------------------------------------------
@@ -53,6 +53,10 @@
 #include <strawman_config.h>
 #include <strawman_logging.hpp>
 
+// standard lib includes
+#include <fstream>
+#include <chrono>
+
 // thirdparty includes
 #include <lodepng.h>
 
@@ -68,23 +72,145 @@ using namespace conduit::relay::web;
 namespace strawman
 {
 
+//-----------------------------------------------------------------------------
+// helper that reads a png file and base64 encodes its contents
+//-----------------------------------------------------------------------------
+bool
+base64_encode_png_file(const std::string &png_image_path,
+                       Node &png_data)
+{
+    std::ifstream file(png_image_path.c_str(),
+                       std::ios::binary);
+
+    if(!file.is_open())
+    {
+        STRAWMAN_WARN("ERROR Opening png file " << png_image_path);
+        return false;
+    }
+
+    // find out how big the png file is
+    file.seekg(0, std::ios::end);
+    std::streamsize png_raw_bytes = file.tellg();
+    file.seekg(0, std::ios::beg);
+    
+    // use a node to hold the buffers for raw and base64 encoded png data
+    png_data["raw"].set(DataType::c_char(png_raw_bytes));
+    char *png_raw_ptr = png_data["raw"].value();
+    
+    // read in the raw png data
+    if(!file.read(png_raw_ptr, png_raw_bytes))
+    {
+        // ERROR ... 
+        STRAWMAN_WARN("ERROR Reading png file " << png_image_path);
+        return false;
+    }
+
+    // base64 encode the raw png data
+    png_data["encoded"].set(DataType::char8_str(png_raw_bytes*2));
+    
+    utils::base64_encode(png_raw_ptr,
+                         png_raw_bytes,
+                         png_data["encoded"].data_ptr());
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 WebInterface::WebInterface(int ms_poll,
                            int ms_timeout)
 :m_server(NULL),
  m_ms_poll(ms_poll),
- m_ms_timeout(ms_timeout)
+ m_ms_timeout(ms_timeout),
+ m_max_fps(0.0),
+ m_target_width(-1),
+ m_target_height(-1),
+ m_running(false),
+ m_shutdown(false),
+ m_frame_pending(false),
+ m_frames_pushed(0),
+ m_frames_sent(0),
+ m_frames_dropped(0)
 {}
   
 //-----------------------------------------------------------------------------
 WebInterface::~WebInterface()
 {
-    if(m_server)
+    Shutdown();
+}
+
+//-----------------------------------------------------------------------------
+void
+WebInterface::SetOptions(const Node &options)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(options.has_path("web/fps"))
     {
-        delete m_server;
+        m_max_fps = options["web/fps"].to_float64();
+    }
+
+    if(options.has_path("web/width"))
+    {
+        m_target_width = options["web/width"].to_int();
+    }
+
+    if(options.has_path("web/height"))
+    {
+        m_target_height = options["web/height"].to_int();
     }
 }
 
+//-----------------------------------------------------------------------------
+int
+WebInterface::TargetWidth() const
+{
+    return m_target_width;
+}
+
+//-----------------------------------------------------------------------------
+int
+WebInterface::TargetHeight() const
+{
+    return m_target_height;
+}
+
+//-----------------------------------------------------------------------------
+void
+WebInterface::StartSender()
+{
+    // caller holds m_mutex
+    if(m_running || m_shutdown)
+    {
+        return;
+    }
+
+    m_running = true;
+    m_sender  = std::thread(&WebInterface::SendLoop, this);
+}
+
+//-----------------------------------------------------------------------------
+void
+WebInterface::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_running)
+        {
+            return;
+        }
+        m_shutdown = true;
+    }
+
+    m_cond.notify_all();
+    
+    if(m_sender.joinable())
+    {
+        m_sender.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running  = false;
+    m_shutdown = false;
+}
 
 //-----------------------------------------------------------------------------
 WebSocket *
@@ -107,87 +233,195 @@ WebInterface::Connection()
 
 //-----------------------------------------------------------------------------
 void
-WebInterface::PushMessage(Node &msg)
+WebInterface::SendLoop()
 {
-    //  Don't do any more work unless we have a valid client connection
-    WebSocket *wsock = Connection();
+    typedef std::chrono::steady_clock clock;
+    
+    clock::time_point last_send = clock::now();
+    bool              sent_once = false;
 
-    if(wsock == NULL)
+    while(true)
     {
-        return;
+        // this may block for up to m_ms_timeout, which is fine since
+        // we are not on the simulation's thread.
+        WebSocket *wsock = Connection();
+
+        Node frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            
+            if(!m_shutdown && (!m_frame_pending || wsock == NULL))
+            {
+                // nothing to do, wait for a new frame (or a client)
+                m_cond.wait_for(lock, std::chrono::milliseconds(10));
+            }
+
+            if(m_shutdown)
+            {
+                break;
+            }
+
+            // keep the latest frame in the mailbox until a client shows up
+            if(!m_frame_pending || wsock == NULL)
+            {
+                continue;
+            }
+
+            // pace sends to the requested frame rate, newer frames will
+            // replace the pending one in the meantime.
+            if(sent_once && m_max_fps > 0.0)
+            {
+                clock::time_point next_send = last_send +
+                    std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double>(1.0 / m_max_fps));
+                clock::time_point now = clock::now();
+                if(now < next_send)
+                {
+                    // sleep until the next send (or shutdown), instead
+                    // of spinning on the pending frame
+                    m_cond.wait_for(lock, next_send - now);
+                    continue;
+                }
+            }
+
+            frame.set(m_mailbox);
+            m_mailbox.reset();
+            m_frame_pending = false;
+        }
+
+        last_send = clock::now();
+        sent_once = true;
+
+        if(frame.has_child("status"))
+        {
+            wsock->send(frame["status"]);
+        }
+
+        Node msg;
+
+        if(frame.has_path("image/png"))
+        {
+            // base64 encode the raw png data
+            Node &n_png = frame["image/png"];
+            index_t png_raw_bytes = n_png.dtype().number_of_elements();
+            Node n_encoded;
+            n_encoded.set(DataType::char8_str(png_raw_bytes*2));
+            utils::base64_encode(n_png.data_ptr(),
+                                 png_raw_bytes,
+                                 n_encoded.data_ptr());
+            
+            msg["type"] = "image";
+            msg["data"] = "data:image/png;base64," + n_encoded.as_string();
+        }
+        else if(frame.has_path("image/file"))
+        {
+            std::string png_image_path = frame["image/file"].as_string();
+            STRAWMAN_INFO("png path:" << png_image_path);
+
+            Node png_data;
+            if(base64_encode_png_file(png_image_path, png_data))
+            {
+                msg["type"] = "image";
+                msg["data"] = "data:image/png;base64," + 
+                              png_data["encoded"].as_string();
+            }
+        }
+
+        if(msg.has_child("type"))
+        {
+            // send the message
+            wsock->send(msg);
+            
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames_sent++;
+        }
+    }
+
+    if(m_server != NULL)
+    {
+        delete m_server;
+        m_server = NULL;
     }
-    
-    // sent the message
-    wsock->send(msg);
 }
 
 //-----------------------------------------------------------------------------
 void
-WebInterface::PushImage(PNGEncoder &png)
+WebInterface::Deposit(const Node &msg,
+                      const char *slot)
 {
-    //  Don't do any more work unless we have a valid client connection
-    WebSocket *wsock = Connection();
-
-    if(wsock == NULL)
     {
-        return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        StartSender();
+
+        if(std::string(slot) == "image")
+        {
+            m_frames_pushed++;
+            // an image the sender never picked up is now stale
+            if(m_mailbox.has_child("image"))
+            {
+                m_frames_dropped++;
+            }
+        }
+        
+        m_mailbox[slot].set(msg);
+        m_frame_pending = true;
     }
-    // create message with image data
-    png.Base64Encode();
-    Node msg;
-    msg["type"] = "image";
-    msg["data"] = "data:image/png;base64," + png.Base64Node().as_string();
-    // sent the message
-    wsock->send(msg);
+
+    m_cond.notify_one();
 }
 
 //-----------------------------------------------------------------------------
 void
-WebInterface::PushImage(const std::string &png_image_path)
+WebInterface::PushMessage(Node &msg)
 {
-    //  Don't do any more work unless we have a valid client connection
-    WebSocket *wsock = Connection();
+    Deposit(msg, "status");
+}
 
-    if(wsock == NULL)
+//-----------------------------------------------------------------------------
+void
+WebInterface::PushImage(PNGEncoder &png)
+{
+    if(png.PngBuffer() == NULL)
     {
         return;
     }
     
-    STRAWMAN_INFO("png path:" << png_image_path);
+    // only copy the compressed png here, base64 encoding happens
+    // on the sender thread
+    Node image;
+    image["png"].set((uint8*)png.PngBuffer(),
+                     (index_t)png.PngBufferSize());
 
-    std::ifstream file(png_image_path.c_str(),
-                       std::ios::binary);
+    Deposit(image, "image");
+}
 
-    // find out how big the png file is
-    file.seekg(0, std::ios::end);
-    std::streamsize png_raw_bytes = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    // use a node to hold the buffers for raw and base64 encoded png data
-    Node png_data;
-    png_data["raw"].set(DataType::c_char(png_raw_bytes));
-    char *png_raw_ptr = png_data["raw"].value();
-    
-    // read in the raw png data
-    if(!file.read(png_raw_ptr, png_raw_bytes))
-    {
-        // ERROR ... 
-        STRAWMAN_WARN("ERROR Reading png file " << png_image_path);
-    }
+//-----------------------------------------------------------------------------
+void
+WebInterface::PushImage(const std::string &png_image_path)
+{
+    Node image;
+    image["file"] = png_image_path;
 
-    // base64 encode the raw png data
-    png_data["encoded"].set(DataType::char8_str(png_raw_bytes*2));
+    Deposit(image, "image");
+}
+
+//-----------------------------------------------------------------------------
+void
+WebInterface::Info(Node &info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
     
-    utils::base64_encode(png_raw_ptr,
-                         png_raw_bytes,
-                         png_data["encoded"].data_ptr());
+    info["frames_pushed"]  = m_frames_pushed;
+    info["frames_sent"]    = m_frames_sent;
+    info["frames_dropped"] = m_frames_dropped;
+    info["frames_pending"] = (uint64)(m_mailbox.has_child("image") ? 1 : 0);
 
-    // create message with image data
-    Node msg;
-    msg["type"] = "image";
-    msg["data"] = "data:image/png;base64," + png_data["encoded"].as_string();
-    // send the message
-    wsock->send(msg);
+    // image files are small enough to report which frame is waiting
+    if(m_mailbox.has_path("image/file"))
+    {
+        info["pending_file"] = m_mailbox["image/file"].as_string();
+    }
 }
 
 
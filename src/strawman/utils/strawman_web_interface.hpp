@@ -52,6 +52,11 @@
 
 #include <string>
 
+// std lib thread support
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <conduit.hpp>
 #include <conduit_relay.hpp>
 
@@ -63,6 +68,20 @@
 namespace strawman
 {
 
+//-----------------------------------------------------------------------------
+//
+// WebInterface owns the web server and websocket sends on a separate
+// thread. Push calls only deposit the newest status message and image into a
+// single slot mailbox and return. If the client (or network) is slower than
+// the simulation, frames that were never sent are replaced by newer ones.
+//
+// Supported options (usually passed via Strawman::Open):
+//
+//    web/fps     : max number of frames per second sent to the client
+//    web/width   : preferred image width for web only renders
+//    web/height  : preferred image height for web only renders
+//
+//-----------------------------------------------------------------------------
 class WebInterface
 {
 public:
@@ -71,20 +90,53 @@ public:
                   int ms_timeout = 1);
 
     ~WebInterface();
-        
-    conduit::relay::web::WebSocket *Connection();
+
+    void                            SetOptions(const conduit::Node &options);
+
+    // client requested image size for web only renders, -1 if none
+    int                             TargetWidth() const;
+    int                             TargetHeight() const;
+
     void                            PushMessage(conduit::Node &msg);
     void                            PushImage(PNGEncoder &png);
     void                            PushImage(const std::string &png_file_path);
+
+    // send stats (pushed, sent, dropped and pending frames)
+    void                            Info(conduit::Node &info);
+
+    // stops the sender thread and shuts down the web server
+    void                            Shutdown();
         
 private:
+    void                            StartSender();
+    void                            SendLoop();
+    conduit::relay::web::WebSocket *Connection();
+    void                            Deposit(const conduit::Node &msg,
+                                            const char *slot);
+
+    // only touched by the sender thread
     conduit::relay::web::WebServer *m_server;
     int                             m_ms_poll;
     int                             m_ms_timeout;
-    
 
-    
+    // pacing + requested image size
+    double                          m_max_fps;
+    int                             m_target_width;
+    int                             m_target_height;
+
+    // sender thread and single slot mailbox
+    std::thread                     m_sender;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_cond;
+    bool                            m_running;
+    bool                            m_shutdown;
+    conduit::Node                   m_mailbox;
+    bool                            m_frame_pending;
 
+    // stats
+    conduit::uint64                 m_frames_pushed;
+    conduit::uint64                 m_frames_sent;
+    conduit::uint64                 m_frames_dropped;
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+//-----------------------------------------------------------------------------
+///
+/// file: t_strawman_block_timer.cpp
+///
+//-----------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include <strawman.hpp>
+
+#include <iostream>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#include "t_config.hpp"
+#include "t_strawman_test_utils.hpp"
+
+
+using namespace std;
+using namespace conduit;
+using namespace strawman;
+
+//-----------------------------------------------------------------------------
+void
+timed_block()
+{
+    STRAWMAN_BLOCK_TIMER(TRACE_TEST_BLOCK);
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_block_timer, test_trace_ring_buffer)
+{
+    string trace_file = prepare_output_dir();
+    trace_file = conduit::utils::join_file_path(trace_file,
+                                                "test_trace.json");
+
+    // keep the 4 newest events
+    BlockTimer::EnableTracing(4);
+    EXPECT_TRUE(BlockTimer::TracingEnabled());
+    
+    for(int cycle = 0; cycle < 6; cycle++)
+    {
+        BlockTimer::SetCycle(cycle);
+        timed_block();
+    }
+
+    BlockTimer::WriteTraceFile(trace_file);
+    EXPECT_TRUE(conduit::utils::is_file(trace_file));
+
+    Node trace;
+    trace.load(trace_file,"json");
+    trace.print();
+    
+    Node &events = trace["traceEvents"];
+    EXPECT_EQ(events.number_of_children(), 4);
+
+    for(int i = 0; i < events.number_of_children(); i++)
+    {
+        EXPECT_EQ(events[i]["name"].as_string(), "TRACE_TEST_BLOCK");
+        EXPECT_EQ(events[i]["ph"].as_string(), "X");
+        EXPECT_EQ(events[i]["pid"].to_int(), 0);
+        // oldest to newest
+        EXPECT_EQ(events[i]["args/cycle"].to_int(), i + 2);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+nested_timed_blocks()
+{
+    STRAWMAN_BLOCK_TIMER(REDUCE_TEST_OUTER);
+    for(int i = 0; i < 3; i++)
+    {
+        STRAWMAN_BLOCK_TIMER(REDUCE_TEST_INNER);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_block_timer, test_reduce_stats)
+{
+    nested_timed_blocks();
+    nested_timed_blocks();
+
+    Node &res = BlockTimer::Finalize();
+    res.print();
+
+    EXPECT_TRUE(res.has_path("children/REDUCE_TEST_OUTER"));
+    Node &inner = res["children/REDUCE_TEST_OUTER/children/REDUCE_TEST_INNER"];
+
+    EXPECT_EQ(inner["count"].to_int(), 6);
+    EXPECT_EQ(inner["ranks"].to_int(), 1);
+    EXPECT_EQ(inner["minid"].to_int(), 0);
+    EXPECT_EQ(inner["maxid"].to_int(), 0);
+    EXPECT_EQ(inner["min"].to_float64(), inner["max"].to_float64());
+    EXPECT_NEAR(inner["stddev"].to_float64(), 0.0, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_block_timer, test_hardware_counters)
+{
+    BlockTimer::EnableCounters();
+    
+    {
+        STRAWMAN_BLOCK_TIMER(COUNTER_TEST);
+        volatile double sum = 0.0;
+        for(int i = 0; i < 100000; i++)
+        {
+            sum += sqrt((double)i);
+        }
+    }
+
+    Node &res = BlockTimer::Finalize();
+    Node &counters = res["children/COUNTER_TEST/counters"];
+    counters.print();
+
+    // perf events may not be permitted where the tests run
+    if(BlockTimer::CountersAvailable())
+    {
+        EXPECT_TRUE(counters["cycles"].dtype().is_number());
+    }
+    else
+    {
+        EXPECT_EQ(counters["cycles"].as_string(), "unavailable");
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+threaded_timed_blocks()
+{
+    for(int i = 0; i < 10; i++)
+    {
+        STRAWMAN_BLOCK_TIMER(THREAD_TEST_OUTER);
+        STRAWMAN_BLOCK_TIMER(THREAD_TEST_INNER);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_block_timer, test_threads)
+{
+    // each thread has its own timer stack, the trees are merged by Finalize
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread(threaded_timed_blocks));
+    }
+    
+    for(size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    Node &res = BlockTimer::Finalize();
+    
+    EXPECT_EQ(res["children/THREAD_TEST_OUTER/count"].to_int(), 40);
+    EXPECT_EQ(res["children/THREAD_TEST_OUTER/children/THREAD_TEST_INNER/count"].to_int(), 40);
+    // timers only nest within a thread
+    EXPECT_FALSE(res.has_path("children/THREAD_TEST_OUTER/children/THREAD_TEST_OUTER"));
+}
@@ -51,6 +51,10 @@
 #include "gtest/gtest.h"
 
 #include <strawman.hpp>
+#include <strawman_capture.hpp>
+#include <strawman_subsample.hpp>
+#include <strawman_macrocell_grid.hpp>
+#include <strawman_raster_2d.hpp>
 
 #include <iostream>
 #include <math.h>
@@ -98,3 +102,543 @@ TEST(strawman_empty_pipeline, test_empty_pipeline)
     sman.Close();
 }
 
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_empty_pipeline_capture)
+{
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",20,20,0,data);
+
+    Node actions;
+    Node &hello = actions.append();
+    hello["action"]   = "hello!";
+
+    string capture_path = prepare_output_dir();
+    capture_path = conduit::utils::join_file_path(capture_path,
+                                                  "test_capture");
+
+    // only store the data of every other publish
+    Node open_opts;
+    open_opts["pipeline/type"] = "empty";
+    open_opts["capture/path"]  = capture_path;
+    open_opts["capture/data_stride"] = 2;
+
+    Strawman sman;
+    sman.Open(open_opts);
+    for(int cycle = 0; cycle < 3; cycle++)
+    {
+        sman.Publish(data);
+        sman.Execute(actions);
+    }
+    sman.Close();
+
+    string capture_file = capture_file_name(capture_path,0);
+    EXPECT_TRUE(conduit::utils::is_file(capture_file));
+
+    int expected[8] = {CAPTURE_OPEN,
+                       CAPTURE_PUBLISH,
+                       CAPTURE_EXECUTE,
+                       CAPTURE_PUBLISH_REPEAT,
+                       CAPTURE_EXECUTE,
+                       CAPTURE_PUBLISH,
+                       CAPTURE_EXECUTE,
+                       CAPTURE_CLOSE};
+
+    CaptureReader log;
+    log.Open(capture_file);
+
+    Node record;
+    int record_type = 0;
+    float64 timestamp = 0.0;
+    float64 last_timestamp = 0.0;
+    int num_records = 0;
+
+    while(log.Next(record_type,timestamp,record))
+    {
+        ASSERT_LT(num_records,8);
+        EXPECT_EQ(record_type,expected[num_records]);
+        EXPECT_GE(timestamp,last_timestamp);
+        last_timestamp = timestamp;
+
+        if(record_type == CAPTURE_OPEN)
+        {
+            EXPECT_EQ(record["pipeline/type"].as_string(),"empty");
+        }
+        else if(record_type == CAPTURE_PUBLISH)
+        {
+            EXPECT_EQ(record["fields/braid/values"].dtype().number_of_elements(),
+                      data["fields/braid/values"].dtype().number_of_elements());
+            EXPECT_EQ(record["fields/braid/values"].as_float64_ptr()[7],
+                      data["fields/braid/values"].as_float64_ptr()[7]);
+        }
+        else if(record_type == CAPTURE_PUBLISH_REPEAT)
+        {
+            EXPECT_TRUE(record.dtype().is_empty());
+        }
+        else if(record_type == CAPTURE_EXECUTE)
+        {
+            EXPECT_EQ(record[0]["action"].as_string(),"hello!");
+        }
+
+        num_records++;
+    }
+
+    EXPECT_EQ(num_records,8);
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_empty_pipeline_statistics)
+{
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",20,20,0,data);
+    
+    // a ramp field with known statistics
+    index_t num_vals = data["fields/braid/values"].dtype().number_of_elements();
+    data["fields/ramp/type"] = "scalar";
+    data["fields/ramp/association"] = "vertex";
+    data["fields/ramp/topology"] = "mesh";
+    data["fields/ramp/values"].set(DataType::float64(num_vals));
+    float64 *ramp = data["fields/ramp/values"].as_float64_ptr();
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        ramp[i] = (float64) i;
+    }
+
+    string output_path = prepare_output_dir();
+    string log_file = conduit::utils::join_file_path(output_path,
+                                                     "tout_statistics.csv");
+    if(conduit::utils::is_file(log_file))
+    {
+        conduit::utils::remove_file(log_file);
+    }
+
+    Node actions;
+    Node &stats_action = actions.append();
+    stats_action["action"] = "statistics";
+    stats_action["fields"].append() = "ramp";
+    stats_action["fields"].append() = "braid";
+    stats_action["bins"] = 40;
+    stats_action["log_file"] = log_file;
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "empty";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+    sman.Close();
+    info.print();
+
+    const Node &res = info["statistics/ramp"];
+    float64 n = (float64) num_vals;
+    EXPECT_EQ(res["association"].as_string(), "vertex");
+    EXPECT_EQ(res["count"].to_int64(), num_vals);
+    EXPECT_NEAR(res["min"].to_float64(), 0.0, 1e-12);
+    EXPECT_NEAR(res["max"].to_float64(), n - 1.0, 1e-12);
+    EXPECT_NEAR(res["mean"].to_float64(), (n - 1.0) / 2.0, 1e-9);
+    EXPECT_NEAR(res["variance"].to_float64(), (n * n - 1.0) / 12.0, 1e-6);
+    
+    // percentiles are accurate to one bin width
+    float64 bin_width = (n - 1.0) / 40.0;
+    EXPECT_NEAR(res["percentiles/p50"].to_float64(), (n - 1.0) / 2.0, bin_width);
+    EXPECT_NEAR(res["percentiles/p25"].to_float64(), (n - 1.0) / 4.0, bin_width);
+
+    EXPECT_EQ(res["histogram/counts"].dtype().number_of_elements(), 40);
+    int64 *counts = res["histogram/counts"].as_int64_ptr();
+    int64 total = 0;
+    for(int b = 0; b < 40; b++)
+    {
+        total += counts[b];
+    }
+    EXPECT_EQ(total, num_vals);
+
+    EXPECT_TRUE(info.has_path("statistics/braid/mean"));
+    EXPECT_TRUE(conduit::utils::is_file(log_file));
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_empty_pipeline_derived_fields)
+{
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",20,20,0,data);
+    
+    index_t num_vals = data["fields/braid/values"].dtype().number_of_elements();
+    data["fields/ramp/type"] = "scalar";
+    data["fields/ramp/association"] = "vertex";
+    data["fields/ramp/topology"] = "mesh";
+    data["fields/ramp/values"].set(DataType::int32(num_vals));
+    int32 *ramp = data["fields/ramp/values"].as_int32_ptr();
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        ramp[i] = (int32) i;
+    }
+
+    Node actions;
+    Node &derived = actions.append();
+    derived["action"] = "add_derived_field";
+    derived["field_name"] = "twice";
+    derived["expression"] = "2 * ramp";
+    // derived fields can read other derived fields
+    Node &shifted = actions.append();
+    shifted["action"] = "add_derived_field";
+    shifted["field_name"] = "shifted";
+    shifted["expression"] = "sqrt(twice * twice) - (ramp + 1) + 2^2";
+    Node &unused = actions.append();
+    unused["action"] = "add_derived_field";
+    unused["field_name"] = "unused";
+    unused["expression"] = "braid / ramp";
+
+    Node &stats_action = actions.append();
+    stats_action["action"] = "statistics";
+    stats_action["fields"] = "shifted";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "empty";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+
+    // redefining a field without a new publish recomputes it and the
+    // fields that read it
+    Node redefine;
+    Node &redefined = redefine.append();
+    redefined["action"] = "add_derived_field";
+    redefined["field_name"] = "twice";
+    redefined["expression"] = "3 * ramp";
+    redefine.append().set(stats_action);
+    sman.Execute(redefine);
+
+    Node redefined_info;
+    sman.Info(redefined_info);
+    sman.Close();
+
+    // shifted is ramp + 3
+    float64 n = (float64) num_vals;
+    const Node &res = info["statistics/shifted"];
+    EXPECT_EQ(res["association"].as_string(), "vertex");
+    EXPECT_EQ(res["count"].to_int64(), num_vals);
+    EXPECT_NEAR(res["min"].to_float64(), 3.0, 1e-12);
+    EXPECT_NEAR(res["max"].to_float64(), n + 2.0, 1e-12);
+    EXPECT_NEAR(res["mean"].to_float64(), (n - 1.0) / 2.0 + 3.0, 1e-9);
+
+    // then shifted is 2 * ramp + 3
+    const Node &redefined_res = redefined_info["statistics/shifted"];
+    EXPECT_NEAR(redefined_res["min"].to_float64(), 3.0, 1e-12);
+    EXPECT_NEAR(redefined_res["max"].to_float64(), 2.0 * n + 1.0, 1e-12);
+    EXPECT_NEAR(redefined_res["mean"].to_float64(), (n - 1.0) + 3.0, 1e-9);
+
+    // published data is not modified
+    EXPECT_FALSE(data.has_path("fields/twice"));
+    EXPECT_FALSE(data.has_path("fields/shifted"));
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_empty_pipeline_derived_field_errors)
+{
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",10,10,0,data);
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "empty";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+
+    Node actions;
+    Node &derived = actions.append();
+    derived["action"] = "add_derived_field";
+    derived["field_name"] = "bad";
+    derived["expression"] = "sqrt(braid";
+    EXPECT_THROW(sman.Execute(actions), conduit::Error);
+
+    // unknown fields are reported once the field is read
+    derived["expression"] = "braid * missing";
+    Node &stats_action = actions.append();
+    stats_action["action"] = "statistics";
+    stats_action["fields"] = "bad";
+    EXPECT_THROW(sman.Execute(actions), conduit::Error);
+
+    sman.Close();
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_subsample)
+{
+    // uniform: implicit coordinates
+    Node data;
+    conduit::blueprint::mesh::examples::braid("uniform",21,21,0,data);
+    
+    Node opts, res;
+    opts["stride"] = 2;
+    opts["resample"] = "average";
+    subsample_mesh(data, opts, res);
+    
+    Node verify_info;
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(res,verify_info));
+    EXPECT_EQ(res["coordsets/coords/dims/i"].to_int64(), 11);
+    EXPECT_EQ(res["coordsets/coords/dims/j"].to_int64(), 11);
+    EXPECT_NEAR(res["coordsets/coords/spacing/dx"].to_float64(),
+                2.0 * data["coordsets/coords/spacing/dx"].to_float64(),
+                1e-12);
+
+    const float64 *braid = data["fields/braid/values"].as_float64_ptr();
+    const float64 *sub_braid = res["fields/braid/values"].as_float64_ptr();
+    EXPECT_EQ(res["fields/braid/values"].dtype().number_of_elements(), 121);
+    EXPECT_EQ(sub_braid[3 * 11 + 5], braid[6 * 21 + 10]);
+
+    // element fields hold the mean of each 2x2 block
+    const float64 *radial = data["fields/radial/values"].as_float64_ptr();
+    const float64 *sub_radial = res["fields/radial/values"].as_float64_ptr();
+    EXPECT_EQ(res["fields/radial/values"].dtype().number_of_elements(), 100);
+    float64 expected = 0.25 * (radial[2 * 20 + 4] + radial[2 * 20 + 5] +
+                               radial[3 * 20 + 4] + radial[3 * 20 + 5]);
+    EXPECT_NEAR(sub_radial[1 * 10 + 2], expected, 1e-12);
+
+    // rectilinear: strided views of the coordinate arrays
+    Node rect_data;
+    conduit::blueprint::mesh::examples::braid("rectilinear",21,13,0,rect_data);
+    opts["stride"].set(DataType::int64(2));
+    int64 *strides = opts["stride"].as_int64_ptr();
+    strides[0] = 4;
+    strides[1] = 3;
+    opts["resample"] = "sample";
+    subsample_mesh(rect_data, opts, res);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(res,verify_info));
+    EXPECT_EQ(res["coordsets/coords/values/x"].dtype().number_of_elements(), 6);
+    EXPECT_EQ(res["coordsets/coords/values/y"].dtype().number_of_elements(), 5);
+    EXPECT_EQ(res["coordsets/coords/values/x"].element_ptr(1),
+              rect_data["coordsets/coords/values/x"].element_ptr(4));
+    EXPECT_EQ(res["coordsets/coords/values/y"].as_float64_array()[2],
+              rect_data["coordsets/coords/values/y"].as_float64_array()[6]);
+    
+    radial = rect_data["fields/radial/values"].as_float64_ptr();
+    sub_radial = res["fields/radial/values"].as_float64_ptr();
+    EXPECT_EQ(res["fields/radial/values"].dtype().number_of_elements(), 20);
+    EXPECT_EQ(sub_radial[2 * 5 + 1], radial[6 * 20 + 4]);
+
+    // a stride that does not divide the points keeps the last point
+    // layer, with a short last element
+    Node odd_data;
+    conduit::blueprint::mesh::examples::braid("uniform",10,10,0,odd_data);
+    opts.reset();
+    opts["stride"] = 4;
+    opts["resample"] = "average";
+    subsample_mesh(odd_data, opts, res);
+
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(res,verify_info));
+    EXPECT_EQ(res["topologies/mesh/type"].as_string(), "rectilinear");
+    EXPECT_EQ(res["coordsets/coords/type"].as_string(), "rectilinear");
+    EXPECT_EQ(res["coordsets/coords/values/x"].dtype().number_of_elements(), 4);
+    EXPECT_EQ(res["coordsets/coords/values/y"].dtype().number_of_elements(), 4);
+
+    const Node &odd_coords = odd_data["coordsets/coords"];
+    float64 last_x = odd_coords["origin/x"].to_float64() +
+                     9.0 * odd_coords["spacing/dx"].to_float64();
+    EXPECT_NEAR(res["coordsets/coords/values/x"].as_float64_ptr()[3],
+                last_x,
+                1e-12);
+
+    braid = odd_data["fields/braid/values"].as_float64_ptr();
+    sub_braid = res["fields/braid/values"].as_float64_ptr();
+    EXPECT_EQ(res["fields/braid/values"].dtype().number_of_elements(), 16);
+    EXPECT_EQ(sub_braid[3 * 4 + 3], braid[9 * 10 + 9]);
+    EXPECT_EQ(sub_braid[2 * 4 + 3], braid[8 * 10 + 9]);
+
+    // the last elements average the input elements they cover
+    radial = odd_data["fields/radial/values"].as_float64_ptr();
+    sub_radial = res["fields/radial/values"].as_float64_ptr();
+    EXPECT_EQ(res["fields/radial/values"].dtype().number_of_elements(), 9);
+    EXPECT_NEAR(sub_radial[2 * 3 + 2], radial[8 * 9 + 8], 1e-12);
+    expected = 0.25 * (radial[0 * 9 + 8] + radial[1 * 9 + 8] +
+                       radial[2 * 9 + 8] + radial[3 * 9 + 8]);
+    EXPECT_NEAR(sub_radial[0 * 3 + 2], expected, 1e-12);
+
+    // the pipeline gets the subsampled mesh
+    Node actions;
+    Node &sub = actions.append();
+    sub["action"] = "subsample";
+    sub["stride"] = 2;
+    Node &hello = actions.append();
+    hello["action"] = "hello!";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "empty";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+    sman.Close();
+
+    ASSERT_TRUE(info.has_path("pipeline/mesh"));
+    const Node &mesh = info["pipeline/mesh"];
+    EXPECT_EQ(mesh["coordsets/coords/dims/i"].to_int64(), 11);
+    EXPECT_EQ(mesh["coordsets/coords/dims/j"].to_int64(), 11);
+    EXPECT_EQ(mesh["fields/braid/values"].to_int64(), 121);
+    EXPECT_EQ(mesh["fields/radial/values"].to_int64(), 100);
+    EXPECT_EQ(mesh["fields/vel/values"].to_int64(), 121);
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_macrocell_grid)
+{
+    //
+    // a field that is zero except for a single point
+    //
+    index_t dims[3] = {17, 17, 17};
+    Node values;
+    values.set(DataType::float64(17 * 17 * 17));
+    float64 *vals = values.as_float64_ptr();
+    for(index_t i = 0; i < 17 * 17 * 17; i++)
+    {
+        vals[i] = 0.0;
+    }
+    vals[(12 * 17 + 12) * 17 + 12] = 1.0;
+
+    MacrocellGrid grid;
+    grid.Build(values, dims, 8, 42);
+    EXPECT_EQ(grid.Key(), (uint64)42);
+    EXPECT_EQ(grid.NumberOfMacrocells(), 8);
+    EXPECT_EQ(grid.Min(), 0.0);
+    EXPECT_EQ(grid.Max(), 1.0);
+
+    // only values in the upper half of the range are opaque
+    std::vector<float> opacity(256, 0.0f);
+    for(int i = 128; i < 256; i++)
+    {
+        opacity[i] = 1.0f;
+    }
+
+    index_t start[3], end[3];
+    EXPECT_EQ(grid.VisibleExtent(opacity, 0.0, 1.0, start, end), 1);
+    for(int a = 0; a < 3; a++)
+    {
+        EXPECT_EQ(start[a], 8);
+        EXPECT_EQ(end[a], 17);
+    }
+
+    // fully transparent
+    std::vector<float> transparent(256, 0.0f);
+    EXPECT_EQ(grid.VisibleExtent(transparent, 0.0, 1.0, start, end), 0);
+
+    //
+    // subsample can crop a mesh to such an extent
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("uniform",17,17,17,data);
+
+    Node opts, res;
+    opts["stride"] = 1;
+    opts["fields"] = "braid";
+    opts["extent/start"].set(start, 3);
+    opts["extent/end"].set(end, 3);
+    subsample_mesh(data, opts, res);
+
+    Node verify_info;
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(res,verify_info));
+    EXPECT_FALSE(res["fields"].has_child("radial"));
+    EXPECT_EQ(res["coordsets/coords/dims/i"].to_int64(), 9);
+    EXPECT_NEAR(res["coordsets/coords/origin/x"].to_float64(),
+                data["coordsets/coords/origin/x"].to_float64() + 
+                8 * data["coordsets/coords/spacing/dx"].to_float64(),
+                1e-12);
+
+    const float64 *braid = data["fields/braid/values"].as_float64_ptr();
+    const float64 *sub_braid = res["fields/braid/values"].as_float64_ptr();
+    EXPECT_EQ(sub_braid[(1 * 9 + 2) * 9 + 3], braid[(9 * 17 + 10) * 17 + 11]);
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_empty_pipeline, test_raster_2d)
+{
+    //
+    // two domains that share the edge x = 2, with an element field 
+    // that is 0 on the left domain and 1 on the right one
+    //
+    Node domains[2];
+    for(int d = 0; d < 2; d++)
+    {
+        Node &mesh = domains[d];
+        float64 x[3] = {2.0 * d, 2.0 * d + 1.0, 2.0 * d + 2.0};
+        float64 y[3] = {0.0, 0.5, 2.0};
+        mesh["coordsets/coords/type"] = "rectilinear";
+        mesh["coordsets/coords/values/x"].set(x, 3);
+        mesh["coordsets/coords/values/y"].set(y, 3);
+        mesh["topologies/mesh/type"] = "rectilinear";
+        mesh["topologies/mesh/coordset"] = "coords";
+        mesh["fields/f/association"] = "element";
+        mesh["fields/f/topology"] = "mesh";
+        mesh["fields/f/values"].set(DataType::float64(4));
+        float64 *vals = mesh["fields/f/values"].as_float64_ptr();
+        for(int i = 0; i < 4; i++)
+        {
+            vals[i] = d;
+        }
+    }
+
+    // black for 0, white for 1
+    std::vector<unsigned char> lut(8, 0);
+    for(int c = 4; c < 8; c++)
+    {
+        lut[c] = 255;
+    }
+    lut[3] = 255;
+
+    // one pixel of margin around the bounds [0,4] x [0,2]
+    const int width = 20;
+    const int height = 12;
+    float64 origin[2] = {-0.5, -0.5};
+    std::vector<unsigned char> images[2];
+    for(int d = 0; d < 2; d++)
+    {
+        Raster2D raster;
+        EXPECT_TRUE(raster.SetField(domains[d], "f"));
+
+        float64 bounds[4];
+        raster.Bounds(bounds);
+        EXPECT_EQ(bounds[0], 2.0 * d);
+        EXPECT_EQ(bounds[3], 2.0);
+
+        images[d].resize(4 * width * height, 0);
+        raster.Rasterize(origin, 0.25, width, height, lut, 0.0, 1.0, &images[d][0]);
+    }
+
+    //
+    // every pixel inside the bounds is drawn by exactly one domain
+    //
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int p = 4 * (y * width + x);
+            bool inside = x >= 2 && x < 18 && y >= 2 && y < 10;
+            int covered = (images[0][p + 3] != 0 ? 1 : 0) +
+                          (images[1][p + 3] != 0 ? 1 : 0);
+            EXPECT_EQ(covered, inside ? 1 : 0);
+            if(inside)
+            {
+                int d = x < 10 ? 0 : 1;
+                EXPECT_EQ(images[d][p], d == 0 ? 0 : 255);
+            }
+        }
+    }
+
+    // 3D meshes are not supported
+    Node data;
+    conduit::blueprint::mesh::examples::braid("uniform",5,5,5,data);
+    Raster2D raster;
+    EXPECT_FALSE(raster.SetField(data, "braid"));
+}
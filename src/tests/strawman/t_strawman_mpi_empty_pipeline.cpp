@@ -114,6 +114,58 @@ TEST(strawman_test_3d, test_3d_parallel_render_default_pipeline)
     sman.Close();
 }
 
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d, test_parallel_statistics)
+{
+    int par_rank;
+    int par_size;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(comm, &par_rank);
+    MPI_Comm_size(comm, &par_size);
+
+    Node data;
+    create_2d_example_dataset(data,par_rank,par_size);
+
+    // each rank holds a block of a global ramp
+    const index_t num_vals = data["fields/radial/values"].dtype().number_of_elements();
+    data["fields/ramp/type"] = "scalar";
+    data["fields/ramp/association"] = "element";
+    data["fields/ramp/topology"] = "mesh";
+    data["fields/ramp/values"].set(DataType::float64(num_vals));
+    float64 *ramp = data["fields/ramp/values"].as_float64_ptr();
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        ramp[i] = (float64) (par_rank * num_vals + i);
+    }
+
+    Node actions;
+    Node &stats_action = actions.append();
+    stats_action["action"] = "statistics";
+    stats_action["fields"] = "ramp";
+
+    Node open_opts;
+    open_opts["mpi_comm"] = MPI_Comm_c2f(comm);
+    open_opts["pipeline/type"] = "empty";
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+    sman.Close();
+
+    // every rank gets the global result
+    float64 n = (float64) (num_vals * par_size);
+    const Node &res = info["statistics/ramp"];
+    EXPECT_EQ(res["count"].to_int64(), num_vals * par_size);
+    EXPECT_NEAR(res["min"].to_float64(), 0.0, 1e-12);
+    EXPECT_NEAR(res["max"].to_float64(), n - 1.0, 1e-12);
+    EXPECT_NEAR(res["mean"].to_float64(), (n - 1.0) / 2.0, 1e-9);
+    EXPECT_NEAR(res["variance"].to_float64(), (n * n - 1.0) / 12.0, 1e-6);
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
@@ -54,6 +54,9 @@
 #include <iostream>
 #include <math.h>
 
+#include <conduit_relay.hpp>
+#include <strawman_blueprint_reader.hpp>
+
 
 #include <mpi.h>
 
@@ -127,6 +130,356 @@ TEST(strawman_test_3d, test_3d_parallel_render_default_pipeline)
     
 }
 
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d, test_3d_parallel_save_aggregated)
+{
+    //
+    // Set Up MPI
+    //
+    int par_rank;
+    int par_size;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(comm, &par_rank);
+    MPI_Comm_size(comm, &par_size);
+
+    //
+    // Create the data.
+    //
+    Node data;
+    create_3d_example_dataset(data, par_rank, par_size);
+
+    // make sure the _output dir exists
+    string output_path = "";
+    if(par_rank == 0)
+    {
+        output_path = prepare_output_dir();
+    }
+    else
+    {
+        output_path = output_dir();
+    }
+    
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_mpi_save_hdf5_agg");
+
+    // write all domains into a single file
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["aggregation/num_files"] = 1;
+    
+    //
+    // Run Strawman
+    //
+    Strawman sman;
+    Node opts;
+    opts["mpi_comm"] = MPI_Comm_c2f(comm);
+    opts["pipeline/type"] = "blueprint_hdf5";
+    sman.Open(opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+    
+    MPI_Barrier(comm);
+    
+    if(par_rank == 0)
+    {
+        char fmt_buff[64];
+        uint64 cycle = data["state/cycle"].to_value();
+        snprintf(fmt_buff, sizeof(fmt_buff), "%06lu",cycle);
+        
+        string root_file = output_path + ".cycle_" + fmt_buff + ".root";
+        EXPECT_TRUE(conduit::utils::is_file(root_file));
+        
+        Node root;
+        conduit::relay::io::load(root_file,"hdf5",root);
+        EXPECT_EQ(root["number_of_files"].to_int(), 1);
+        EXPECT_EQ(root["number_of_trees"].to_int(), par_size);
+        EXPECT_EQ(root["tree_pattern"].as_string(), "domain_%06d");
+        
+        string agg_file = conduit::utils::join_file_path(
+                                output_path + ".cycle_" + fmt_buff,
+                                "file_000000.hdf5");
+        EXPECT_TRUE(conduit::utils::is_file(agg_file));
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d, test_3d_parallel_save_aggregated_domain_order)
+{
+    //
+    // Set Up MPI
+    //
+    int par_rank;
+    int par_size;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(comm, &par_rank);
+    MPI_Comm_size(comm, &par_size);
+
+    //
+    // Create the data, with domain ids in reverse rank order
+    //
+    Node data;
+    create_3d_example_dataset(data, par_rank, par_size);
+    data["state/domain_id"] = (uint64)(par_size - 1 - par_rank);
+
+    string output_path = "";
+    if(par_rank == 0)
+    {
+        output_path = prepare_output_dir();
+    }
+    else
+    {
+        output_path = output_dir();
+    }
+
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_mpi_save_hdf5_agg_order");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["aggregation/ranks_per_file"] = 2;
+
+    Strawman sman;
+    Node opts;
+    opts["mpi_comm"] = MPI_Comm_c2f(comm);
+    opts["pipeline/type"] = "blueprint_hdf5";
+    sman.Open(opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    MPI_Barrier(comm);
+
+    if(par_rank == 0)
+    {
+        char fmt_buff[64];
+        uint64 cycle = data["state/cycle"].to_value();
+        snprintf(fmt_buff, sizeof(fmt_buff), "%06lu",cycle);
+        string root_file = output_path + ".cycle_" + fmt_buff + ".root";
+
+        // tree i was written by rank par_size - 1 - i, a single rank
+        // does not aggregate
+        if(par_size > 1)
+        {
+            Node root;
+            conduit::relay::io::load(root_file,"hdf5",root);
+            Node n_tree_files;
+            root["tree_files"].to_int32_array(n_tree_files);
+            int32_array tree_files = n_tree_files.value();
+            EXPECT_EQ(tree_files.number_of_elements(), par_size);
+            for(int i = 0; i < par_size; i++)
+            {
+                EXPECT_EQ(tree_files[i], (par_size - 1 - i) / 2);
+            }
+        }
+
+        // the reader finds every domain in the right file
+        Node reader_opts;
+        reader_opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_SELF);
+
+        BlueprintReader reader;
+        reader.SetOptions(reader_opts);
+        reader.Open(root_file);
+
+        for(int i = 0; i < par_size; i++)
+        {
+            Node domain;
+            reader.ReadDomain(i,domain);
+            EXPECT_EQ(domain["state/domain_id"].to_int(), i);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d, test_3d_parallel_read_m_to_n)
+{
+    //
+    // Set Up MPI
+    //
+    int par_rank;
+    int par_size;
+    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(comm, &par_rank);
+    MPI_Comm_size(comm, &par_size);
+
+    Node data;
+    create_3d_example_dataset(data, par_rank, par_size);
+
+    string output_path = "";
+    if(par_rank == 0)
+    {
+        output_path = prepare_output_dir();
+    }
+    else
+    {
+        output_path = output_dir();
+    }
+
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_mpi_read_m_to_n");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["aggregation/num_files"] = 1;
+
+    Strawman sman;
+    Node opts;
+    opts["mpi_comm"] = MPI_Comm_c2f(comm);
+    opts["pipeline/type"] = "blueprint_hdf5";
+    sman.Open(opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    MPI_Barrier(comm);
+
+    char fmt_buff[64];
+    uint64 cycle = data["state/cycle"].to_value();
+    snprintf(fmt_buff, sizeof(fmt_buff), "%06lu",cycle);
+    string root_file = output_path + ".cycle_" + fmt_buff + ".root";
+
+    //
+    // N = 1: each rank reads all the domains on its own
+    //
+    Node reader_opts;
+    reader_opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_SELF);
+
+    BlueprintReader serial_reader;
+    serial_reader.SetOptions(reader_opts);
+    serial_reader.Open(root_file);
+
+    EXPECT_EQ(serial_reader.NumDomains(), par_size);
+    EXPECT_EQ(serial_reader.NumRounds(), par_size);
+    EXPECT_EQ((int)serial_reader.LocalDomains().size(), par_size);
+
+    Node domains;
+    serial_reader.ReadLocalDomains(domains);
+    EXPECT_EQ(domains.number_of_children(), par_size);
+    for(int i = 0; i < par_size; i++)
+    {
+        EXPECT_EQ(domains[i]["state/domain_id"].to_int(), i);
+    }
+
+    // each round reads a different domain with its own id
+    Node round_data;
+    serial_reader.ReadRound(par_size - 1,round_data);
+    EXPECT_EQ(round_data["state/domain_id"].to_int(), par_size - 1);
+    EXPECT_THROW(serial_reader.ReadRound(par_size,round_data),
+                 conduit::Error);
+
+    //
+    // M > N: a single rank replays one domain per round, each round
+    // writes its own file set
+    //
+    Node self_opts;
+    self_opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_SELF);
+    self_opts["pipeline/type"] = "blueprint_hdf5";
+
+    if(par_rank == 0)
+    {
+        string rounds_path = output_path + "_rounds";
+        actions[0]["output_path"] = rounds_path;
+        serial_reader.Replay(self_opts,actions);
+
+        if(par_size > 1)
+        {
+            for(int i = 0; i < par_size; i++)
+            {
+                char round_buff[64];
+                snprintf(round_buff, sizeof(round_buff), "_round_%06d", i);
+                EXPECT_TRUE(conduit::utils::is_file(rounds_path + round_buff +
+                                                    ".cycle_" + fmt_buff +
+                                                    ".root"));
+            }
+        }
+        else
+        {
+            // a single round keeps its output names
+            EXPECT_TRUE(conduit::utils::is_file(rounds_path + ".cycle_" +
+                                                fmt_buff + ".root"));
+        }
+    }
+
+    MPI_Barrier(comm);
+
+    //
+    // N = M: replay the data set through the pipeline
+    //
+    reader_opts["mpi_comm"] = MPI_Comm_c2f(comm);
+
+    BlueprintReader reader;
+    reader.SetOptions(reader_opts);
+    reader.Open(root_file);
+    EXPECT_EQ(reader.NumRounds(), 1);
+    EXPECT_EQ((int)reader.LocalDomains().size(), 1);
+    EXPECT_EQ(reader.LocalDomains()[0], par_rank);
+
+    string replay_path = output_path + "_replay";
+    actions[0]["output_path"] = replay_path;
+
+    reader.Replay(opts,actions);
+
+    MPI_Barrier(comm);
+
+    if(par_rank == 0)
+    {
+        EXPECT_TRUE(conduit::utils::is_file(replay_path + ".cycle_" +
+                                            fmt_buff + ".root"));
+    }
+
+    //
+    // M < N: rank 0 writes a single domain, which all ranks replay
+    //
+    string single_path = output_path + "_single";
+    actions[0]["output_path"] = single_path;
+
+    if(par_rank == 0)
+    {
+        Node single_data;
+        single_data.set(data);
+        single_data["state/domain_id"] = (uint64) 0;
+
+        Strawman sman_single;
+        sman_single.Open(self_opts);
+        sman_single.Publish(single_data);
+        sman_single.Execute(actions);
+        sman_single.Close();
+    }
+
+    MPI_Barrier(comm);
+
+    BlueprintReader single_reader;
+    single_reader.SetOptions(reader_opts);
+    single_reader.Open(single_path + ".cycle_" + fmt_buff + ".root");
+    EXPECT_EQ(single_reader.NumDomains(), 1);
+    EXPECT_EQ(single_reader.NumRounds(), 1);
+    // the last rank owns the only domain
+    EXPECT_EQ((int)single_reader.LocalDomains().size(),
+              par_rank == par_size - 1 ? 1 : 0);
+
+    string single_replay_path = single_path + "_replay";
+    actions[0]["output_path"] = single_replay_path;
+    single_reader.Replay(opts,actions);
+
+    MPI_Barrier(comm);
+
+    if(par_rank == 0)
+    {
+        string single_root = single_replay_path + ".cycle_" + fmt_buff + ".root";
+        EXPECT_TRUE(conduit::utils::is_file(single_root));
+
+        Node root;
+        conduit::relay::io::load(single_root,"hdf5",root);
+        EXPECT_EQ(root["number_of_trees"].to_int(), 1);
+    }
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
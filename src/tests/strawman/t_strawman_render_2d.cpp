@@ -264,6 +264,97 @@ TEST(strawman_render_2d, test_render_2d_render_vtkm_serial_backend)
     EXPECT_TRUE(check_test_image(output_file));
 }
 
+//-----------------------------------------------------------------------------
+TEST(strawman_render_2d, test_render_2d_render_vtkm_raster_2d)
+{
+    
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with vtkm support
+    if(n["pipelines/vtkm/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("VTKm support disabled, skipping 2D VTKm raster "
+                      "test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 2D VTKm direct rasterization");
+    
+    //
+    // Create an example uniform mesh, which is drawn without the
+    // ray tracer
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("uniform",
+                                               EXAMPLE_MESH_SIDE_DIM,
+                                               EXAMPLE_MESH_SIDE_DIM,
+                                               0,
+                                               data);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+    
+    string output_path = prepare_output_dir();
+    string output_file = conduit::utils::join_file_path(output_path, "tout_render_2d_vtkm_raster_2d");
+    string output_file_rt = conduit::utils::join_file_path(output_path, "tout_render_2d_vtkm_raster_2d_ray_traced");
+    // remove old images before rendering
+    remove_test_image(output_file);
+    remove_test_image(output_file_rt);
+
+    //
+    // Create the actions, a non square image and the same plot 
+    // from the ray tracer for comparison
+    //
+
+    Node actions;
+    
+    Node &plot = actions.append();
+    plot["action"]     = "add_plot";
+    plot["field_name"] = "braid";
+    
+    Node &opts = plot["render_options"];
+    opts["width"]  = 600;
+    opts["height"] = 400;
+    opts["file_name"] = output_file;
+    
+    actions.append()["action"] = "draw_plots";
+
+    Node &plot_rt = actions.append();
+    plot_rt["action"]     = "add_plot";
+    plot_rt["field_name"] = "braid";
+    
+    Node &opts_rt = plot_rt["render_options"];
+    opts_rt["width"]  = 600;
+    opts_rt["height"] = 400;
+    opts_rt["raster_2d"] = "false";
+    opts_rt["file_name"] = output_file_rt;
+    
+    actions.append()["action"] = "draw_plots";
+    
+    //
+    // Run Strawman
+    //
+    
+    Node open_opts;
+    open_opts["pipeline/type"] = "vtkm";
+    open_opts["pipeline/backend"] = "serial";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    // check that we created the images
+    EXPECT_TRUE(check_test_image(output_file));
+    EXPECT_TRUE(check_test_image(output_file_rt));
+
+    //
+    // The images differ by the color quantization and along the mesh
+    // edges, where the two sample pixels differently
+    //
+    EXPECT_LT(diff_test_images(output_file, output_file_rt, 16), 0.05);
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
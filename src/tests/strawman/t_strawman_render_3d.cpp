@@ -54,6 +54,8 @@
 #include <strawman.hpp>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <math.h>
 
 #include <conduit_blueprint.hpp>
@@ -201,6 +203,150 @@ TEST(strawman_render_3d, test_render_3d_render_eavl_serial_backend)
 }
 
 
+//-----------------------------------------------------------------------------
+TEST(strawman_render_3d, test_render_3d_render_eavl_filter_dag)
+{
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with eavl support
+    if(n["pipelines/eavl/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("EAVL support disabled, skipping 3D EAVL filter dag test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 3D Rendering with a shared EAVL filter");
+
+    //
+    // Create an example mesh.
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("hexs",
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              data);
+
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+
+    string output_path = prepare_output_dir();
+    string output_file_a = conduit::utils::join_file_path(output_path, "tout_render_3d_eavl_dag_a");
+    string output_file_b = conduit::utils::join_file_path(output_path, "tout_render_3d_eavl_dag_b");
+    string output_file_c = conduit::utils::join_file_path(output_path, "tout_render_3d_eavl_dag_c");
+    string save_path     = conduit::utils::join_file_path(output_path, "tout_render_3d_eavl_dag_save");
+    string save_file     = save_path + "_000000.vtk";
+
+    // remove old images before rendering
+    remove_test_image(output_file_a);
+    remove_test_image(output_file_b);
+    remove_test_image(output_file_c);
+    if(conduit::utils::is_file(save_file))
+    {
+        conduit::utils::remove_file(save_file);
+    }
+
+    //
+    // Create the actions. Three plots consume the same threshold, the
+    // second and third threshold it again with different ranges and the
+    // third is also saved. The iso branch is unused.
+    //
+
+    Node actions;
+
+    Node &thresh = actions.append();
+    thresh["action"]     = "add_filter";
+    thresh["type"]       = "threshold_filter";
+    thresh["name"]       = "thresh";
+    thresh["field_name"] = "braid";
+    thresh["min_value"]  = -5.0;
+    thresh["max_value"]  = 5.0;
+
+    Node &thresh_2 = actions.append();
+    thresh_2["action"]    = "add_filter";
+    thresh_2["type"]      = "threshold_filter";
+    thresh_2["name"]      = "thresh_2";
+    thresh_2["input"]     = "thresh";
+    thresh_2["min_value"] = 0.0;
+    thresh_2["max_value"] = 5.0;
+
+    Node &thresh_3 = actions.append();
+    thresh_3["action"]    = "add_filter";
+    thresh_3["type"]      = "threshold_filter";
+    thresh_3["name"]      = "thresh_3";
+    thresh_3["input"]     = "thresh";
+    thresh_3["min_value"] = -5.0;
+    thresh_3["max_value"] = 0.0;
+
+    Node &unused = actions.append();
+    unused["action"]    = "add_filter";
+    unused["type"]      = "isosurface_filter";
+    unused["name"]      = "unused";
+    unused["input"]     = "thresh";
+    unused["iso_value"] = 0.0;
+
+    Node &plot_a = actions.append();
+    plot_a["action"] = "add_plot";
+    plot_a["input"]  = "thresh";
+    plot_a["render_options/width"]  = 500;
+    plot_a["render_options/height"] = 500;
+    plot_a["render_options/file_name"] = output_file_a;
+
+    Node &plot_b = actions.append();
+    plot_b["action"] = "add_plot";
+    plot_b["input"]  = "thresh_2";
+    plot_b["render_options/width"]  = 500;
+    plot_b["render_options/height"] = 500;
+    plot_b["render_options/file_name"] = output_file_b;
+
+    Node &plot_c = actions.append();
+    plot_c["action"] = "add_plot";
+    plot_c["input"]  = "thresh_3";
+    plot_c["render_options/width"]  = 500;
+    plot_c["render_options/height"] = 500;
+    plot_c["render_options/file_name"] = output_file_c;
+
+    Node &save = actions.append();
+    save["action"]      = "save";
+    save["input"]       = "thresh_3";
+    save["output_path"] = save_path;
+
+    actions.append()["action"] = "draw_plots";
+    
+    //
+    // Run Strawman
+    //
+    
+    Node open_opts;
+    open_opts["pipeline/type"] = "eavl";
+    open_opts["pipeline/backend"] = "serial";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+    sman.Close();
+
+    // check that we created the images and the extract
+    EXPECT_TRUE(check_test_image(output_file_a));
+    EXPECT_TRUE(check_test_image(output_file_b));
+    EXPECT_TRUE(check_test_image(output_file_c));
+    EXPECT_TRUE(conduit::utils::is_file(save_file));
+
+    // the mesh was converted once, each used node evaluated once and
+    // the unused node was never evaluated
+    ASSERT_TRUE(info.has_path("pipeline/filters"));
+    EXPECT_EQ(info["pipeline/sources/braid/conversions"].to_int(), 1);
+    EXPECT_EQ(info["pipeline/filters/thresh/evaluations"].to_int(), 1);
+    EXPECT_EQ(info["pipeline/filters/thresh_2/evaluations"].to_int(), 1);
+    EXPECT_EQ(info["pipeline/filters/thresh_3/evaluations"].to_int(), 1);
+    EXPECT_FALSE(info.has_path("pipeline/filters/unused"));
+    EXPECT_EQ(info["pipeline/filters"].number_of_children(), 3);
+}
+
+
 //-----------------------------------------------------------------------------
 TEST(strawman_render_3d, test_render_3d_render_eavl_cuda_backend)
 {
@@ -351,6 +497,443 @@ TEST(strawman_render_3d, test_render_3d_render_vtkm_serial_backend)
 
 
 
+//-----------------------------------------------------------------------------
+TEST(strawman_render_3d, test_render_3d_render_vtkm_serial_backend_filters)
+{
+    
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with vtkm support
+    if(n["pipelines/vtkm/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("VTKm support disabled, skipping 3D VTKm-serial filter test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 3D Rendering with VTKm Pipeline filters");
+    
+    //
+    // Create an example mesh.
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("hexs",
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              data);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+
+    string output_path = prepare_output_dir();
+    string full_file  = conduit::utils::join_file_path(output_path, "tout_render_3d_vtkm_full");
+    string iso_file   = conduit::utils::join_file_path(output_path, "tout_render_3d_vtkm_iso");
+    string slice_file = conduit::utils::join_file_path(output_path, "tout_render_3d_vtkm_slice");
+    string clip_file  = conduit::utils::join_file_path(output_path, "tout_render_3d_vtkm_clip");
+
+    // remove old images before rendering
+    remove_test_image(full_file);
+    remove_test_image(iso_file);
+    remove_test_image(slice_file);
+    remove_test_image(clip_file);
+
+    //
+    // Create the actions. The first plot is left unfiltered, the filters
+    // select the other plots with "plot".
+    //
+
+    Node actions;
+    
+    Node &full_plot = actions.append();
+    full_plot["action"]     = "add_plot";
+    full_plot["field_name"] = "braid";
+    full_plot["render_options/width"]  = 500;
+    full_plot["render_options/height"] = 500;
+    full_plot["render_options/file_name"] = full_file;
+
+    Node &iso_plot = actions.append();
+    iso_plot["action"]     = "add_plot";
+    iso_plot["field_name"] = "braid";
+    iso_plot["render_options/width"]  = 500;
+    iso_plot["render_options/height"] = 500;
+    iso_plot["render_options/file_name"] = iso_file;
+
+    Node &slice_plot = actions.append();
+    slice_plot["action"]     = "add_plot";
+    slice_plot["field_name"] = "braid";
+    slice_plot["render_options/width"]  = 500;
+    slice_plot["render_options/height"] = 500;
+    slice_plot["render_options/file_name"] = slice_file;
+
+    Node &clip_plot = actions.append();
+    clip_plot["action"]     = "add_plot";
+    clip_plot["field_name"] = "braid";
+    clip_plot["render_options/width"]  = 500;
+    clip_plot["render_options/height"] = 500;
+    clip_plot["render_options/file_name"] = clip_file;
+
+    Node &iso = actions.append();
+    iso["action"]    = "add_filter";
+    iso["type"]      = "isosurface_filter";
+    iso["iso_value"] = 0.0;
+    iso["plot"]      = 1;
+
+    float64 origin[3] = {0.0, 0.0, 0.0};
+    float64 normal[3] = {0.0, 0.0, 1.0};
+
+    Node &slice = actions.append();
+    slice["action"] = "add_filter";
+    slice["type"]   = "slice_filter";
+    slice["origin"].set(origin, 3);
+    slice["normal"].set(normal, 3);
+    slice["plot"]   = 2;
+
+    Node &clip = actions.append();
+    clip["action"] = "add_filter";
+    clip["type"]   = "clip_filter";
+    clip["origin"].set(origin, 3);
+    clip["normal"].set(normal, 3);
+    clip["plot"]   = 3;
+
+    actions.append()["action"] = "draw_plots";
+
+    //
+    // Run Strawman
+    //
+    
+    Node open_opts;
+    open_opts["pipeline/type"] = "vtkm";
+    open_opts["pipeline/backend"] = "serial";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+
+    Node info;
+    sman.Info(info);
+
+    // a filter on a plot that does not exist is an error
+    Node bad_actions;
+    Node &bad_filter = bad_actions.append();
+    bad_filter["action"] = "add_filter";
+    bad_filter["type"]   = "external_faces_filter";
+    bad_filter["plot"]   = 4;
+    EXPECT_THROW(sman.Execute(bad_actions), conduit::Error);
+
+    sman.Close();
+
+    // check that we created the images
+    EXPECT_TRUE(check_test_image(full_file));
+    EXPECT_TRUE(check_test_image(iso_file));
+    EXPECT_TRUE(check_test_image(slice_file));
+    EXPECT_TRUE(check_test_image(clip_file));
+
+    //
+    // check the geometry each plot rendered
+    //
+    ASSERT_TRUE(info.has_path("pipeline/renders"));
+    const Node &renders = info["pipeline/renders"];
+    ASSERT_EQ(renders.number_of_children(), 4);
+
+    uint64 cells[4] = {0, 0, 0, 0};
+    for(int i = 0; i < 4; i++)
+    {
+        int plot_id = renders.child(i)["plot"].to_int();
+        ASSERT_TRUE(plot_id >= 0 && plot_id < 4);
+        cells[plot_id] = renders.child(i)["cells"].to_uint64();
+    }
+
+    // the first plot is the whole mesh
+    uint64 num_hexs = (uint64)(EXAMPLE_MESH_SIDE_DIM - 1) *
+                      (EXAMPLE_MESH_SIDE_DIM - 1) *
+                      (EXAMPLE_MESH_SIDE_DIM - 1);
+    EXPECT_EQ(cells[0], num_hexs);
+
+    // the isosurface and the slice are triangles through the mesh,
+    // the clip keeps part of the mesh as new cells
+    EXPECT_GT(cells[1], (uint64)0);
+    EXPECT_NE(cells[1], num_hexs);
+    EXPECT_GT(cells[2], (uint64)0);
+    EXPECT_LT(cells[2], num_hexs);
+    EXPECT_GT(cells[3], (uint64)0);
+    EXPECT_NE(cells[3], num_hexs);
+}
+
+//-----------------------------------------------------------------------------
+std::string
+read_test_image(const std::string &path)
+{
+    std::ifstream ifs((path + ".png").c_str(), std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_render_3d, test_render_3d_render_vtkm_change_detection)
+{
+    
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with vtkm support
+    if(n["pipelines/vtkm/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("VTKm support disabled, skipping 3D VTKm change detection test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 3D Rendering with VTKm Pipeline change detection");
+    
+    //
+    // Create an example mesh.
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("hexs",
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              data);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+
+    string output_path = prepare_output_dir();
+    string output_file[3];
+    for(int i = 0; i < 3; i++)
+    {
+        std::ostringstream oss;
+        oss << "tout_render_3d_vtkm_change_detection_" << i;
+        output_file[i] = conduit::utils::join_file_path(output_path, oss.str());
+        // remove old images before rendering
+        remove_test_image(output_file[i]);
+    }
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "vtkm";
+    open_opts["pipeline/backend"] = "serial";
+    open_opts["change_detection/enabled"] = "true";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+
+    //
+    // The second frame republishes the same data and reuses the first
+    // image, the third changes the field and is rendered again.
+    //
+    for(int i = 0; i < 3; i++)
+    {
+        if(i == 2)
+        {
+            float64_array vals = data["fields/braid/values"].value();
+            for(index_t j = 0; j < vals.number_of_elements(); j++)
+            {
+                vals[j] = -vals[j];
+            }
+        }
+
+        Node actions;
+        Node &plot = actions.append();
+        plot["action"]     = "add_plot";
+        plot["field_name"] = "braid";
+        plot["render_options/width"]  = 500;
+        plot["render_options/height"] = 500;
+        plot["render_options/file_name"] = output_file[i];
+        actions.append()["action"] = "draw_plots";
+
+        sman.Publish(data);
+        sman.Execute(actions);
+    }
+
+    sman.Close();
+
+    // check that we created the images
+    for(int i = 0; i < 3; i++)
+    {
+        EXPECT_TRUE(check_test_image(output_file[i]));
+    }
+
+    EXPECT_EQ(read_test_image(output_file[0]), read_test_image(output_file[1]));
+    EXPECT_NE(read_test_image(output_file[1]), read_test_image(output_file[2]));
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_render_3d, test_render_3d_render_vtkm_save_every)
+{
+    
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with vtkm support
+    if(n["pipelines/vtkm/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("VTKm support disabled, skipping 3D VTKm save_every test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 3D Rendering with VTKm Pipeline save_every and web previews");
+    
+    //
+    // Create an example mesh.
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("hexs",
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              data);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+
+    string output_path = prepare_output_dir();
+    string output_file[4];
+    for(int i = 0; i < 4; i++)
+    {
+        std::ostringstream oss;
+        oss << "tout_render_3d_vtkm_save_every_" << i;
+        output_file[i] = conduit::utils::join_file_path(output_path, oss.str());
+        // remove old images before rendering
+        remove_test_image(output_file[i]);
+    }
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "vtkm";
+    open_opts["pipeline/backend"] = "serial";
+    open_opts["web/stream"] = "true";
+    open_opts["web/preview_scale"] = 0.25;
+    open_opts["change_detection/enabled"] = "true";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+
+    //
+    // Even cycles save a full size image, odd cycles only stream
+    // a quarter size preview. The data does not change, so the last two
+    // cycles reuse the frames of the first two and must keep their size.
+    //
+    for(int i = 0; i < 4; i++)
+    {
+        data["state/cycle"] = (uint64) i;
+
+        Node actions;
+        Node &plot = actions.append();
+        plot["action"]     = "add_plot";
+        plot["field_name"] = "braid";
+        plot["render_options/width"]  = 400;
+        plot["render_options/height"] = 400;
+        plot["render_options/file_name"] = output_file[i];
+        plot["render_options/save_every"] = 2;
+        actions.append()["action"] = "draw_plots";
+
+        sman.Publish(data);
+        sman.Execute(actions);
+
+        Node info;
+        sman.Info(info);
+        ASSERT_TRUE(info.has_path("pipeline/renders"));
+        const Node &frame = info["pipeline/renders"].child(0);
+        if(i % 2 == 0)
+        {
+            EXPECT_EQ(frame["width"].to_int(), 400);
+            EXPECT_EQ(frame["height"].to_int(), 400);
+            EXPECT_TRUE(frame.has_child("file_name"));
+        }
+        else
+        {
+            EXPECT_EQ(frame["width"].to_int(), 100);
+            EXPECT_EQ(frame["height"].to_int(), 100);
+            EXPECT_FALSE(frame.has_child("file_name"));
+        }
+        EXPECT_EQ(frame["reused"].to_int(), i < 2 ? 0 : 1);
+    }
+
+    sman.Close();
+
+    // only the even cycles saved images
+    for(int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(check_test_image(output_file[i]), i % 2 == 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_render_3d, test_render_3d_render_vtkm_budget)
+{
+    
+    Node n;
+    strawman::about(n);
+    // only run this test if strawman was built with vtkm support
+    if(n["pipelines/vtkm/status"].as_string() == "disabled")
+    {
+        STRAWMAN_INFO("VTKm support disabled, skipping 3D VTKm render budget test");
+        return;
+    }
+    
+    STRAWMAN_INFO("Testing 3D Volume Rendering with a VTKm Pipeline render budget");
+    
+    //
+    // Create an example mesh.
+    //
+    Node data, verify_info;
+    conduit::blueprint::mesh::examples::braid("hexs",
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              EXAMPLE_MESH_SIDE_DIM,
+                                              data);
+    
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(data,verify_info));
+
+    string output_path = prepare_output_dir();
+    string output_file = conduit::utils::join_file_path(output_path, "tout_render_3d_vtkm_budget");
+
+    // remove old images before rendering
+    remove_test_image(output_file);
+
+    //
+    // A budget no frame can meet, the first frame is rendered at full
+    // quality and the following ones at reduced quality
+    //
+    Node actions;
+    Node &plot = actions.append();
+    plot["action"]     = "add_plot";
+    plot["field_name"] = "braid";
+    plot["render_options/renderer"] = "volume";
+    plot["render_options/width"]  = 500;
+    plot["render_options/height"] = 500;
+    plot["render_options/file_name"] = output_file;
+
+    Node &draw = actions.append();
+    draw["action"]    = "draw_plots";
+    draw["budget_ms"] = 0.001;
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "vtkm";
+    open_opts["pipeline/backend"] = "serial";
+    
+    Strawman sman;
+    sman.Open(open_opts);
+    for(int i = 0; i < 3; i++)
+    {
+        sman.Publish(data);
+        sman.Execute(actions);
+
+        // the painted cost of the previous frames lowers the quality
+        Node info;
+        sman.Info(info);
+        ASSERT_TRUE(info.has_path("pipeline/renders"));
+        int quality_level = info["pipeline/renders"].child(0)["quality_level"].to_int();
+        if(i == 0)
+        {
+            EXPECT_EQ(quality_level, 0);
+        }
+        else
+        {
+            EXPECT_GT(quality_level, 0);
+        }
+    }
+    sman.Close();
+
+    // check that we created an image
+    EXPECT_TRUE(check_test_image(output_file));
+}
+
 //-----------------------------------------------------------------------------
 TEST(strawman_render_3d, test_render_3d_render_vtkm_tbb_backend)
 {
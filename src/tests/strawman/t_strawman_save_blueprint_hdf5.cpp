@@ -54,9 +54,14 @@
 
 #include <iostream>
 #include <math.h>
+#include <algorithm>
 #include <sstream>
 
 #include <conduit_blueprint.hpp>
+#include <conduit_relay.hpp>
+
+#include <strawman_compression.hpp>
+#include <strawman_blueprint_reader.hpp>
 
 #include "t_config.hpp"
 #include "t_strawman_test_utils.hpp"
@@ -106,3 +111,454 @@ TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_pipeline)
 
 }
 
+//-----------------------------------------------------------------------------
+TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_pipeline_async)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",100,100,0,data);
+    data["state/domain_id"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_async");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+    open_opts["hdf5/async"] = "true";
+    open_opts["hdf5/max_outstanding"] = 2;
+    
+    //
+    // Run Strawman, saving more cycles than there are staging buffers
+    //
+    Strawman sman;
+    sman.Open(open_opts);
+    
+    for(int cycle = 0; cycle < 3; cycle++)
+    {
+        data["state/cycle"] = (uint64) cycle;
+        sman.Publish(data);
+        sman.Execute(actions);
+    }
+    
+    // close waits for the writes to finish
+    sman.Close();
+
+    for(int cycle = 0; cycle < 3; cycle++)
+    {
+        ostringstream oss;
+        oss << output_path << ".cycle_00000" << cycle;
+        string domain_file = conduit::utils::join_file_path(oss.str(),
+                                                            "domain_000000.hdf5");
+        EXPECT_TRUE(conduit::utils::is_file(domain_file));
+
+        // the cached index is patched with each cycle's file pattern
+        Node n_root;
+        conduit::relay::io::load(oss.str() + ".root","hdf5",n_root);
+        EXPECT_TRUE(n_root.has_path("blueprint_index/mesh"));
+        ostringstream cycle_dir;
+        cycle_dir << "test_save_hdf5_async.cycle_00000" << cycle;
+        EXPECT_NE(n_root["file_pattern"].as_string().find(cycle_dir.str()),
+                  string::npos);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_pipeline_static_mesh)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",100,100,0,data);
+    data["state/domain_id"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_static_mesh");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["static_mesh"] = "true";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+
+    //
+    // Run Strawman for two cycles, the mesh does not change
+    //
+    Strawman sman;
+    sman.Open(open_opts);
+    
+    for(int cycle = 0; cycle < 2; cycle++)
+    {
+        data["state/cycle"] = (uint64) cycle;
+        sman.Publish(data);
+        sman.Execute(actions);
+    }
+    
+    sman.Close();
+
+    // the mesh is only written for the first cycle
+    EXPECT_TRUE(conduit::utils::is_directory(output_path + ".mesh_000000"));
+    EXPECT_FALSE(conduit::utils::is_directory(output_path + ".mesh_000001"));
+
+    // the second cycle reaches the mesh through links
+    string domain_file = conduit::utils::join_file_path(output_path + ".cycle_000001",
+                                                        "domain_000000.hdf5");
+    Node n_load;
+    conduit::relay::io::load(domain_file,"hdf5",n_load);
+    EXPECT_TRUE(n_load.has_path("fields/braid/values"));
+    EXPECT_TRUE(n_load.has_path("coordsets/coords"));
+    EXPECT_TRUE(n_load.has_path("topologies/mesh"));
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_pipeline_compression)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",100,100,0,data);
+    data["state/domain_id"] = (uint64) 0;
+    data["state/cycle"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_compression");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    // lossy with an absolute bound, lossy with a relative bound
+    // on a vector field, and lossless
+    save["compression/braid/codec"]     = "quantize";
+    save["compression/braid/tolerance"] = 1e-3;
+    save["compression/vel/codec"]       = "quantize";
+    save["compression/vel/tolerance"]   = 1e-4;
+    save["compression/vel/mode"]        = "relative";
+    save["compression/radial/codec"]    = "deflate";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    string domain_file = conduit::utils::join_file_path(output_path + ".cycle_000000",
+                                                        "domain_000000.hdf5");
+    Node n_load;
+    conduit::relay::io::load(domain_file,"hdf5",n_load);
+    
+    EXPECT_TRUE(n_load.has_path("fields/braid/compression/ratio"));
+    EXPECT_TRUE(n_load.has_path("fields/vel/compression/u/ratio"));
+    EXPECT_TRUE(n_load.has_path("fields/radial/compression/ratio"));
+    EXPECT_GT(n_load["fields/braid/compression/ratio"].to_float64(), 1.0);
+    EXPECT_FALSE(n_load.has_path("fields/braid/values"));
+    // scalar fields have no empty component in their paths
+    EXPECT_TRUE(n_load.has_path("fields/braid/compression/codes"));
+    EXPECT_TRUE(n_load.has_path("fields/vel/compression/u/codes"));
+    EXPECT_TRUE(n_load.has_path("fields/radial/values"));
+    EXPECT_FALSE(n_load["fields/braid/compression"].has_child(""));
+    EXPECT_FALSE(n_load["fields/radial/values"].dtype().is_object());
+
+    decompress_fields(n_load);
+    EXPECT_FALSE(n_load.has_path("fields/braid/compression"));
+
+    // lossy values are within the tolerance
+    Node n_orig, n_dec;
+    data["fields/braid/values"].to_float64_array(n_orig);
+    n_load["fields/braid/values"].to_float64_array(n_dec);
+    float64 *orig_vals = n_orig.value();
+    float64 *dec_vals  = n_dec.value();
+    index_t num_vals   = n_orig.dtype().number_of_elements();
+    ASSERT_EQ(n_dec.dtype().number_of_elements(), num_vals);
+    
+    float64 max_err = 0.0;
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        max_err = std::max(max_err, fabs(orig_vals[i] - dec_vals[i]));
+    }
+    EXPECT_LE(max_err, 1e-3);
+
+    // lossless values are unchanged
+    data["fields/radial/values"].to_float64_array(n_orig);
+    n_load["fields/radial/values"].to_float64_array(n_dec);
+    orig_vals = n_orig.value();
+    dec_vals  = n_dec.value();
+    num_vals  = n_orig.dtype().number_of_elements();
+    ASSERT_EQ(n_dec.dtype().number_of_elements(), num_vals);
+
+    for(index_t i = 0; i < num_vals; i++)
+    {
+        EXPECT_EQ(orig_vals[i], dec_vals[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d_hdf5, test_3d_serial_hdf5_pipeline_chunking)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("uniform",20,20,20,data);
+    data["state/domain_id"] = (uint64) 0;
+    data["state/cycle"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_chunking");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["chunking/size"] = 8;
+    save["compression/braid/codec"] = "deflate";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    Node n_root;
+    conduit::relay::io::load(output_path + ".cycle_000000.root","hdf5",n_root);
+
+    // 20 points per axis in chunks of 8 gives 3 chunks per axis
+    const Node &braid_idx = n_root["chunk_index/domain_000000/braid"];
+    EXPECT_EQ(braid_idx["min"].dtype().number_of_elements(), 27);
+    EXPECT_EQ(braid_idx["max"].dtype().number_of_elements(), 27);
+
+    Node n_min, n_max;
+    braid_idx["min"].to_float64_array(n_min);
+    braid_idx["max"].to_float64_array(n_max);
+    float64 *min_vals = n_min.value();
+    float64 *max_vals = n_max.value();
+    for(int i = 0; i < 27; i++)
+    {
+        EXPECT_LE(min_vals[i], max_vals[i]);
+    }
+
+    // element fields have one less value per axis
+    EXPECT_TRUE(n_root.has_path("chunk_index/domain_000000/radial/min"));
+
+    // chunked values read back unchanged
+    string domain_file = conduit::utils::join_file_path(output_path + ".cycle_000000",
+                                                        "domain_000000.hdf5");
+    Node n_load;
+    conduit::relay::io::load(domain_file,"hdf5",n_load);
+    decompress_fields(n_load);
+    
+    Node n_orig, n_read;
+    data["fields/braid/values"].to_float64_array(n_orig);
+    n_load["fields/braid/values"].to_float64_array(n_read);
+    ASSERT_EQ(n_orig.dtype().number_of_elements(),
+              n_read.dtype().number_of_elements());
+    float64 *orig_vals = n_orig.value();
+    float64 *read_vals = n_read.value();
+    for(index_t i = 0; i < n_orig.dtype().number_of_elements(); i++)
+    {
+        EXPECT_EQ(orig_vals[i], read_vals[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_3d_hdf5, test_3d_serial_hdf5_pipeline_extract)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("uniform",20,20,20,data);
+    data["state/domain_id"] = (uint64) 0;
+    data["state/cycle"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_extract");
+
+    float64 origin[3] = {0.0, 0.0, 0.0};
+    float64 normal[3] = {0.0, 0.0, 1.0};
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]      = "save_extract";
+    save["output_path"] = output_path;
+
+    Node &slice = save["filters"].append();
+    slice["type"] = "slice_filter";
+    slice["origin"].set(origin,3);
+    slice["normal"].set(normal,3);
+
+    Node &thresh = save["filters"].append();
+    thresh["type"]       = "threshold_filter";
+    thresh["field_name"] = "braid";
+    thresh["min_value"]  = 0.0;
+    thresh["max_value"]  = 100.0;
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    Node n_root;
+    conduit::relay::io::load(output_path + ".cycle_000000.root","hdf5",n_root);
+    EXPECT_EQ(n_root["blueprint_index/mesh/topologies/mesh/elements/shape"].as_string(),
+              "tri");
+
+    string domain_file = conduit::utils::join_file_path(output_path + ".cycle_000000",
+                                                        "domain_000000.hdf5");
+    Node n_load, verify_info;
+    conduit::relay::io::load(domain_file,"hdf5",n_load);
+    EXPECT_TRUE(conduit::blueprint::mesh::verify(n_load,verify_info));
+
+    // the slice only keeps points on the plane, with non negative braid
+    index_t num_points = n_load["coordsets/coords/values/x"].dtype().number_of_elements();
+    index_t num_tris   = n_load["topologies/mesh/elements/connectivity"].dtype().number_of_elements() / 3;
+    EXPECT_GT(num_tris, 0);
+    EXPECT_LT(num_points, 20 * 20 * 20);
+    EXPECT_EQ(n_load["fields/braid/values"].dtype().number_of_elements(), num_points);
+    EXPECT_EQ(n_load["fields/radial/values"].dtype().number_of_elements(), num_tris);
+
+    Node n_z, n_braid;
+    n_load["coordsets/coords/values/z"].to_float64_array(n_z);
+    n_load["fields/braid/values"].to_float64_array(n_braid);
+    float64 *z_vals = n_z.value();
+    float64 *braid_vals = n_braid.value();
+    for(index_t i = 0; i < num_points; i++)
+    {
+        EXPECT_NEAR(z_vals[i], 0.0, 1e-10);
+        EXPECT_GE(braid_vals[i], 0.0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_pipeline_staging)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",100,100,0,data);
+    data["state/domain_id"] = (uint64) 0;
+    data["state/cycle"] = (uint64) 0;
+
+    string output_path = prepare_output_dir();
+    string staging_path = conduit::utils::join_file_path(output_path,
+                                                         "test_staging");
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_save_hdf5_staged");
+
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+
+    // stage in a second local directory
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+    open_opts["staging/path"] = staging_path;
+    open_opts["staging/max_concurrent"] = 1;
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    // close waits for the staged files to be moved
+    sman.Close();
+
+    EXPECT_TRUE(conduit::utils::is_directory(staging_path));
+
+    string domain_file = conduit::utils::join_file_path(output_path + ".cycle_000000",
+                                                        "domain_000000.hdf5");
+    EXPECT_TRUE(conduit::utils::is_file(domain_file));
+    
+    Node n_load;
+    conduit::relay::io::load(domain_file,"hdf5",n_load);
+    EXPECT_TRUE(n_load.has_path("fields/braid/values"));
+}
+
+//-----------------------------------------------------------------------------
+TEST(strawman_test_2d_hdf5, test_2d_serial_hdf5_read)
+{
+    //
+    // Create example mesh.
+    //
+    Node data;
+    conduit::blueprint::mesh::examples::braid("quads",50,50,0,data);
+    data["state/domain_id"] = (uint64) 0;
+    data["state/cycle"] = (uint64) 3;
+
+    string output_path = prepare_output_dir();
+    output_path = conduit::utils::join_file_path(output_path,
+                                                 "test_read_hdf5");
+
+    // use lossless compression, which the reader undoes
+    Node actions;
+    Node &save = actions.append();
+    save["action"]   = "save";
+    save["output_path"] = output_path;
+    save["compression/braid/codec"] = "deflate";
+
+    Node open_opts;
+    open_opts["pipeline/type"] = "blueprint_hdf5";
+
+    Strawman sman;
+    sman.Open(open_opts);
+    sman.Publish(data);
+    sman.Execute(actions);
+    sman.Close();
+
+    BlueprintReader reader;
+    reader.Open(output_path + ".cycle_000003.root");
+
+    EXPECT_EQ(reader.NumDomains(), 1);
+    EXPECT_EQ(reader.NumRounds(), 1);
+
+    Node domain;
+    reader.ReadDomain(0,domain);
+
+    Node braid_vals, read_vals;
+    data["fields/braid/values"].to_float64_array(braid_vals);
+    domain["fields/braid/values"].to_float64_array(read_vals);
+
+    float64_array braid_arr = braid_vals.value();
+    float64_array read_arr  = read_vals.value();
+
+    EXPECT_EQ(braid_arr.number_of_elements(), read_arr.number_of_elements());
+    for(index_t i = 0; i < braid_arr.number_of_elements(); i++)
+    {
+        EXPECT_EQ(braid_arr[i], read_arr[i]);
+    }
+
+    // replay into a second file set
+    string replay_path = output_path + "_replay";
+    actions[0]["output_path"] = replay_path;
+
+    reader.Replay(open_opts,actions);
+
+    EXPECT_TRUE(conduit::utils::is_file(replay_path + ".cycle_000003.root"));
+}
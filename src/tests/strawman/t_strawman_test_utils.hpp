@@ -55,6 +55,8 @@
 
 #include <iostream>
 #include <math.h>
+#include <stdlib.h>
+#include <lodepng.h>
 
 using namespace std;
 using namespace conduit;
@@ -114,6 +116,55 @@ check_test_image(const std::string &path)
     return conduit::utils::is_file(path + ".png");
 }
 
+//-----------------------------------------------------------------------------
+// fraction of pixels that differ by more than channel_tolerance in any
+// channel, 1.0 when either image can not be read or the sizes differ
+//-----------------------------------------------------------------------------
+float64
+diff_test_images(const std::string &path_a,
+                 const std::string &path_b,
+                 int channel_tolerance)
+{
+    unsigned char *image_a = NULL;
+    unsigned char *image_b = NULL;
+    unsigned width_a = 0, height_a = 0;
+    unsigned width_b = 0, height_b = 0;
+
+    unsigned error_a = lodepng_decode32_file(&image_a,
+                                             &width_a,
+                                             &height_a,
+                                             (path_a + ".png").c_str());
+    unsigned error_b = lodepng_decode32_file(&image_b,
+                                             &width_b,
+                                             &height_b,
+                                             (path_b + ".png").c_str());
+
+    float64 diff = 1.0;
+    if(error_a == 0 && error_b == 0 &&
+       width_a == width_b && height_a == height_b &&
+       width_a * height_a > 0)
+    {
+        size_t num_pixels = (size_t)width_a * height_a;
+        size_t num_diff   = 0;
+        for(size_t p = 0; p < num_pixels; p++)
+        {
+            for(int c = 0; c < 4; c++)
+            {
+                if(abs(image_a[4 * p + c] - image_b[4 * p + c]) > channel_tolerance)
+                {
+                    num_diff++;
+                    break;
+                }
+            }
+        }
+        diff = (float64)num_diff / (float64)num_pixels;
+    }
+
+    free(image_a);
+    free(image_b);
+    return diff;
+}
+
 
 //-----------------------------------------------------------------------------
 // create an example 2d rectilinear grid with two variables.
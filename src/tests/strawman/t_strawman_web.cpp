@@ -52,8 +52,10 @@
 #include "gtest/gtest.h"
 
 #include <strawman.hpp>
+#include <strawman_web_interface.hpp>
 
 #include <iostream>
+#include <sstream>
 #include <math.h>
 
 #include <conduit_blueprint.hpp>
@@ -113,6 +115,8 @@ TEST(strawman_web, test_strawman_web_launch)
     
     Node open_opts;
     open_opts["web/stream"] = "true";
+    // cap the frames sent to the browser, newer frames replace stale ones
+    open_opts["web/fps"]    = 10;
 
     Strawman sman;
     sman.Open(open_opts);
@@ -133,6 +137,38 @@ TEST(strawman_web, test_strawman_web_launch)
 }
 
 
+//-----------------------------------------------------------------------------
+TEST(strawman_web, test_strawman_web_mailbox)
+{
+    //
+    // Without a client nothing is sent, each push replaces the
+    // pending image and the replaced frames count as dropped
+    //
+    WebInterface web;
+    Node opts;
+    opts["web/fps"] = 10;
+    web.SetOptions(opts);
+
+    for(int i = 0; i < 5; i++)
+    {
+        std::ostringstream oss;
+        oss << "frame_" << i << ".png";
+        web.PushImage(oss.str());
+    }
+
+    Node info;
+    web.Info(info);
+    info.print();
+
+    EXPECT_EQ(info["frames_pushed"].to_uint64(), (uint64)5);
+    EXPECT_EQ(info["frames_dropped"].to_uint64(), (uint64)4);
+    EXPECT_EQ(info["frames_sent"].to_uint64(), (uint64)0);
+    EXPECT_EQ(info["frames_pending"].to_uint64(), (uint64)1);
+    EXPECT_EQ(info["pending_file"].as_string(), "frame_4.png");
+
+    web.Shutdown();
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
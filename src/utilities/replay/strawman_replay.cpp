@@ -0,0 +1,223 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+// Copyright (c) 2015-2017, Lawrence Livermore National Security, LLC.
+// 
+// Produced at the Lawrence Livermore National Laboratory
+// 
+// LLNL-CODE-716457
+// 
+// All rights reserved.
+// 
+// This file is part of Strawman. 
+// 
+// For details, see: http://software.llnl.gov/strawman/.
+// 
+// Please also read strawman/LICENSE
+// 
+// Redistribution and use in source and binary forms, with or without 
+// modification, are permitted provided that the following conditions are met:
+// 
+// * Redistributions of source code must retain the above copyright notice, 
+//   this list of conditions and the disclaimer below.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the disclaimer (as noted below) in the
+//   documentation and/or other materials provided with the distribution.
+// 
+// * Neither the name of the LLNS/LLNL nor the names of its contributors may
+//   be used to endorse or promote products derived from this software without
+//   specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL LAWRENCE LIVERMORE NATIONAL SECURITY,
+// LLC, THE U.S. DEPARTMENT OF ENERGY OR CONTRIBUTORS BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+// DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+// OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+// IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+// POSSIBILITY OF SUCH DAMAGE.
+// 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~//
+
+//-----------------------------------------------------------------------------
+///
+/// file: strawman_replay.cpp
+///
+/// Replays capture logs recorded with the capture/path open option 
+/// against any pipeline, as fast as possible.
+///
+/// usage: strawman_replay <capture_path> [options.json]
+///
+/// Each rank replays the log it recorded (<capture_path>.<rank>.capture). 
+/// Open options from the optional json file override the recorded ones,
+/// (e.g. to select a different pipeline or backend).
+///
+//-----------------------------------------------------------------------------
+
+#include <strawman.hpp>
+#include <strawman_capture.hpp>
+
+#include <iostream>
+#include <sys/time.h>
+
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
+using namespace conduit;
+using namespace strawman;
+
+//-----------------------------------------------------------------------------
+float64
+elapsed_seconds(const timeval &start)
+{
+    timeval now;
+    gettimeofday(&now, NULL);
+    return (float64)(now.tv_sec  - start.tv_sec) +
+           (float64)(now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
+//-----------------------------------------------------------------------------
+int
+replay(const std::string &capture_path,
+       const std::string &options_file,
+       int rank,
+       int size)
+{
+    Node override_opts;
+    if(!options_file.empty())
+    {
+        override_opts.load(options_file,"json");
+    }
+
+    CaptureReader log;
+    log.Open(capture_file_name(capture_path, rank));
+
+    Strawman sman;
+    bool     is_open = false;
+    
+    // data for publish records that reuse the last stored data
+    Node     data;
+    Node     record;
+    int      record_type = 0;
+    float64  timestamp   = 0.0;
+    
+    int      num_publish = 0;
+    int      num_execute = 0;
+    float64  times[3]    = {0.0, 0.0, 0.0}; // publish, execute, total
+
+    timeval total_start;
+    gettimeofday(&total_start, NULL);
+
+    while(log.Next(record_type, timestamp, record))
+    {
+        timeval start;
+        gettimeofday(&start, NULL);
+
+        if(record_type == CAPTURE_OPEN)
+        {
+            Node opts(record);
+            opts.update(override_opts);
+            // don't capture the replay
+            if(opts.has_child("capture"))
+            {
+                opts.remove("capture");
+            }
+#ifdef PARALLEL
+            opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+            sman.Open(opts);
+            is_open = true;
+        }
+        else if(record_type == CAPTURE_PUBLISH || 
+                record_type == CAPTURE_PUBLISH_REPEAT)
+        {
+            if(record_type == CAPTURE_PUBLISH)
+            {
+                data.set(record);
+            }
+            sman.Publish(data);
+            num_publish++;
+            times[0] += elapsed_seconds(start);
+        }
+        else if(record_type == CAPTURE_EXECUTE)
+        {
+            sman.Execute(record);
+            num_execute++;
+            times[1] += elapsed_seconds(start);
+        }
+        else if(record_type == CAPTURE_CLOSE)
+        {
+            sman.Close();
+            is_open = false;
+        }
+    }
+
+    if(is_open)
+    {
+        sman.Close();
+    }
+
+    times[2] = elapsed_seconds(total_start);
+
+#ifdef PARALLEL
+    float64 max_times[3];
+    MPI_Reduce(times, max_times, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    for(int i = 0; i < 3; i++)
+    {
+        times[i] = max_times[i];
+    }
+#endif
+
+    if(rank == 0)
+    {
+        std::cout << "replayed " << capture_path << " on " << size
+                  << " rank(s)"                  << std::endl
+                  << "  publish calls: " << num_publish 
+                  << " (max "  << times[0] << " s)" << std::endl
+                  << "  execute calls: " << num_execute
+                  << " (max "  << times[1] << " s)" << std::endl
+                  << "  total: "         << times[2] << " s" << std::endl;
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+    int rank = 0;
+    int size = 1;
+#ifdef PARALLEL
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+    int res = 0;
+
+    if(argc < 2)
+    {
+        if(rank == 0)
+        {
+            std::cout << "usage: " << argv[0] 
+                      << " <capture_path> [options.json]" << std::endl;
+        }
+        res = -1;
+    }
+    else
+    {
+        std::string options_file = argc > 2 ? std::string(argv[2]) : "";
+        res = replay(std::string(argv[1]), options_file, rank, size);
+    }
+
+#ifdef PARALLEL
+    MPI_Finalize();
+#endif
+
+    return res;
+}